@@ -0,0 +1,654 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Banco de pruebas de rendimiento
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Recorre una matriz fija material x espesor x energía con las clases reales
+(DetectorConstruction, PhysicsList, ActionInitialization y el SD) y mide:
+tiempo de inicialización, eventos/s, pasos/evento, mu y RSS máximo, con
+calentamiento y varias repeticiones por punto. El resultado es JSON.
+
+Uso:
+  gammaAtt_bench [--out bench.json] [--events N] [--warmup N] [--trials N]
+                 [-t N] [--quick] [--workdir dir] [--verbose]
+                 [--physics lista[,lista...]|all] [--fastsim [--validate]]
+                 [--compare base.json [--threshold 0.10]]
+  gammaAtt_bench --compare base.json actual.json [--threshold 0.10]
+
+--physics elige la física EM (/phys/select; por defecto standard). Con varias
+listas cada una se mide en un proceso propio (la física no se puede cambiar
+tras Initialize) y se escribe en <out>_<lista>.json; al final se muestra una
+tabla con el tiempo de inicialización, los eventos/s y el mu de cada lista
+frente a la primera.
+
+--fastsim mide con el modelo rápido del absorbente. Con --validate cada punto
+se mide también con el transporte completo y se muestra la aceleración y la
+diferencia de la transmisión y de la fracción sin colisión en desviaciones
+típicas; el código de salida es 1 si alguna pasa de 4 sigma.
+
+Con --compare se marca como regresión cualquier punto cuyos eventos/s
+caigan más que el umbral, o cuyo tiempo de inicialización o RSS crezcan
+más que el umbral; el código de salida es 1 si hay regresiones.
+*/
+#include "G4RunManager.hh"
+#ifdef G4MULTITHREADED
+#include "G4TaskRunManager.hh"
+#endif
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "G4Version.hh"
+
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "ActionInitialization.hh"
+#include "RunAction.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+  struct BenchPoint
+  {
+    std::string material;
+    double thicknessCm = 0.;
+    double energyKeV = 0.;
+    double eventsPerSecond = 0.;
+    double eventsPerSecondStd = 0.;
+    double stepsPerEvent = 0.;
+    double transmission = 0.;
+    double mu = 0.; // cm^-1, -ln(T)/x con la transmisión media
+    double rssMB = 0.;
+  };
+
+  // Repeticiones de un punto en un modo de transporte
+  struct Measurement
+  {
+    double eventsPerSecond = 0.;
+    double eventsPerSecondStd = 0.;
+    double stepsPerEvent = 0.;
+    double transmission = 0.;
+    long long events = 0;
+    long long transmitted = 0;
+    long long uncollided = 0;
+  };
+
+  struct BenchResult
+  {
+    std::string geant4;
+    std::string physics;
+    int threads = 0;
+    double initSeconds = 0.;
+    double peakRssMB = 0.;
+    std::vector<BenchPoint> points;
+  };
+
+  double Now()
+  {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+  }
+
+  // RSS máximo del proceso (Linux: ru_maxrss en KB)
+  double PeakRssMB()
+  {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.;
+  }
+
+  // RSS actual a partir de /proc/self/statm
+  double CurrentRssMB()
+  {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident))
+      return 0.;
+    return resident * (sysconf(_SC_PAGESIZE) / (1024. * 1024.));
+  }
+
+  std::string PointKey(const BenchPoint &p)
+  {
+    std::ostringstream os;
+    os << p.material << "/" << p.thicknessCm << "cm/" << p.energyKeV << "keV";
+    return os.str();
+  }
+
+  // --- JSON: se escribe un punto por línea para poder leerlo sin dependencias ---
+  void WriteJson(const BenchResult &result, const std::string &path, int events, int warmup, int trials)
+  {
+    std::ofstream out(path);
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"schema\": \"gammaAtt-bench/1\",\n";
+    out << "  \"timestamp\": \"" << stamp << "\",\n";
+    out << "  \"geant4\": \"" << result.geant4 << "\",\n";
+    out << "  \"physics\": \"" << result.physics << "\",\n";
+    out << "  \"threads\": " << result.threads << ",\n";
+    out << "  \"events\": " << events << ",\n";
+    out << "  \"warmup\": " << warmup << ",\n";
+    out << "  \"trials\": " << trials << ",\n";
+    out << "  \"init_seconds\": " << result.initSeconds << ",\n";
+    out << "  \"peak_rss_mb\": " << result.peakRssMB << ",\n";
+    out << "  \"points\": [\n";
+    for (std::size_t i = 0; i < result.points.size(); ++i)
+    {
+      const BenchPoint &p = result.points[i];
+      out << "    {\"material\": \"" << p.material << "\", \"thickness_cm\": " << p.thicknessCm
+          << ", \"energy_keV\": " << p.energyKeV << ", \"events_per_second\": " << p.eventsPerSecond
+          << ", \"events_per_second_std\": " << p.eventsPerSecondStd
+          << ", \"steps_per_event\": " << p.stepsPerEvent << ", \"transmission\": " << p.transmission
+          << ", \"mu_cm1\": " << p.mu << ", \"rss_mb\": " << p.rssMB << "}" << (i + 1 < result.points.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+  }
+
+  bool FindValue(const std::string &text, const std::string &key, std::string &value)
+  {
+    std::string pattern = "\"" + key + "\":";
+    std::size_t pos = text.find(pattern);
+    if (pos == std::string::npos)
+      return false;
+    pos = text.find_first_not_of(' ', pos + pattern.size());
+    if (text[pos] == '"')
+    {
+      std::size_t end = text.find('"', pos + 1);
+      value = text.substr(pos + 1, end - pos - 1);
+    }
+    else
+    {
+      std::size_t end = text.find_first_of(",}\n", pos);
+      value = text.substr(pos, end - pos);
+    }
+    return true;
+  }
+
+  double FindNumber(const std::string &text, const std::string &key)
+  {
+    std::string value;
+    return FindValue(text, key, value) ? std::atof(value.c_str()) : 0.;
+  }
+
+  bool ReadJson(const std::string &path, BenchResult &result)
+  {
+    std::ifstream in(path);
+    if (!in)
+    {
+      std::cerr << "ERROR: no se puede leer " << path << std::endl;
+      return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+      if (line.find("\"material\"") != std::string::npos)
+      {
+        BenchPoint p;
+        FindValue(line, "material", p.material);
+        p.thicknessCm = FindNumber(line, "thickness_cm");
+        p.energyKeV = FindNumber(line, "energy_keV");
+        p.eventsPerSecond = FindNumber(line, "events_per_second");
+        p.eventsPerSecondStd = FindNumber(line, "events_per_second_std");
+        p.stepsPerEvent = FindNumber(line, "steps_per_event");
+        p.transmission = FindNumber(line, "transmission");
+        p.mu = FindNumber(line, "mu_cm1");
+        p.rssMB = FindNumber(line, "rss_mb");
+        result.points.push_back(p);
+      }
+      else if (line.find("\"init_seconds\"") != std::string::npos)
+        result.initSeconds = FindNumber(line, "init_seconds");
+      else if (line.find("\"peak_rss_mb\"") != std::string::npos)
+        result.peakRssMB = FindNumber(line, "peak_rss_mb");
+      else if (line.find("\"geant4\"") != std::string::npos)
+        FindValue(line, "geant4", result.geant4);
+      else if (line.find("\"physics\"") != std::string::npos)
+        FindValue(line, "physics", result.physics);
+      else if (line.find("\"threads\"") != std::string::npos)
+        result.threads = static_cast<int>(FindNumber(line, "threads"));
+    }
+    return true;
+  }
+
+  // Devuelve el número de regresiones encontradas
+  int Compare(const BenchResult &base, const BenchResult &current, double threshold)
+  {
+    int regressions = 0;
+    std::cout << "=== Comparación (umbral " << threshold * 100. << " %) ===" << std::endl;
+    if (base.geant4 != current.geant4)
+      std::cout << "Geant4: " << base.geant4 << " -> " << current.geant4 << std::endl;
+    if (base.threads != current.threads)
+      std::cout << "AVISO: distinto número de hilos (" << base.threads << " -> " << current.threads << ")" << std::endl;
+    if (base.physics != current.physics)
+      std::cout << "AVISO: distinta física (" << base.physics << " -> " << current.physics << ")" << std::endl;
+
+    auto check = [&](const std::string &what, double before, double after, bool higherIsBetter)
+    {
+      if (before <= 0.)
+        return;
+      double change = (after - before) / before;
+      bool worse = higherIsBetter ? (change < -threshold) : (change > threshold);
+      if (worse)
+        ++regressions;
+      std::printf("%-40s %12.4g -> %12.4g  %+7.1f %%%s\n", what.c_str(), before, after, change * 100.,
+                  worse ? "  REGRESIÓN" : "");
+    };
+
+    check("init_seconds", base.initSeconds, current.initSeconds, false);
+    check("peak_rss_mb", base.peakRssMB, current.peakRssMB, false);
+
+    std::map<std::string, const BenchPoint *> basePoints;
+    for (const auto &p : base.points)
+      basePoints[PointKey(p)] = &p;
+
+    for (const auto &p : current.points)
+    {
+      auto it = basePoints.find(PointKey(p));
+      if (it == basePoints.end())
+      {
+        std::cout << PointKey(p) << ": sin referencia" << std::endl;
+        continue;
+      }
+      check(PointKey(p) + " ev/s", it->second->eventsPerSecond, p.eventsPerSecond, true);
+
+      // Un cambio en pasos/evento no es de rendimiento sino de física o geometría
+      double before = it->second->stepsPerEvent;
+      if (before > 0. && std::abs(p.stepsPerEvent - before) / before > threshold)
+        std::printf("%-40s pasos/evento %.3g -> %.3g (cambio de comportamiento)\n", PointKey(p).c_str(),
+                    before, p.stepsPerEvent);
+    }
+
+    std::cout << (regressions ? "Regresiones: " + std::to_string(regressions) : std::string("Sin regresiones"))
+              << std::endl;
+    return regressions;
+  }
+
+  // Tabla de varias listas de física; la primera es la referencia de mu
+  void PrintPhysicsTable(const std::vector<BenchResult> &results)
+  {
+    std::cout << "=== Listas de física ===" << std::endl;
+    std::printf("%-10s %12s %12s\n", "lista", "init (s)", "RSS (MB)");
+    for (const auto &r : results)
+      std::printf("%-10s %12.3f %12.1f\n", r.physics.c_str(), r.initSeconds, r.peakRssMB);
+
+    const BenchResult &reference = results.front();
+    for (std::size_t i = 0; i < reference.points.size(); ++i)
+    {
+      std::string key = PointKey(reference.points[i]);
+      std::cout << key << std::endl;
+      for (const auto &r : results)
+      {
+        auto it = std::find_if(r.points.begin(), r.points.end(),
+                               [&](const BenchPoint &p) { return PointKey(p) == key; });
+        if (it == r.points.end())
+          continue;
+        double refMu = reference.points[i].mu;
+        std::printf("  %-10s %10.0f ev/s  %6.2f pasos/ev  mu=%.5g cm^-1", r.physics.c_str(), it->eventsPerSecond,
+                    it->stepsPerEvent, it->mu);
+        if (&r != &reference && refMu > 0.)
+          std::printf(" (%+.2f %%)", (it->mu - refMu) / refMu * 100.);
+        std::printf("\n");
+      }
+    }
+  }
+
+  // Diferencia entre dos proporciones independientes en desviaciones típicas
+  double ZScore(long long k1, long long n1, long long k2, long long n2)
+  {
+    if (n1 <= 0 || n2 <= 0)
+      return 0.;
+    double p1 = static_cast<double>(k1) / n1;
+    double p2 = static_cast<double>(k2) / n2;
+    double var = p1 * (1. - p1) / n1 + p2 * (1. - p2) / n2;
+    return var > 0. ? (p2 - p1) / std::sqrt(var) : 0.;
+  }
+
+  // Argumento entre comillas simples para std::system
+  std::string ShellQuote(const std::string &arg)
+  {
+    std::string quoted = "'";
+    for (char c : arg)
+      quoted += (c == '\'') ? std::string("'\\''") : std::string(1, c);
+    return quoted + "'";
+  }
+
+  std::string FormatDouble(double value)
+  {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string outFile = "bench.json";
+  std::string workDir = "bench_work";
+  std::vector<std::string> compareFiles;
+  std::vector<std::string> physicsLists;
+  std::vector<std::string> forwarded; // Opciones que se pasan a cada lista
+  int events = 20000, warmup = 2000, trials = 3, nThreads = 0;
+  double threshold = 0.10;
+  bool quick = false, verbose = false, fastSim = false, validate = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+    auto forward = [&]() -> std::string
+    {
+      forwarded.push_back(arg);
+      forwarded.push_back(next());
+      return forwarded.back();
+    };
+    if (arg == "--out")
+      outFile = next();
+    else if (arg == "--events")
+      events = std::atoi(forward().c_str());
+    else if (arg == "--warmup")
+      warmup = std::atoi(forward().c_str());
+    else if (arg == "--trials")
+      trials = std::max(1, std::atoi(forward().c_str()));
+    else if (arg == "-t" || arg == "--threads")
+      nThreads = std::atoi(forward().c_str());
+    else if (arg == "--threshold")
+      threshold = std::atof(next().c_str());
+    else if (arg == "--workdir")
+      workDir = forward();
+    else if (arg == "--quick")
+    {
+      quick = true;
+      forwarded.push_back(arg);
+    }
+    else if (arg == "--verbose")
+    {
+      verbose = true;
+      forwarded.push_back(arg);
+    }
+    else if (arg == "--fastsim" || arg == "--validate")
+    {
+      fastSim = true;
+      validate = validate || arg == "--validate";
+      forwarded.push_back(arg);
+    }
+    else if (arg == "--physics")
+    {
+      std::istringstream is(next());
+      std::string name;
+      while (std::getline(is, name, ','))
+      {
+        if (name == "all")
+          for (const auto &list : PhysicsList::GetEMNames())
+            physicsLists.push_back(list);
+        else if (!name.empty())
+          physicsLists.push_back(name);
+      }
+      for (const auto &list : physicsLists)
+      {
+        const auto &names = PhysicsList::GetEMNames();
+        if (std::find(names.begin(), names.end(), list) == names.end())
+        {
+          std::cerr << "Lista de física desconocida: " << list << std::endl;
+          return 2;
+        }
+      }
+    }
+    else if (arg == "--compare")
+    {
+      compareFiles.push_back(next());
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+        compareFiles.push_back(next());
+    }
+    else
+    {
+      std::cerr << "Opción desconocida: " << arg << std::endl;
+      return 2;
+    }
+  }
+
+  // Solo comparar dos ficheros existentes
+  if (compareFiles.size() == 2)
+  {
+    BenchResult base, current;
+    if (!ReadJson(compareFiles[0], base) || !ReadJson(compareFiles[1], current))
+      return 2;
+    return Compare(base, current, threshold) ? 1 : 0;
+  }
+
+  if (physicsLists.empty())
+    physicsLists.push_back("standard");
+
+  // Los ficheros de resultados de RunAction (../results/...) van a un
+  // directorio de trabajo propio y no se mezclan con los datos reales
+  std::string outPath = std::filesystem::absolute(outFile).string();
+
+  // Varias listas: un proceso hijo por lista y la tabla comparativa al final
+  if (physicsLists.size() > 1)
+  {
+    if (!compareFiles.empty())
+    {
+      std::cerr << "--compare admite una sola lista de física" << std::endl;
+      return 2;
+    }
+    std::filesystem::path stem = std::filesystem::path(outPath).replace_extension();
+    std::string self = std::filesystem::read_symlink("/proc/self/exe").string();
+    std::vector<BenchResult> results;
+    for (const auto &list : physicsLists)
+    {
+      std::string listOut = stem.string() + "_" + list + ".json";
+      std::string command = ShellQuote(self) + " --physics " + list + " --out " + ShellQuote(listOut);
+      for (const auto &arg : forwarded)
+        command += " " + ShellQuote(arg);
+      std::cerr << "=== " << list << " ===" << std::endl;
+      BenchResult result;
+      if (std::system(command.c_str()) != 0 || !ReadJson(listOut, result))
+      {
+        std::cerr << "ERROR: falló el banco con la lista " << list << std::endl;
+        return 2;
+      }
+      result.physics = list;
+      results.push_back(result);
+    }
+    PrintPhysicsTable(results);
+    return 0;
+  }
+  std::string basePath = compareFiles.empty() ? "" : std::filesystem::absolute(compareFiles[0]).string();
+  std::filesystem::create_directories(std::filesystem::path(workDir) / "results");
+  std::filesystem::create_directories(std::filesystem::path(workDir) / "run");
+  std::filesystem::current_path(std::filesystem::path(workDir) / "run");
+
+  std::vector<std::string> materials = {"water", "muscle", "bone", "lead", "concrete"};
+  std::vector<double> thicknesses = {1.0, 5.0, 10.0}; // cm
+  std::vector<double> energies = {59.5, 662.0, 1332.5}; // keV
+  if (quick)
+  {
+    thicknesses = {5.0};
+    energies = {662.0};
+  }
+
+  // La salida de las acciones de usuario no interesa durante las medidas
+  std::ofstream devNull("/dev/null");
+  std::streambuf *coutBuffer = std::cout.rdbuf();
+  auto quiet = [&](bool on)
+  {
+    if (!verbose)
+      std::cout.rdbuf(on ? devNull.rdbuf() : coutBuffer);
+  };
+
+  BenchResult result;
+  result.geant4 = G4Version;
+  result.physics = physicsLists.front() + (fastSim ? "+fastsim" : "");
+  result.threads = nThreads;
+
+  // --- Inicialización: núcleo, geometría, física y tablas (sin caché) ---
+  double start = Now();
+  quiet(true);
+  G4RunManager *runManager = nullptr;
+#ifdef G4MULTITHREADED
+  if (nThreads > 0)
+  {
+    auto taskRunManager = new G4TaskRunManager();
+    taskRunManager->SetNumberOfThreads(nThreads);
+    runManager = taskRunManager;
+  }
+#endif
+  if (!runManager)
+    runManager = new G4RunManager();
+
+  auto detector = new DetectorConstruction();
+  detector->SetFastSimulation(fastSim);
+  runManager->SetUserInitialization(detector);
+  auto physics = new PhysicsList();
+  if (fastSim)
+    physics->EnableFastSimulation();
+  runManager->SetUserInitialization(physics);
+  runManager->SetUserInitialization(new ActionInitialization(detector));
+
+  auto UImanager = G4UImanager::GetUIpointer();
+  UImanager->ApplyCommand("/control/verbose 0");
+  UImanager->ApplyCommand("/run/verbose 0");
+  UImanager->ApplyCommand("/event/verbose 0");
+  UImanager->ApplyCommand("/tracking/verbose 0");
+  UImanager->ApplyCommand("/phys/tableCache none");
+  UImanager->ApplyCommand("/phys/select " + physicsLists.front());
+  UImanager->ApplyCommand("/output/eventSink none");
+  runManager->Initialize();
+  runManager->BeamOn(0);
+  quiet(false);
+  result.initSeconds = Now() - start;
+
+  std::cerr << "Inicialización (" << result.physics << "): " << result.initSeconds << " s" << std::endl;
+
+  auto masterRunAction = static_cast<const RunAction *>(runManager->GetUserRunAction());
+
+  // Calentamiento y repeticiones de un punto con el modo de transporte vigente
+  auto measure = [&]()
+  {
+    Measurement m;
+    quiet(true);
+    // Calentamiento: tablas del material nuevo, cachés y predicción de saltos
+    if (warmup > 0)
+      runManager->BeamOn(warmup);
+
+    std::vector<double> rates;
+    for (int trial = 0; trial < trials; ++trial)
+    {
+      double t0 = Now();
+      runManager->BeamOn(events);
+      double elapsed = Now() - t0;
+      const RunSummary &summary = masterRunAction->GetLastRun();
+      rates.push_back(summary.events / elapsed);
+      m.stepsPerEvent += summary.events > 0 ? summary.steps / summary.events : 0.;
+      m.transmission += summary.transmissionRatio;
+      m.events += summary.events;
+      m.transmitted += summary.transmitted;
+      m.uncollided += summary.uncollided;
+    }
+    quiet(false);
+
+    double mean = 0.;
+    for (double r : rates)
+      mean += r;
+    mean /= rates.size();
+    double var = 0.;
+    for (double r : rates)
+      var += (r - mean) * (r - mean);
+    m.eventsPerSecond = mean;
+    m.eventsPerSecondStd = rates.size() > 1 ? std::sqrt(var / (rates.size() - 1)) : 0.;
+    m.stepsPerEvent /= trials;
+    m.transmission /= trials;
+    return m;
+  };
+  int disagreements = 0;
+
+  for (const auto &material : materials)
+  {
+    UImanager->ApplyCommand("/detector/setMaterial " + material);
+    for (double thickness : thicknesses)
+    {
+      UImanager->ApplyCommand("/detector/setThickness " + FormatDouble(thickness) + " cm");
+      for (double energy : energies)
+      {
+        UImanager->ApplyCommand("/gun/energy " + FormatDouble(energy) + " keV");
+
+        BenchPoint point;
+        point.material = material;
+        point.thicknessCm = thickness;
+        point.energyKeV = energy;
+
+        // Validación: el mismo punto con transporte completo como referencia
+        Measurement full;
+        if (validate)
+        {
+          UImanager->ApplyCommand("/fastsim/enable false");
+          full = measure();
+          UImanager->ApplyCommand("/fastsim/enable true");
+        }
+
+        Measurement m = measure();
+        point.eventsPerSecond = m.eventsPerSecond;
+        point.eventsPerSecondStd = m.eventsPerSecondStd;
+        point.stepsPerEvent = m.stepsPerEvent;
+        point.transmission = m.transmission;
+        point.mu = (point.transmission > 0.) ? -std::log(point.transmission) / thickness : 0.;
+        point.rssMB = CurrentRssMB();
+        result.points.push_back(point);
+
+        std::fprintf(stderr, "%-10s %5.1f cm %7.1f keV: %10.0f ev/s (±%.0f)  %6.2f pasos/ev  T=%.4f  mu=%.5g\n",
+                     material.c_str(), thickness, energy, point.eventsPerSecond, point.eventsPerSecondStd,
+                     point.stepsPerEvent, point.transmission, point.mu);
+        if (validate)
+        {
+          double zT = ZScore(full.transmitted, full.events, m.transmitted, m.events);
+          double zU = ZScore(full.uncollided, full.events, m.uncollided, m.events);
+          bool agree = std::abs(zT) <= 4. && std::abs(zU) <= 4.;
+          if (!agree)
+            ++disagreements;
+          std::fprintf(stderr, "%10s completo %10.0f ev/s  T=%.4f  x%.1f  zT=%+.2f  zU=%+.2f%s\n", "",
+                       full.eventsPerSecond, full.transmission,
+                       full.eventsPerSecond > 0. ? m.eventsPerSecond / full.eventsPerSecond : 0., zT, zU,
+                       agree ? "" : "  DESACUERDO");
+        }
+      }
+    }
+  }
+
+  result.peakRssMB = PeakRssMB();
+  delete runManager;
+
+  WriteJson(result, outPath, events, warmup, trials);
+  std::cerr << "RSS máximo: " << result.peakRssMB << " MB" << std::endl;
+  std::cerr << "Resultados: " << outPath << std::endl;
+
+  if (validate)
+  {
+    std::cerr << (disagreements ? "Validación: " + std::to_string(disagreements) + " puntos en desacuerdo"
+                                : std::string("Validación: modelo rápido compatible con el transporte completo"))
+              << std::endl;
+  }
+
+  if (!basePath.empty())
+  {
+    BenchResult base;
+    if (!ReadJson(basePath, base))
+      return 2;
+    if (Compare(base, result, threshold))
+      return 1;
+  }
+  return disagreements ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef ABSORBERBIASINGOPERATOR_HH
+#define ABSORBERBIASINGOPERATOR_HH
+
+#include "G4VBiasingOperator.hh"
+#include <map>
+
+class DetectorConstruction;
+class G4BOptnChangeCrossSection;
+class G4ParticleDefinition;
+
+/* Transformada exponencial para fotones en el absorbente (biasing
+   genérico de Geant4). La sección eficaz total se sustituye por
+   sigma' = sigma * (1 - p * cos(theta)), con theta el ángulo respecto a +z:
+   los fotones que avanzan hacia el detector ven un material más delgado y
+   los que retroceden uno más denso. El framework corrige el peso de cada
+   paso, de modo que la transmisión ponderada es insesgada.
+   Un operador por hilo (se crea en ConstructSDandField). */
+class AbsorberBiasingOperator : public G4VBiasingOperator
+{
+public:
+  AbsorberBiasingOperator(const DetectorConstruction *detector);
+  virtual ~AbsorberBiasingOperator();
+
+  void StartRun() override;
+
+private:
+  G4VBiasingOperation *ProposeOccurenceBiasingOperation(const G4Track *track,
+                                                        const G4BiasingProcessInterface *callingProcess) override;
+  G4VBiasingOperation *ProposeFinalStateBiasingOperation(const G4Track *,
+                                                         const G4BiasingProcessInterface *) override { return nullptr; }
+  G4VBiasingOperation *ProposeNonPhysicsBiasingOperation(const G4Track *,
+                                                         const G4BiasingProcessInterface *) override { return nullptr; }
+
+  using G4VBiasingOperator::OperationApplied;
+  void OperationApplied(const G4BiasingProcessInterface *callingProcess, G4BiasingAppliedCase biasingCase,
+                        G4VBiasingOperation *occurenceOperationApplied, G4double weightForOccurenceInteraction,
+                        G4VBiasingOperation *finalStateOperationApplied,
+                        const G4VParticleChange *particleChangeProduced) override;
+
+  const DetectorConstruction *detector; // Parámetro p compartido (/bias/expTransform)
+  const G4ParticleDefinition *gamma;
+  G4double stretch; // p del run actual
+  std::map<const G4BiasingProcessInterface *, G4BOptnChangeCrossSection *> operations;
+};
+
+#endif // ABSORBERBIASINGOPERATOR_HH
@@ -0,0 +1,94 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef ABSORBERFASTMODEL_HH
+#define ABSORBERFASTMODEL_HH
+
+#include "G4VFastSimulationModel.hh"
+#include "G4DynamicParticle.hh"
+#include "G4RayleighAngularGenerator.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <map>
+#include <vector>
+
+class DetectorConstruction;
+class G4Material;
+class G4Element;
+
+/* Modelo de simulación rápida del absorbente (arranque con --fastsim,
+   /fastsim/enable). Cuando un fotón entra en la región AbsorberRegion no se
+   transporta paso a paso: el modelo recorre el absorbente por su cuenta con
+   secciones eficaces tabuladas y devuelve directamente el estado de salida:
+   - absorbido (fotoeléctrico o pares; la energía se deposita donde ocurre);
+   - transmitido sin colisión, con la energía y la dirección de entrada;
+   - dispersado, con la energía y la dirección muestreadas (Compton de
+     Klein-Nishina y Rayleigh con los factores de forma de Livermore).
+   Los electrones no se siguen (depositan su energía donde se crean) y los
+   positrones se aniquilan en reposo; los fotones de aniquilación que salen
+   del absorbente se entregan como secundarios.
+   Las tablas se construyen una vez por material y por hilo a partir de las
+   secciones eficaces de los procesos de PhysicsList (G4EmCalculator), en
+   una malla logarítmica de 1 keV a 100 MeV con interpolación log-log.
+   Solo se aplica al absorbente homogéneo: con capas, maniquí, malla /score/
+   o transformada exponencial se usa el transporte completo. */
+class AbsorberFastModel : public G4VFastSimulationModel
+{
+public:
+  AbsorberFastModel(const G4String &name, G4Region *envelope, const DetectorConstruction *detector);
+  ~AbsorberFastModel() override = default;
+
+  G4bool IsApplicable(const G4ParticleDefinition &particle) override;
+  G4bool ModelTrigger(const G4FastTrack &fastTrack) override;
+  void DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep) override;
+
+private:
+  enum Channel
+  {
+    kPhotoelectric,
+    kCompton,
+    kRayleigh,
+    kConversion,
+    kNumberOfChannels
+  };
+
+  // Coeficientes de un material en la malla de energías (1/longitud interna)
+  struct MaterialTable
+  {
+    std::vector<G4double> mu[kNumberOfChannels];
+    std::vector<G4double> logMu[kNumberOfChannels]; // Solo válido si mu > 0
+    std::vector<const G4Element *> elements;
+    std::vector<std::vector<G4double>> rayleighElement; // Fracción acumulada por elemento en cada punto
+  };
+
+  // Fotón que se recorre dentro del absorbente (coordenadas locales)
+  struct Photon
+  {
+    G4ThreeVector position;
+    G4ThreeVector direction;
+    G4double energy;
+    G4double path;
+  };
+
+  const MaterialTable &GetTable(const G4Material *material);
+  void BuildTable(const G4Material *material, MaterialTable &table) const;
+  // Coeficientes interpolados a la energía dada; devuelve el total
+  G4double Coefficients(const MaterialTable &table, G4double energy, G4double mu[], std::size_t &bin) const;
+
+  // Recorre el fotón hasta que sale (true) o se absorbe (false)
+  G4bool Transport(const G4FastTrack &fastTrack, const MaterialTable &table, Photon &photon,
+                   std::vector<Photon> &pending, G4double &deposit);
+  G4double SampleCompton(G4double energy, G4ThreeVector &direction) const;
+  void SampleRayleigh(const MaterialTable &table, std::size_t bin, G4double energy, G4ThreeVector &direction);
+
+  const DetectorConstruction *detector; // /fastsim/enable y geometría compartidos
+  std::map<const G4Material *, MaterialTable> tables; // De este hilo
+  const G4Material *lastMaterial;
+  const MaterialTable *lastTable;
+  G4RayleighAngularGenerator rayleighGenerator;
+  G4DynamicParticle rayleighPhoton; // Entrada del generador angular
+};
+
+#endif // ABSORBERFASTMODEL_HH
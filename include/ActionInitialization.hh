@@ -0,0 +1,42 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef ACTIONINITIALIZATION_HH
+#define ACTIONINITIALIZATION_HH
+
+#include "G4VUserActionInitialization.hh"
+
+class DetectorConstruction;
+class SweepManager;
+class EventWriter;
+class PrecisionMonitor;
+class AnalyticEngine;
+class EnergyBinning;
+class MeshConfig;
+
+/* Crea las acciones de usuario. BuildForMaster() solo instancia el
+   RunAction del hilo maestro (que fusiona y escribe resultados); Build()
+   crea el juego completo de acciones para cada hilo de trabajo (o para el
+   único hilo en modo secuencial). */
+class ActionInitialization : public G4VUserActionInitialization
+{
+public:
+  ActionInitialization(DetectorConstruction *detector);
+  ~ActionInitialization() override;
+
+  void BuildForMaster() const override;
+  void Build() const override;
+
+private:
+  DetectorConstruction *detector;
+  SweepManager *sweepManager; // Barridos en proceso (solo lo usa el maestro)
+  EventWriter *eventWriter;   // Salida por evento compartida por todos los hilos
+  PrecisionMonitor *precisionMonitor; // Parada adaptativa, compartida por todos los hilos
+  AnalyticEngine *analyticEngine;     // mu/rho sin transporte (solo lo usa el maestro)
+  EnergyBinning *energyBinning;       // Bins del tally por energía, comunes a todos los hilos
+  MeshConfig *meshConfig;             // Malla de dosis/fluencia en el absorbente (/score/...)
+};
+
+#endif // ACTIONINITIALIZATION_HH
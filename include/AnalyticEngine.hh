@@ -0,0 +1,49 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef ANALYTICENGINE_HH
+#define ANALYTICENGINE_HH
+
+#include "globals.hh"
+#include <vector>
+
+class DetectorConstruction;
+class AnalyticMessenger;
+
+/* Coeficientes de atenuación de haz estrecho sin transporte. Para el
+   material configurado en el absorbente suma, energía a energía, la sección
+   eficaz macroscópica de cada proceso de los fotones registrado en
+   PhysicsList (G4EmCalculator) y escribe mu/rho en el mismo CSV que leen
+   los scripts de análisis multi-energía. Solo existe en el hilo maestro. */
+class AnalyticEngine
+{
+public:
+  AnalyticEngine(const DetectorConstruction *detector);
+  ~AnalyticEngine();
+
+  void SetEnergies(const std::vector<G4double> &list) { energies = list; }
+  void SetOutputFile(const G4String &path) { outputFile = path; }
+
+  // Calcula la malla completa y escribe el CSV
+  void Run();
+
+  // Procesos discretos de los fotones tal como los registró PhysicsList, con
+  // los nombres que entiende G4EmCalculator (también lo usa AbsorberFastModel)
+  static std::vector<G4String> PhotonProcesses();
+
+private:
+  // Malla y valores NIST de referencia del material (vacíos si no se conocen)
+  void ReferenceData(const G4String &material, std::vector<G4double> &grid,
+                     std::vector<G4double> &muRho) const;
+  G4String DefaultOutputFile(const G4String &material) const;
+
+  const DetectorConstruction *detector;
+  std::vector<G4double> energies; // Vacío: malla NIST del material
+  G4String outputFile;            // Vacío: el que leen los scripts de análisis
+
+  AnalyticMessenger *messenger;
+};
+
+#endif // ANALYTICENGINE_HH
@@ -0,0 +1,28 @@
+#ifndef ANALYTICMESSENGER_HH
+#define ANALYTICMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class AnalyticEngine;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class AnalyticMessenger : public G4UImessenger {
+public:
+    AnalyticMessenger(AnalyticEngine* engine);
+    virtual ~AnalyticMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    AnalyticEngine* analyticEngine;
+
+    G4UIdirectory* analyticDir;
+    G4UIcmdWithAString* energiesCmd;
+    G4UIcmdWithAString* outputCmd;
+    G4UIcmdWithoutParameter* runCmd;
+};
+
+#endif // ANALYTICMESSENGER_HH
@@ -0,0 +1,25 @@
+#ifndef BIASINGMESSENGER_HH
+#define BIASINGMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithADouble;
+
+class BiasingMessenger : public G4UImessenger {
+public:
+    BiasingMessenger(DetectorConstruction* detector);
+    virtual ~BiasingMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    DetectorConstruction* detectorConstruction;
+
+    G4UIdirectory* biasDir;
+    G4UIcmdWithADouble* expTransformCmd;
+};
+
+#endif // BIASINGMESSENGER_HH
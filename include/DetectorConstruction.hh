@@ -9,28 +9,141 @@ Fecha: Octubre 2025
 #include "G4VUserDetectorConstruction.hh"
 #include"G4RunManager.hh" 
 #include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Colour.hh"
+#include "G4SystemOfUnits.hh"
+#include <vector>
 
 class DetectorMessenger;
+class BiasingMessenger;
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4Box;
+class G4VisAttributes;
+class G4Material;
+class LayerParameterisation;
+class VoxelPhantom;
+class PhantomParameterisation;
+class PhantomMessenger;
+class FastSimMessenger;
+class G4Region;
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public: 
     DetectorConstruction();
     virtual ~DetectorConstruction();
     virtual G4VPhysicalVolume* Construct();
+    virtual void ConstructSDandField(); // SD por hilo (obligatorio en multihilo)
 
     // --- Métodos para cambiar parámetros ---
     void SetMaterialType(const G4String& material); // Cambiar material
     void SetThickness(G4double thickness); // Cambiar espesor
+    void SetStoreHits(G4bool value) { storeHits = value; } // Guardar MiHit (visualización)
+    void SetBiasing(G4bool value) { biasing = value; } // Operador de biasing en el absorbente (--bias)
+    void SetExpTransform(G4double p); // Parámetro de la transformada exponencial
+    void SetFastSimulation(G4bool value) { fastSimulation = value; } // Región y modelo rápido del absorbente (--fastsim)
+    void SetFastSimActive(G4bool value); // /fastsim/enable: modelo rápido o transporte completo
 
-    G4String GetMaterial() const { return materialType; } // Tipo de material
-    G4double GetThickness() const { return thickness; } // Espesor del material
+    // --- Absorbente por capas (se reconstruye la geometría en el siguiente run) ---
+    void AddLayer(const G4String& material, G4double thickness); // Pila heterogénea (G4PVParameterised)
+    void ClearLayers(); // Vuelve al absorbente homogéneo
+    void SetSlabs(G4int n); // Absorbente homogéneo dividido en n láminas iguales (G4PVReplica)
+
+    // --- Maniquí de vóxeles (sustituye al absorbente mientras está cargado) ---
+    G4bool LoadPhantom(const G4String& path, G4int nx, G4int ny, G4int nz, const G4ThreeVector& voxelSize,
+                       G4bool hounsfield, std::size_t headerBytes);
+    void ClearPhantom();
+    void AddPhantomHURange(G4int low, G4int high, const G4String& material);
+    void ResetPhantomHURanges();
+    void SetPhantomIndexMaterials(const std::vector<G4String>& names);
+    G4bool HasPhantom() const;
+
+    // Material, pila de materiales "muscle+bone+muscle" con capas o "phantom:<fichero>"
+    G4String GetMaterial() const;
+    G4double GetThickness() const { return thickness; } // Espesor del material (total con capas)
+    G4bool GetStoreHits() const { return storeHits; }
+    G4bool GetBiasing() const { return biasing; }
+    G4double GetExpTransform() const { return expTransform; }
+    G4bool GetFastSimulation() const { return fastSimulation; }
+    // El modelo rápido sustituye al transporte en este run (absorbente homogéneo y analógico)
+    G4bool UsesFastSimModel() const;
+
+    // Volúmenes lógicos para identificar en qué región está una partícula
+    G4LogicalVolume* GetAbsorberVolume() const { return logicAbsorber; }
+    G4LogicalVolume* GetLayerVolume() const { return logicLayer; } // Nulo sin capas
+    G4bool IsAbsorberVolume(const G4LogicalVolume* volume) const
+    {
+        return volume && (volume == logicAbsorber || volume == logicLayer || volume == logicVoxel);
+    }
+    G4LogicalVolume* GetDetectorVolume() const { return logicDetector; }
+    G4ThreeVector GetDetectorPosition() const { return DetectorPosition(); }
+    G4ThreeVector GetAbsorberHalfSize() const; // Caja del absorbente o del maniquí
+
+    // Capas de la geometría construida (0 = absorbente homogéneo de una pieza)
+    G4int GetNumberOfLayers() const;
+    G4bool IsHeterogeneous() const; // Capas de materiales distintos o maniquí: no hay un único mu/rho
+    std::vector<G4double> GetLayerBackFaces() const; // z de la cara de salida de cada capa
+    G4String GetLayerMaterial(G4int layer) const;
+    G4double GetDensityAt(G4double z) const; // Densidad del absorbente en la posición z
+    G4double GetMeanDensity() const; // Espesor másico total / espesor
+
+    // Semi-lado transversal del absorbente (el espesor es configurable)
+    static constexpr G4double absorberHalfXY = 10 * CLHEP::cm;
+
+    // Dimensiones fijas del plano detector (semi-lados)
+    static constexpr G4double detectorHalfXY = 15 * CLHEP::cm;
+    static constexpr G4double detectorHalfZ = 2 * CLHEP::mm;
     
 private:
-    G4Material* DefineMaterials(); // Definición de materiales
+    G4Material* DefineMaterials(const G4String& m); // Definición de materiales
+    void ConstructLayers(); // Capas dentro del absorbente, si las hay
+    void ConstructPhantom(); // Vóxeles del maniquí dentro del absorbente
+    void RebuildGeometry(); // Cambios de estructura: nueva llamada a Construct()
+    G4ThreeVector DetectorPosition() const; // Depende del espesor
+    G4Colour AbsorberColour() const; // Depende del material
 
     G4String materialType; // Tipo de material
     G4double thickness; // Espesor del material
+    G4bool storeHits; // Por defecto solo se puntúa, sin colección de hits
+    G4bool biasing; // G4GenericBiasingPhysics registrada para fotones
+    G4double expTransform; // 0 = analógico
+    G4bool fastSimulation; // G4FastSimulationPhysics registrada para fotones
+    G4bool fastSimActive;
+    G4Region* absorberRegion; // Envolvente del modelo rápido; sobrevive a las reconstrucciones
+
+    // Absorbente por capas: una pila de materiales o n láminas del mismo material
+    struct Layer
+    {
+        G4String material;
+        G4double thickness;
+    };
+    std::vector<Layer> layers;
+    G4String layerLabel; // Materiales de la pila, sin repetir los consecutivos
+    G4int slabs; // Láminas del absorbente homogéneo (<= 1: una pieza)
+
+    // Maniquí proyectado en memoria (/phantom/...)
+    VoxelPhantom* phantom;
+    G4bool usePhantom; // /phantom/clear lo desactiva sin cerrar el fichero
+    G4String phantomLabel;
+    PhantomMessenger* phantomMessenger;
     DetectorMessenger* messenger;
+    BiasingMessenger* biasingMessenger;
+    FastSimMessenger* fastSimMessenger;
+    G4LogicalVolume* logicDetector; // Volumen donde se registra el SD
+
+    // Objetos que se actualizan en sitio al cambiar material o espesor
+    G4VPhysicalVolume* physWorld;
+    G4Box* solidAbsorber;
+    G4LogicalVolume* logicAbsorber;
+    G4VPhysicalVolume* physDetector;
+    G4LogicalVolume* logicLayer; // Volumen lógico común a todas las capas
+    LayerParameterisation* layerParam;
+    std::vector<G4Material*> layerMaterials;
+    G4LogicalVolume* logicVoxel; // Vóxel del maniquí (G4RegularNavigation)
+    PhantomParameterisation* phantomParam;
+    std::vector<G4Material*> phantomMaterials;
+    G4VisAttributes* visAbsorber;
+    G4VisAttributes* visDetector;
 
 
 };
@@ -6,6 +6,9 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
 
 class DetectorMessenger : public G4UImessenger {
 public:
@@ -20,6 +23,10 @@ private:
     G4UIdirectory* detectorDir;
     G4UIcmdWithAString* materialCmd;
     G4UIcmdWithADoubleAndUnit* thicknessCmd;
+    G4UIcmdWithABool* storeHitsCmd;
+    G4UIcommand* addLayerCmd;
+    G4UIcmdWithoutParameter* clearLayersCmd;
+    G4UIcmdWithAnInteger* slabsCmd;
 };
 
 #endif // DETECTORMESSENGER_HH
\ No newline at end of file
@@ -0,0 +1,129 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef ENERGYTALLY_HH
+#define ENERGYTALLY_HH
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+class EnergyTallyMessenger;
+
+/* Configuración común del tally por energía (/tally/...). La crea
+   ActionInitialization en el hilo maestro; cada RunAction copia los
+   bordes al comenzar el run. Sin bordes, cada energía primaria distinta
+   tiene su propio bin (adecuado para fuentes de líneas). */
+class EnergyBinning
+{
+public:
+  EnergyBinning();
+  ~EnergyBinning();
+
+  void SetBins(G4int n, G4double emin, G4double emax, G4bool logScale);
+  void ClearBins() { edges.clear(); } // Un bin por línea
+  const std::vector<G4double> &GetEdges() const { return edges; }
+
+  void SetOutputFile(const G4String &path) { outputFile = path; }
+  const G4String &GetOutputFile() const { return outputFile; }
+
+  // Espectro de energía de los fotones que entran en el detector (0 bins: desactivado)
+  void SetSpectrumBins(G4int n, G4double emax) { spectrumBins = n; spectrumMax = emax; }
+  G4int GetSpectrumBins() const { return spectrumBins; }
+  G4double GetSpectrumMax() const { return spectrumMax; }
+  void SetSpectrumFile(const G4String &path) { spectrumFile = path; }
+  const G4String &GetSpectrumFile() const { return spectrumFile; }
+
+private:
+  std::vector<G4double> edges;
+  G4String outputFile;
+  G4int spectrumBins;
+  G4double spectrumMax;
+  G4String spectrumFile;
+  EnergyTallyMessenger *messenger;
+};
+
+/* Eventos totales y transmitidos (con su peso) por bin de energía
+   primaria. Se fusiona entre hilos como cualquier otro acumulable. */
+class EnergyTally : public G4VAccumulable
+{
+public:
+  struct Bin
+  {
+    G4double low = 0.;  // Igual a high en modo líneas
+    G4double high = 0.;
+    G4double events = 0.;
+    G4double sumW = 0.;  // Transmisión ponderada (= transmitidos sin biasing)
+    G4double sumW2 = 0.;
+  };
+
+  EnergyTally(const G4String &name, const EnergyBinning *binning);
+
+  // Copia la configuración compartida (inicio de run, antes de Reset)
+  void Configure();
+
+  void AddEvent(G4double energy);
+  void AddTransmitted(G4double energy, G4double weight);
+
+  void Merge(const G4VAccumulable &other) override;
+  void Reset() override;
+  void Print(G4PrintOptions options = G4PrintOptions()) const override;
+
+  // Bins no vacíos, ordenados por energía
+  std::vector<Bin> GetBins() const;
+
+private:
+  Bin *Find(G4double energy);
+
+  static constexpr std::size_t maxLines = 4096; // Espectro continuo sin /tally/energyBins
+
+  const EnergyBinning *binning;
+  std::vector<G4double> edges;
+  std::vector<Bin> bins;           // Con bordes
+  std::map<G4double, Bin> lines;   // Sin bordes: una entrada por energía
+  G4double dropped;                // Eventos fuera de rango o de maxLines
+};
+
+/* Espectro de energía de entrada en el detector, separado en fotones sin
+   colisión (primarios con la energía y la dirección de origen) y
+   dispersados. Bins lineales fijos durante el run: cada hilo llena su copia
+   sin cerrojos y se suman al final como el resto de acumulables. */
+class DetectorSpectrum : public G4VAccumulable
+{
+public:
+  DetectorSpectrum(const G4String &name, const EnergyBinning *binning);
+
+  // Copia la configuración compartida (inicio de run, antes de Reset)
+  void Configure();
+
+  G4bool IsActive() const { return !uncollided.empty(); }
+  void Fill(G4double energy, G4double weight, G4bool isUncollided)
+  {
+    if (uncollided.empty())
+      return;
+    // El último bin recoge las energías por encima del rango
+    std::size_t i = std::min(static_cast<std::size_t>(energy * inverseWidth), uncollided.size() - 1);
+    (isUncollided ? uncollided : scattered)[i] += weight;
+  }
+
+  void Merge(const G4VAccumulable &other) override;
+  void Reset() override;
+  void Print(G4PrintOptions options = G4PrintOptions()) const override;
+
+  G4int GetNumberOfBins() const { return static_cast<G4int>(uncollided.size()) - 1; }
+  G4double GetBinWidth() const { return inverseWidth > 0. ? 1. / inverseWidth : 0.; }
+  const std::vector<G4double> &GetUncollided() const { return uncollided; }
+  const std::vector<G4double> &GetScattered() const { return scattered; }
+
+private:
+  const EnergyBinning *binning;
+  G4double inverseWidth;
+  std::vector<G4double> uncollided; // n bins + desbordamiento
+  std::vector<G4double> scattered;
+};
+
+#endif // ENERGYTALLY_HH
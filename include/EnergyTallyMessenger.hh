@@ -0,0 +1,31 @@
+#ifndef ENERGYTALLYMESSENGER_HH
+#define ENERGYTALLYMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EnergyBinning;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class EnergyTallyMessenger : public G4UImessenger {
+public:
+    EnergyTallyMessenger(EnergyBinning* binning);
+    virtual ~EnergyTallyMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    EnergyBinning* binning;
+
+    G4UIdirectory* tallyDir;
+    G4UIcommand* energyBinsCmd;
+    G4UIcmdWithoutParameter* linesCmd;
+    G4UIcmdWithAString* outputCmd;
+    G4UIcommand* spectrumBinsCmd;
+    G4UIcmdWithAString* spectrumOutputCmd;
+};
+
+#endif // ENERGYTALLYMESSENGER_HH
@@ -4,7 +4,8 @@
 #include "G4UserEventAction.hh"
 #include "RunAction.hh"
 #include "globals.hh"
-#include <fstream>
+
+class MiSensitiveDetector;
 
 class EventAction : public G4UserEventAction {
 public:
@@ -16,7 +17,8 @@ public:
 
 private:
   RunAction* runAction;
-  std::ofstream outputFile;
+  MiSensitiveDetector* detectorSD; // Se busca una vez: el SD se crea después que las acciones
+  G4bool skipped; // Evento descartado porque ya se alcanzó la precisión pedida
 };
 
 #endif // EVENTACTION_HH
\ No newline at end of file
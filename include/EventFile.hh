@@ -0,0 +1,83 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef EVENTFILE_HH
+#define EVENTFILE_HH
+
+// Formato binario columnar de la salida por evento (.gaev). No depende de
+// Geant4 para que la herramienta gammaAtt-events pueda leerlo sin él.
+//
+//   Cabecera:  "GAEVT001" | uint32 nColumnas | por columna: uint8 tipo, uint8 len, nombre
+//   Bloques:   "BLK1" | uint32 nFilas | uint32 flags | uint32 bytes | payload
+//
+// El payload son las columnas una tras otra (nFilas * ancho de cada una),
+// comprimido con zlib si flags & kCompressed. Enteros little-endian nativos.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace EventFile
+{
+  enum ColumnType : std::uint8_t { kInt32 = 0, kUInt8 = 1, kFloat32 = 2 };
+  enum BlockFlags : std::uint32_t { kCompressed = 1u };
+
+  struct Column
+  {
+    std::string name;
+    ColumnType type;
+  };
+
+  std::size_t TypeWidth(ColumnType type);
+
+  // Columnas fijas de la salida por evento (energías en keV)
+  const std::vector<Column> &EventColumns();
+
+  // Un bloque de filas en formato columnar (SoA), con capacidad fija
+  struct Block
+  {
+    std::vector<std::int32_t> runID;
+    std::vector<std::int32_t> eventID;
+    std::vector<std::uint8_t> detected;
+    std::vector<float> edep;
+    std::vector<float> entryEnergy;
+    std::vector<float> primaryEnergy;
+
+    void Reserve(std::size_t n);
+    void Clear();
+    std::size_t Size() const { return eventID.size(); }
+
+    // Serializa las columnas en el orden de EventColumns()
+    void Pack(std::vector<char> &out) const;
+    bool Unpack(const char *data, std::size_t nRows);
+  };
+
+  bool WriteHeader(std::FILE *file);
+  bool WriteBlock(std::FILE *file, const Block &block, bool compress);
+
+  // Lector secuencial por bloques
+  class Reader
+  {
+  public:
+    explicit Reader(const std::string &path);
+    ~Reader();
+
+    bool IsOpen() const { return file != nullptr && headerOk; }
+    const std::vector<Column> &GetColumns() const { return columns; }
+    bool NextBlock(Block &block); // false al final o si el bloque está corrupto
+
+  private:
+    std::FILE *file;
+    bool headerOk;
+    std::vector<Column> columns;
+    std::vector<char> payload;
+    std::vector<char> unpacked;
+  };
+
+  bool CompressionAvailable();
+}
+
+#endif // EVENTFILE_HH
@@ -0,0 +1,28 @@
+#ifndef EVENTOUTPUTMESSENGER_HH
+#define EVENTOUTPUTMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EventWriter;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+
+class EventOutputMessenger : public G4UImessenger {
+public:
+    EventOutputMessenger(EventWriter* writer);
+    virtual ~EventOutputMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    EventWriter* eventWriter;
+
+    G4UIdirectory* outputDir;
+    G4UIcmdWithAString* sinkCmd;
+    G4UIcmdWithAString* fileCmd;
+    G4UIcmdWithABool* compressCmd;
+};
+
+#endif // EVENTOUTPUTMESSENGER_HH
@@ -0,0 +1,60 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef EVENTSEEDER_HH
+#define EVENTSEEDER_HH
+
+#include "globals.hh"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/* Semillas por evento, independientes del número de hilos y de procesos.
+   Al empezar cada evento el motor se resiembra con una función pura de
+   (semilla maestra, run, evento): el resultado de un evento no depende de
+   qué hilo lo simule ni de qué eventos simuló antes ese hilo. Un evento
+   concreto de un run con 16 hilos se reproduce en secuencial con la misma
+   semilla maestra (/random/setSeeds, primera semilla) y el mismo número de run.
+   La mezcla es SplitMix64; el motor (MixMax por defecto) recibe dos semillas
+   de 31 bits y abre con ellas un flujo propio. */
+class EventSeeder
+{
+public:
+  // Maestro, al empezar cada run (antes de que los hilos pidan eventos).
+  // firstEvent: número global del primer evento de este proceso (--shard).
+  // En secuencial el motor de los eventos es el del maestro: se guarda su
+  // estado para que SeedEvent no cambie la semilla de los runs siguientes
+  static void BeginRun(G4long masterSeed, G4int runID, G4long firstEvent = 0);
+  // Maestro, al terminar el run: devuelve el motor al estado de BeginRun
+  static void EndRun();
+
+  // Al principio de GeneratePrimaries, antes de cualquier número aleatorio del evento
+  static void SeedEvent(G4int eventID);
+
+  static G4long GetMasterSeed() { return masterSeed.load(std::memory_order_relaxed); }
+  static G4long GetEventOffset() { return eventOffset.load(std::memory_order_relaxed); }
+
+  // Clave del evento: función pura, también útil fuera de Geant4
+  static std::uint64_t EventKey(std::uint64_t seed, G4int runID, G4long eventID)
+  {
+    return Mix(Mix(Mix(seed) ^ static_cast<std::uint32_t>(runID)) ^ static_cast<std::uint64_t>(eventID));
+  }
+
+private:
+  static std::uint64_t Mix(std::uint64_t x)
+  {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  static std::atomic<G4long> masterSeed;
+  static std::atomic<G4int> currentRun;
+  static std::atomic<G4long> eventOffset;
+  static std::vector<unsigned long> savedEngine; // Estado del motor maestro (solo secuencial)
+};
+
+#endif // EVENTSEEDER_HH
@@ -0,0 +1,61 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef EVENTSINK_HH
+#define EVENTSINK_HH
+
+#include "EventFile.hh"
+#include "globals.hh"
+#include <cstdio>
+
+/* Destino de la salida por evento. Solo lo usa el hilo escritor de
+   EventWriter, así que las implementaciones no necesitan sincronización. */
+class EventSink
+{
+public:
+  virtual ~EventSink() {}
+
+  virtual G4bool Open(const G4String &path) = 0;
+  virtual void Write(const EventFile::Block &block) = 0;
+  virtual void Close() = 0;
+
+  // Extensión de fichero que corresponde al formato
+  virtual G4String GetExtension() const = 0;
+};
+
+// Texto: una fila por evento (compatible con el antiguo event_data.csv)
+class CsvEventSink : public EventSink
+{
+public:
+  CsvEventSink();
+  ~CsvEventSink() override;
+
+  G4bool Open(const G4String &path) override;
+  void Write(const EventFile::Block &block) override;
+  void Close() override;
+  G4String GetExtension() const override { return ".csv"; }
+
+private:
+  std::FILE *file;
+};
+
+// Binario columnar (.gaev), opcionalmente comprimido por bloques
+class BinaryEventSink : public EventSink
+{
+public:
+  BinaryEventSink(G4bool compress);
+  ~BinaryEventSink() override;
+
+  G4bool Open(const G4String &path) override;
+  void Write(const EventFile::Block &block) override;
+  void Close() override;
+  G4String GetExtension() const override { return ".gaev"; }
+
+private:
+  std::FILE *file;
+  G4bool compress;
+};
+
+#endif // EVENTSINK_HH
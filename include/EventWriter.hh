@@ -0,0 +1,89 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef EVENTWRITER_HH
+#define EVENTWRITER_HH
+
+#include "EventFile.hh"
+#include "globals.hh"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class EventSink;
+class EventOutputMessenger;
+
+// Bloque de eventos con su marca de "en escritura"
+struct EventBlockSlot
+{
+  EventFile::Block block;
+  std::atomic<bool> busy{false};
+};
+
+/* Escritor en segundo plano de la salida por evento. Los hilos de trabajo
+   entregan bloques llenos con Submit() y siguen simulando; un único hilo
+   escritor los pasa al EventSink elegido (/output/eventSink). Se crea en el
+   maestro y se comparte entre todos los RunAction. */
+class EventWriter
+{
+public:
+  enum class Format { None, Csv, Binary };
+
+  EventWriter();
+  ~EventWriter();
+
+  // Configuración (desde el messenger, fuera de un run)
+  void SetFormat(Format value);
+  void SetFileName(const G4String &value);
+  void SetCompression(G4bool value);
+  G4bool IsEnabled() const { return format != Format::None; }
+
+  void Start(); // Abre el fichero y lanza el hilo si no está en marcha
+  void Flush(); // Espera a que se escriban todos los bloques entregados
+  void Stop();  // Vacía la cola y cierra el fichero
+
+  void Submit(EventBlockSlot *slot); // Seguro desde cualquier hilo
+
+private:
+  void Loop();
+
+  Format format;
+  G4String fileName; // Sin extensión: la añade el sink
+  G4bool compress;
+
+  EventSink *sink;
+  std::thread writerThread;
+  std::mutex mutex;
+  std::condition_variable pending;
+  std::condition_variable drained;
+  std::deque<EventBlockSlot *> queue;
+  G4bool writing;
+  G4bool stopping;
+
+  EventOutputMessenger *messenger;
+};
+
+/* Doble búfer por hilo: mientras el escritor vuelca un bloque, el hilo
+   sigue rellenando el otro. Tras el constructor no reserva memoria. */
+class EventBuffer
+{
+public:
+  EventBuffer(EventWriter *writer, std::size_t blockSize = 4096);
+  ~EventBuffer();
+
+  void Add(G4int runID, G4int eventID, G4bool detected, G4double edep,
+           G4double entryEnergy, G4double primaryEnergy);
+  void Flush(); // Entrega el bloque parcial (fin de run)
+
+private:
+  EventWriter *writer;
+  std::size_t blockSize;
+  EventBlockSlot slots[2];
+  G4int active;
+};
+
+#endif // EVENTWRITER_HH
@@ -0,0 +1,26 @@
+#ifndef FASTSIMMESSENGER_HH
+#define FASTSIMMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+
+class FastSimMessenger : public G4UImessenger {
+public:
+    FastSimMessenger(DetectorConstruction* detector);
+    virtual ~FastSimMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+    virtual G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    DetectorConstruction* detectorConstruction;
+
+    G4UIdirectory* fastSimDir;
+    G4UIcmdWithABool* enableCmd;
+};
+
+#endif // FASTSIMMESSENGER_HH
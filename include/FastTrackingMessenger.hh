@@ -0,0 +1,28 @@
+#ifndef FASTTRACKINGMESSENGER_HH
+#define FASTTRACKINGMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SteppingAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+class FastTrackingMessenger : public G4UImessenger {
+public:
+    FastTrackingMessenger(SteppingAction* stepping);
+    virtual ~FastTrackingMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    SteppingAction* steppingAction;
+
+    G4UIdirectory* fastDir;
+    G4UIcmdWithABool* enableCmd;
+    G4UIcmdWithABool* killEscapingCmd;
+    G4UIcmdWithADoubleAndUnit* electronRangeCmd;
+};
+
+#endif // FASTTRACKINGMESSENGER_HH
@@ -0,0 +1,45 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef LAYERPARAMETERISATION_HH
+#define LAYERPARAMETERISATION_HH
+
+#include "G4VPVParameterisation.hh"
+#include "G4VVolumeMaterialScanner.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4Material;
+class G4Box;
+
+/* Capas apiladas en z dentro del absorbente, cada una con su material y su
+   espesor. Un único volumen lógico y un único G4PVParameterised describen
+   toda la pila: la memoria y la navegación no crecen con el número de capas
+   (G4ParameterisedNavigation voxeliza a lo largo de z). También hace de
+   G4VVolumeMaterialScanner: la lista de materiales es la de las capas. */
+class LayerParameterisation : public G4VPVParameterisation, public G4VVolumeMaterialScanner
+{
+public:
+  // zLow: cara de entrada de la pila; thicknesses y materials, una entrada por capa
+  LayerParameterisation(G4double halfXY, G4double zLow, const std::vector<G4double> &thicknesses,
+                        const std::vector<G4Material *> &materials);
+
+  void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume *physVol) const override;
+  void ComputeDimensions(G4Box &box, const G4int copyNo, const G4VPhysicalVolume *physVol) const override;
+  G4Material *ComputeMaterial(const G4int copyNo, G4VPhysicalVolume *physVol,
+                              const G4VTouchable *parentTouch = nullptr) override;
+
+  G4VVolumeMaterialScanner *GetMaterialScanner() override { return this; }
+  G4int GetNumberOfMaterials() const override { return static_cast<G4int>(materials.size()); }
+  G4Material *GetMaterial(G4int idx) const override { return materials[idx]; }
+
+private:
+  G4double halfXY;
+  std::vector<G4double> centres; // z del centro de cada capa
+  std::vector<G4double> halfZ;
+  std::vector<G4Material *> materials;
+};
+
+#endif // LAYERPARAMETERISATION_HH
@@ -0,0 +1,58 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef LAYERTALLY_HH
+#define LAYERTALLY_HH
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+#include <vector>
+
+/* Transmisión a través de las primeras i capas del absorbente: un evento
+   cuenta para la capa i si algún fotón sale por su cara posterior (una sola
+   vez por evento, con el peso del primero que lo hace). Es la misma
+   definición que la transmisión del detector, aplicada a cada interfaz. */
+class LayerTally : public G4VAccumulable
+{
+public:
+  explicit LayerTally(const G4String &name);
+
+  // Cara posterior (z) de cada capa; vacío = absorbente homogéneo, sin tally
+  void Configure(const std::vector<G4double> &backFaces);
+
+  G4bool IsActive() const { return !backFaces.empty(); }
+  G4double GetBackFace(G4int layer) const { return backFaces[layer]; }
+  G4double GetTolerance() const { return tolerance; }
+
+  // Fotón que sale de la capa por su cara posterior (SteppingAction)
+  void Cross(G4int layer, G4double weight)
+  {
+    if (eventWeight[layer] > 0.)
+      return;
+    eventWeight[layer] = weight;
+    touched.push_back(layer);
+  }
+
+  // Final de cada evento: suma lo marcado y limpia solo esas capas
+  void EndEvent();
+
+  void Merge(const G4VAccumulable &other) override;
+  void Reset() override;
+  void Print(G4PrintOptions options = G4PrintOptions()) const override;
+
+  G4int GetNumberOfLayers() const { return static_cast<G4int>(backFaces.size()); }
+  const std::vector<G4double> &GetSumW() const { return sumW; }
+  const std::vector<G4double> &GetSumW2() const { return sumW2; }
+
+private:
+  std::vector<G4double> backFaces;
+  G4double tolerance;
+  std::vector<G4double> eventWeight; // Peso del evento en curso por capa (0 = no cruzada)
+  std::vector<G4int> touched;        // Capas cruzadas en el evento en curso
+  std::vector<G4double> sumW;
+  std::vector<G4double> sumW2;
+};
+
+#endif // LAYERTALLY_HH
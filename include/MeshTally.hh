@@ -0,0 +1,91 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef MESHTALLY_HH
+#define MESHTALLY_HH
+
+#include "G4VAccumulable.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <vector>
+
+class MeshTallyMessenger;
+class G4Step;
+
+/* Configuración común de la malla de puntuación (/score/...). La crea
+   ActionInitialization en el hilo maestro; cada RunAction la copia al
+   comenzar el run. Con 0 vóxeles en algún eje la malla está desactivada. */
+class MeshConfig
+{
+public:
+  MeshConfig();
+  ~MeshConfig();
+
+  void SetVoxels(G4int x, G4int y, G4int z) { nx = x; ny = y; nz = z; }
+  G4int GetNx() const { return nx; }
+  G4int GetNy() const { return ny; }
+  G4int GetNz() const { return nz; }
+  G4bool IsActive() const { return nx > 0 && ny > 0 && nz > 0; }
+
+  void SetOutputBase(const G4String &path) { outputBase = path; }
+  const G4String &GetOutputBase() const { return outputBase; }
+
+private:
+  G4int nx, ny, nz;
+  G4String outputBase;
+  MeshTallyMessenger *messenger;
+};
+
+/* Malla de dosis y fluencia de fotones superpuesta al absorbente, sin
+   volúmenes por vóxel: el índice se calcula directamente a partir de la
+   posición del paso. Cada hilo acumula en su copia (estructura de arrays:
+   un array plano por magnitud) y las copias se suman al final del run como
+   el resto de acumulables.
+   - Dosis: energía depositada en el vóxel del punto medio del paso.
+   - Fluencia: longitud de traza de los fotones en cada vóxel (estimador de
+     longitud de traza), repartida con un recorrido DDA por los vóxeles que
+     cruza el paso. */
+class MeshTally : public G4VAccumulable
+{
+public:
+  MeshTally(const G4String &name, const MeshConfig *config);
+
+  // Copia la configuración y el tamaño actual del absorbente (inicio de run, antes de Reset)
+  void Configure(const G4ThreeVector &halfSize);
+
+  G4bool IsActive() const { return !edep.empty(); }
+  void Score(const G4Step *step); // Pasos dentro del absorbente
+
+  void Merge(const G4VAccumulable &other) override;
+  void Reset() override;
+  void Print(G4PrintOptions options = G4PrintOptions()) const override;
+
+  // Sumas sin normalizar; los ficheros de la malla se escriben desde RunTotals
+  G4int GetNx() const { return nx; }
+  G4int GetNy() const { return ny; }
+  G4int GetNz() const { return nz; }
+  G4ThreeVector GetHalfSize() const { return -low; }
+  G4double GetPlaneZ(G4int iz) const { return low.z() + (iz + 0.5) * voxelSize.z(); } // Centro del plano
+  const std::vector<G4double> &GetEdep() const { return edep; }
+  const std::vector<G4double> &GetFluence() const { return fluence; }
+
+  std::size_t Index(G4int ix, G4int iy, G4int iz) const
+  {
+    return (static_cast<std::size_t>(iz) * ny + iy) * nx + ix;
+  }
+
+private:
+  void AddTrackLength(const G4ThreeVector &start, const G4ThreeVector &end, G4double weight);
+
+  const MeshConfig *config;
+  G4int nx, ny, nz;
+  G4ThreeVector low;       // Esquina inferior del absorbente
+  G4ThreeVector voxelSize;
+  G4ThreeVector inverseSize; // 1 / voxelSize, para no dividir en cada paso
+  std::vector<G4double> edep;    // Energía depositada por vóxel
+  std::vector<G4double> fluence; // Longitud de traza de fotones por vóxel (ponderada)
+};
+
+#endif // MESHTALLY_HH
@@ -0,0 +1,27 @@
+#ifndef MESHTALLYMESSENGER_HH
+#define MESHTALLYMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class MeshConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+
+class MeshTallyMessenger : public G4UImessenger {
+public:
+    MeshTallyMessenger(MeshConfig* config);
+    virtual ~MeshTallyMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    MeshConfig* config;
+
+    G4UIdirectory* scoreDir;
+    G4UIcommand* voxelsCmd;
+    G4UIcmdWithAString* outputCmd;
+};
+
+#endif // MESHTALLYMESSENGER_HH
@@ -12,6 +12,10 @@ public:
     MiHit();
     virtual ~MiHit();
 
+    // Reserva desde un pool por hilo en lugar del heap general
+    inline void* operator new(size_t);
+    inline void operator delete(void* hit);
+
     // Defino metodos obligatorios
     virtual void Draw() {}
     virtual void Print() {}
@@ -31,4 +35,18 @@ public:
 // Definimos la colección de hits como un typedef
 using MiHitsCollection = G4THitsCollection<MiHit>;
 
-#endif
\ No newline at end of file
+extern G4ThreadLocal G4Allocator<MiHit>* MiHitAllocator;
+
+inline void* MiHit::operator new(size_t)
+{
+    if (!MiHitAllocator)
+        MiHitAllocator = new G4Allocator<MiHit>;
+    return (void*)MiHitAllocator->MallocSingle();
+}
+
+inline void MiHit::operator delete(void* hit)
+{
+    MiHitAllocator->FreeSingle((MiHit*)hit);
+}
+
+#endif
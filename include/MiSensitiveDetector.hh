@@ -8,16 +8,47 @@
 #include "G4VHit.hh"
 #include "MiHit.hh"
 
+class DetectorConstruction;
+class DetectorSpectrum;
+
+// Magnitudes por evento del detector. Vive dentro del SD (uno por hilo), se
+// reinicia en Initialize() y se rellena sin reservar memoria.
+struct DetectorScore
+{
+  G4bool hit = false;          // Alguna partícula entró en el detector
+  G4double edep = 0.;          // Energía depositada total
+  G4ThreeVector firstPos;      // Posición del primer paso en el detector
+  G4double entryEnergy = 0.;   // Energía cinética de la primera partícula que entra
+  G4double weight = 1.;        // Peso estadístico de esa partícula (1 sin biasing)
+  G4bool uncollided = false;   // Entró un fotón primario sin ninguna interacción previa
+  G4double uncollidedWeight = 0.; // Su peso (0 si el evento solo trae radiación dispersada)
+
+  void Reset()
+  {
+    hit = false; edep = 0.; firstPos = G4ThreeVector(); entryEnergy = 0.; weight = 1.;
+    uncollided = false; uncollidedWeight = 0.;
+  }
+};
+
 class MiSensitiveDetector : public G4VSensitiveDetector {
 public:
-  MiSensitiveDetector(const G4String& name);
+  MiSensitiveDetector(const G4String& name, const DetectorConstruction* detector);
   virtual ~MiSensitiveDetector();
 
   void Initialize(G4HCofThisEvent* hce) override;
   G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
 
+  const DetectorScore& GetEventScore() const { return score; }
+
+  // Espectro de entrada del hilo (lo aporta RunAction a través de EventAction)
+  void SetSpectrum(DetectorSpectrum* value) { spectrum = value; }
+
 private:
-  MiHitsCollection* hitsCollection;
+  const DetectorConstruction* detector; // Indica si hay que guardar MiHit (visualización)
+  DetectorScore score;
+  DetectorSpectrum* spectrum;
+  MiHitsCollection* hitsCollection; // Solo cuando se guardan hits
+  G4int hcID; // Un SD por hilo: el ID no puede ser un static compartido
 };
 
 #endif // MISENSITIVEDETECTOR_HH
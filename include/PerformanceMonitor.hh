@@ -0,0 +1,134 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef PERFORMANCEMONITOR_HH
+#define PERFORMANCEMONITOR_HH
+
+/* Instrumentación de las partes calientes (cmake -DGAMMAATT_INSTRUMENT=ON).
+   Sin la opción las macros GAMMAATT_PERF_* se expanden a nada y la clase no
+   se compila, así que el binario normal no paga ningún coste. Con ella:
+   - cronómetros de fase en el hilo maestro: geometría, lista de física,
+     tablas de física, bucle de eventos y volcado de la salida;
+   - contadores por hilo sin sincronización (pasos por volumen, trazas,
+     secundarias, llamadas al SD), que se suman al final de cada run;
+   - muestreo de la tasa de eventos de cada hilo.
+   El maestro añade un bloque de rendimiento por run a results_summary.txt
+   y una línea JSON a results/performance.jsonl. */
+
+#ifdef GAMMAATT_INSTRUMENT
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include <chrono>
+#include <utility>
+#include <vector>
+
+class PerformanceMonitor
+{
+public:
+  enum Phase { kGeometry, kPhysicsList, kPhysicsTables, kEventLoop, kOutputFlush, kNumPhases };
+  enum Volume { kWorld, kAbsorber, kDetector, kNumVolumes };
+
+  static constexpr G4long kSampleInterval = 1000; // Eventos entre muestras de tasa
+  static constexpr std::size_t kMaxSamples = 512; // Se diezma al llegar aquí
+
+  // Contadores de un hilo (solo los toca ese hilo)
+  struct ThreadCounters
+  {
+    G4long steps[kNumVolumes] = {};
+    G4long tracks = 0;
+    G4long secondaries = 0;
+    G4long sdCalls = 0;
+    G4long events = 0;
+    G4double start = 0.;  // s, inicio del run en este hilo
+    G4long sampleEvery = kSampleInterval;
+    std::vector<std::pair<G4double, G4long>> samples; // (t desde el inicio, eventos)
+  };
+
+  static PerformanceMonitor *Instance();
+  static ThreadCounters &Local();
+  static G4double Now()
+  {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<G4double>(clock::now().time_since_epoch()).count();
+  }
+
+  // Fases: solo cuenta el hilo maestro (los hilos de trabajo repiten parte del trabajo)
+  void BeginPhase(Phase phase);
+  void EndPhase(Phase phase);
+  void AddPhaseTime(Phase phase, G4double seconds);
+
+  // Ciclo por hilo: BeginThreadRun al empezar el run, CollectThread al acabar
+  void BeginThreadRun();
+  void EndEvent()
+  {
+    ThreadCounters &c = Local();
+    if (++c.events % c.sampleEvery == 0)
+      Sample(c);
+  }
+  void CollectThread();
+
+  // Maestro, al final del run: escribe el informe y pone todo a cero
+  void WriteRunReport(G4int runID, const G4String &material, G4double thicknessCm);
+
+  class ScopedTimer
+  {
+  public:
+    explicit ScopedTimer(Phase p) : phase(p), start(Now()) {}
+    ~ScopedTimer() { PerformanceMonitor::Instance()->AddPhaseTime(phase, Now() - start); }
+
+  private:
+    Phase phase;
+    G4double start;
+  };
+
+private:
+  PerformanceMonitor();
+  void Sample(ThreadCounters &counters);
+
+  struct ThreadReport
+  {
+    G4int thread;
+    G4long events;
+    G4double seconds;
+    std::vector<std::pair<G4double, G4long>> samples;
+  };
+
+  G4Mutex mutex;
+  G4double phaseTime[kNumPhases];
+  G4double phaseStart[kNumPhases];
+  ThreadCounters totals;
+  std::vector<ThreadReport> threads;
+};
+
+#define GAMMAATT_PERF_CONCAT2(a, b) a##b
+#define GAMMAATT_PERF_CONCAT(a, b) GAMMAATT_PERF_CONCAT2(a, b)
+#define GAMMAATT_PERF_SCOPE(phase) \
+  PerformanceMonitor::ScopedTimer GAMMAATT_PERF_CONCAT(perfTimer, __LINE__)(PerformanceMonitor::phase)
+#define GAMMAATT_PERF_BEGIN(phase) PerformanceMonitor::Instance()->BeginPhase(PerformanceMonitor::phase)
+#define GAMMAATT_PERF_END(phase) PerformanceMonitor::Instance()->EndPhase(PerformanceMonitor::phase)
+#define GAMMAATT_PERF_STEP(volume) (++PerformanceMonitor::Local().steps[PerformanceMonitor::volume])
+#define GAMMAATT_PERF_COUNT(counter, n) (PerformanceMonitor::Local().counter += (n))
+#define GAMMAATT_PERF_EVENT() PerformanceMonitor::Instance()->EndEvent()
+#define GAMMAATT_PERF_THREAD_BEGIN() PerformanceMonitor::Instance()->BeginThreadRun()
+#define GAMMAATT_PERF_THREAD_END() PerformanceMonitor::Instance()->CollectThread()
+#define GAMMAATT_PERF_REPORT(runID, material, thicknessCm) \
+  PerformanceMonitor::Instance()->WriteRunReport(runID, material, thicknessCm)
+
+#else
+
+#define GAMMAATT_PERF_SCOPE(phase)
+#define GAMMAATT_PERF_BEGIN(phase)
+#define GAMMAATT_PERF_END(phase)
+#define GAMMAATT_PERF_STEP(volume)
+#define GAMMAATT_PERF_COUNT(counter, n)
+#define GAMMAATT_PERF_EVENT()
+#define GAMMAATT_PERF_THREAD_BEGIN()
+#define GAMMAATT_PERF_THREAD_END()
+#define GAMMAATT_PERF_REPORT(runID, material, thicknessCm)
+
+#endif // GAMMAATT_INSTRUMENT
+
+#endif // PERFORMANCEMONITOR_HH
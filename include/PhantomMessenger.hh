@@ -0,0 +1,31 @@
+#ifndef PHANTOMMESSENGER_HH
+#define PHANTOMMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class PhantomMessenger : public G4UImessenger {
+public:
+    PhantomMessenger(DetectorConstruction* detector);
+    virtual ~PhantomMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    DetectorConstruction* detectorConstruction;
+
+    G4UIdirectory* phantomDir;
+    G4UIcommand* loadCmd;
+    G4UIcmdWithoutParameter* clearCmd;
+    G4UIcommand* huRangeCmd;
+    G4UIcmdWithoutParameter* resetHUCmd;
+    G4UIcmdWithAString* indexMaterialsCmd;
+};
+
+#endif // PHANTOMMESSENGER_HH
@@ -0,0 +1,50 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef PHOTONONLYPHYSICS_HH
+#define PHOTONONLYPHYSICS_HH
+
+#include "G4VPhysicsConstructor.hh"
+#include "G4VProcess.hh"
+#include "globals.hh"
+
+/* Física EM mínima para estudios de atenuación (/phys/select photon): los
+   fotones tienen efecto fotoeléctrico, Compton, Rayleigh y producción de
+   pares con los modelos estándar; los electrones y positrones no se
+   transportan, sino que depositan su energía cinética donde se crean.
+   No se construyen tablas de pérdida de energía ni de alcance, que son la
+   mayor parte del tiempo de inicialización de las listas completas. */
+class PhotonOnlyPhysics : public G4VPhysicsConstructor
+{
+public:
+  PhotonOnlyPhysics();
+  ~PhotonOnlyPhysics() override = default;
+
+  void ConstructParticle() override;
+  void ConstructProcess() override;
+};
+
+/* Detiene la partícula en su primer paso (longitud cero) y deposita ahí su
+   energía cinética. Un positrón se aniquila en reposo: emite dos fotones
+   de 511 keV en sentidos opuestos, que siguen el transporte normal. */
+class LocalDepositProcess : public G4VProcess
+{
+public:
+  LocalDepositProcess();
+  ~LocalDepositProcess() override = default;
+
+  G4double PostStepGetPhysicalInteractionLength(const G4Track &track, G4double previousStepSize,
+                                                G4ForceCondition *condition) override;
+  G4VParticleChange *PostStepDoIt(const G4Track &track, const G4Step &step) override;
+
+  // Sin acciones continuas ni en reposo
+  G4double AlongStepGetPhysicalInteractionLength(const G4Track &, G4double, G4double, G4double &,
+                                                 G4GPILSelection *) override { return -1.; }
+  G4VParticleChange *AlongStepDoIt(const G4Track &, const G4Step &) override { return nullptr; }
+  G4double AtRestGetPhysicalInteractionLength(const G4Track &, G4ForceCondition *) override { return -1.; }
+  G4VParticleChange *AtRestDoIt(const G4Track &, const G4Step &) override { return nullptr; }
+};
+
+#endif // PHOTONONLYPHYSICS_HH
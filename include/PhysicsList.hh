@@ -3,15 +3,37 @@
 
 #include "G4VModularPhysicsList.hh"
 #include "G4PhysListFactory.hh"
-#include "G4DecayPhysics.hh"
+
+class PhysicsTableCache;
+class PhysicsListMessenger;
 
 class PhysicsList : public G4VModularPhysicsList {
   public:
     PhysicsList();
     ~PhysicsList() override;
 
+    // Envuelve los procesos de fotones para el biasing genérico (antes de Initialize)
+    void EnableBiasing();
+
+    // Proceso de simulación rápida para fotones (--fastsim, antes de Initialize)
+    void EnableFastSimulation();
+
+    // Sustituye la física EM (/phys/select, --physics; solo antes de Initialize).
+    // false si el nombre no está en GetEMNames()
+    G4bool SelectEM(const G4String& name);
+    const G4String& GetEMName() const { return emName; }
+    static const std::vector<G4String>& GetEMNames();
+
+    // Construcción de los procesos (cronometrada con GAMMAATT_INSTRUMENT)
+    void ConstructProcess() override;
+
+    // Caché en disco de las tablas de física (/phys/tableCache)
+    PhysicsTableCache* GetTableCache() const { return tableCache; }
+
   private:
-    G4DecayPhysics* decayPhysics; // Solo mantener la referencia, no eliminar manualmente
+    G4String emName;
+    PhysicsTableCache* tableCache;
+    PhysicsListMessenger* messenger;
 };
 
-#endif // PHYSICSLIST_HH
\ No newline at end of file
+#endif // PHYSICSLIST_HH
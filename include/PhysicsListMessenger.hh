@@ -0,0 +1,27 @@
+#ifndef PHYSICSLISTMESSENGER_HH
+#define PHYSICSLISTMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PhysicsList;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+
+class PhysicsListMessenger : public G4UImessenger {
+public:
+    PhysicsListMessenger(PhysicsList* physicsList);
+    virtual ~PhysicsListMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+    virtual G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    PhysicsList* physicsList;
+
+    G4UIdirectory* physDir;
+    G4UIcmdWithAString* selectCmd;
+    G4UIcmdWithAString* tableCacheCmd;
+};
+
+#endif // PHYSICSLISTMESSENGER_HH
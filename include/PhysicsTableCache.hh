@@ -0,0 +1,53 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef PHYSICSTABLECACHE_HH
+#define PHYSICSTABLECACHE_HH
+
+#include "G4VStateDependent.hh"
+#include "G4Timer.hh"
+#include "globals.hh"
+
+class G4VModularPhysicsList;
+
+/* Caché en disco de las tablas de física, indexada por contenido.
+   La clave resume la composición de los materiales de la geometría, la
+   lista de física y sus parámetros EM, los cortes y la versión de Geant4:
+   si cambia cualquiera de ellos se usa otro directorio, de modo que nunca
+   se recuperan tablas obsoletas.
+   Se engancha a los cambios de estado del núcleo: Idle -> Init ocurre justo
+   antes de BuildPhysicsTables (se pide recuperar si la entrada existe) e
+   Idle -> GeomClosed justo después (se guarda la entrada si faltaba y se
+   informa del tiempo). Solo existe en el hilo maestro, que es el único que
+   construye las tablas. */
+class PhysicsTableCache : public G4VStateDependent
+{
+public:
+  PhysicsTableCache(G4VModularPhysicsList *physicsList);
+  ~PhysicsTableCache() override = default;
+
+  G4bool Notify(G4ApplicationState requestedState) override;
+
+  // Directorio raíz; vacío desactiva la caché
+  void SetDirectory(const G4String &dir) { directory = dir; }
+  const G4String &GetDirectory() const { return directory; }
+
+private:
+  G4String DescribeConfiguration() const; // Texto del que se obtiene la clave
+  void BeginBuild();
+  void EndBuild();
+
+  G4VModularPhysicsList *physicsList;
+  G4String directory;
+  G4ApplicationState previousState;
+
+  G4String builtKey;   // Clave de las tablas que hay en memoria
+  G4String pendingKey; // Clave del run que se está inicializando
+  G4bool pending;
+  G4bool retrieving;
+  G4Timer timer;
+};
+
+#endif // PHYSICSTABLECACHE_HH
@@ -0,0 +1,25 @@
+#ifndef PRECISIONMESSENGER_HH
+#define PRECISIONMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PrecisionMonitor;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+
+class PrecisionMessenger : public G4UImessenger {
+public:
+    PrecisionMessenger(PrecisionMonitor* monitor);
+    virtual ~PrecisionMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    PrecisionMonitor* precisionMonitor;
+
+    G4UIcommand* beamToPrecisionCmd;
+    G4UIcmdWithAnInteger* checkIntervalCmd;
+};
+
+#endif // PRECISIONMESSENGER_HH
@@ -0,0 +1,62 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef PRECISIONMONITOR_HH
+#define PRECISIONMONITOR_HH
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include <atomic>
+
+class PrecisionMessenger;
+
+/* Parada adaptativa del run (/run/beamToPrecision). Vive en el hilo
+   maestro y la comparten todos los hilos de trabajo: cada hilo aporta sus
+   eventos en lotes de GetCheckInterval() y, en cuanto el error relativo del
+   coeficiente de atenuación baja del objetivo, todos dejan de generar
+   eventos. Con la transformada exponencial el error es el de los pesos,
+   como en los resultados finales: el número de transmitidos sin ponderar
+   está inflado a propósito y pararía antes de tiempo. Fuera de ese modo no
+   hace nada. */
+class PrecisionMonitor
+{
+public:
+  PrecisionMonitor();
+  ~PrecisionMonitor();
+
+  // Lanza un run de como máximo maxEvents que se detiene al alcanzar relError
+  void BeamToPrecision(G4double relError, G4int maxEvents);
+
+  G4bool IsActive() const { return targetRelError > 0.; }
+  G4int GetCheckInterval() const { return checkInterval; }
+  void SetCheckInterval(G4int n) { checkInterval = n; }
+
+  // Inicio de run (maestro): pone a cero los contadores compartidos.
+  // weighted: el run usa la transformada exponencial
+  void Reset(G4bool weighted = false);
+  // Lote de un hilo de trabajo (sumW/sumW2: pesos de los transmitidos);
+  // devuelve true si ya se alcanzó la precisión
+  G4bool Update(G4int nEvents, G4int nTransmitted, G4double sumW, G4double sumW2);
+  G4bool IsReached() const { return reached.load(std::memory_order_relaxed); }
+
+  // Error relativo de mu (Wilson), el mismo que dan los resultados finales (RunTotals)
+  static G4double RelativeError(G4long n, G4long k);
+
+private:
+  G4double targetRelError; // <= 0: modo desactivado
+  G4int minEvents;         // Evita parar por una fluctuación temprana
+  G4int checkInterval;     // Eventos por lote y por hilo
+  G4bool weighted;
+  G4Mutex mutex;           // Protege las sumas; se toma una vez por lote
+  G4long events;
+  G4long transmitted;
+  G4double sumW;
+  G4double sumW2;
+  std::atomic<G4bool> reached;
+
+  PrecisionMessenger *messenger;
+};
+
+#endif // PRECISIONMONITOR_HH
@@ -5,6 +5,9 @@
 #include "globals.hh"
 #include "G4ParticleGun.hh"
 
+class SourceSpectrum;
+class SourceMessenger;
+
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction {
 public:
   PrimaryGeneratorAction();
@@ -12,8 +15,13 @@ public:
 
   virtual void GeneratePrimaries(G4Event* event);
 
+  // Fuente del run para el almacén de resultados (mono:662keV, lines:..., ...)
+  G4String GetSpectrumTag() const;
+
 private:
   G4ParticleGun* particleGun;
+  SourceSpectrum* spectrum; // Uno por hilo; sin espectro se usa /gun/energy
+  SourceMessenger* messenger;
 };
 
 #endif // PRIMARYGENERATORACTION_HH
@@ -0,0 +1,90 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef RESULTSSTORE_HH
+#define RESULTSSTORE_HH
+
+// Almacén único de resultados por run (results/store.tsv). No depende de
+// Geant4 para que la herramienta gammaAtt-results pueda consultarlo sin él.
+//
+// Es un registro de solo añadir en texto separado por tabuladores: una línea
+// de cabecera que empieza por '#' (la ignoran TTree::ReadFile y los lectores
+// de comentarios) y una línea por run. Cada línea se escribe con una sola
+// write() sobre un descriptor O_APPEND y bajo flock(), así que varios
+// procesos de un barrido pueden escribir a la vez sin mezclar líneas.
+//
+// La clave de cada run resume (material, densidad, espesor, espectro, lista
+// de física, semilla, eventos pedidos). Si se repite un run con la misma
+// clave, la línea más reciente es la que vale.
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ResultsStore
+{
+  struct Record
+  {
+    // --- Clave ---
+    std::string material;   // Nombre del G4Material (G4_WATER, bone, ...)
+    double density = 0.;    // g/cm3
+    double thickness = 0.;  // cm
+    std::string spectrum;   // mono:662keV, lines:..., continuous:...
+    std::string physics;    // Constructores de la lista de física
+    long long seed = 0;
+    long long requested = 0; // Eventos pedidos a BeamOn
+
+    // --- Resultado ---
+    std::string key;        // Lo rellena Append()
+    long long timestamp = 0; // s desde epoch, lo rellena Append()
+    std::string label;      // Nombre pedido en /detector/setMaterial
+    long long events = 0;
+    long long transmitted = 0;
+    double transmission = 0.;
+    double mu = 0.;          // cm^-1
+    double relError = -1.;
+    double meanEnergy = 0.;  // keV
+    double fom = 0.;
+    long long uncollided = -1; // Eventos con fotón sin colisión (-1: run anterior a la clasificación)
+    double muNarrow = 0.;      // cm^-1, haz estrecho
+    double narrowRelError = -1.;
+    double buildup = 0.;       // T_total / T_sin_colisión
+  };
+
+  // Columnas en el orden en que se escriben
+  const std::vector<std::string> &Columns();
+
+  // FNV-1a de 64 bits en hexadecimal
+  std::string Hash(const std::string &text);
+  std::string MakeKey(const Record &record);
+
+  // GAMMAATT_STORE o ../results/store.tsv (relativo al directorio build/)
+  std::string DefaultPath();
+
+  // Los campos de texto no pueden llevar tabuladores ni saltos de línea
+  std::string Sanitize(const std::string &text);
+
+  // Añade un run de forma atómica; escribe la cabecera si el fichero es nuevo
+  // o si la última cabecera del fichero tiene otras columnas (formato antiguo)
+  bool Append(const std::string &path, Record &record);
+
+  class Store
+  {
+  public:
+    explicit Store(const std::string &path);
+
+    bool Load(); // Lee el fichero completo y construye el índice por clave
+    const std::vector<Record> &GetRecords() const { return records; }
+    const Record *Find(const std::string &key) const; // O(1)
+
+  private:
+    std::string path;
+    std::vector<Record> records; // Uno por clave, la versión más reciente
+    std::unordered_map<std::string, std::size_t> index;
+  };
+}
+
+#endif // RESULTSSTORE_HH
@@ -7,56 +7,118 @@ Fecha: Octubre 2025
 #define RUNACTION_HH
 
 #include "G4UserRunAction.hh"
+#include "G4Accumulable.hh"
+#include "G4Timer.hh"
+#include "EnergyTally.hh"
+#include "MeshTally.hh"
+#include "LayerTally.hh"
 #include "DetectorConstruction.hh"
 #include "globals.hh"
 #include "G4SystemOfUnits.hh"
 #include <cmath>
 
-#ifdef USE_ROOT
-class TFile;
-class TTree;
-class TH1F;
+class SweepManager;
+class EventWriter;
+class EventBuffer;
+class PrecisionMonitor;
+namespace RunTotals
+{
+  struct Totals;
+}
 
-// Forward declarations de tipos ROOT
-typedef int Int_t;
-typedef float Float_t;
-typedef char Char_t;
-#endif
+// Resultado fusionado del último run (solo en el maestro)
+struct RunSummary
+{
+  G4int events = 0;
+  G4int transmitted = 0;
+  G4double steps = 0.;
+  G4double transmissionRatio = 0.;
+  G4double attenuationCoeff = 0.;
+  G4double relError = -1.;
+  G4int uncollided = 0;           // Eventos con un fotón primario sin colisión en el detector
+  G4double narrowBeamCoeff = 0.;  // mu de haz estrecho, solo con fotones sin colisión
+  G4double buildup = 0.;          // Factor de acumulación T_total / T_sin_colisión
+  G4double realTime = 0.; // s
+};
 
 class RunAction : public G4UserRunAction
 {
 public:
-  RunAction(DetectorConstruction *detector);
+  RunAction(DetectorConstruction *detector, const SweepManager *sweep = nullptr,
+            EventWriter *eventWriter = nullptr, PrecisionMonitor *precision = nullptr,
+            const EnergyBinning *energyBinning = nullptr, const MeshConfig *meshConfig = nullptr);
   virtual ~RunAction();
 
   virtual void BeginOfRunAction(const G4Run *run);
   virtual void EndOfRunAction(const G4Run *run);
 
-  void AddTransmittedEvent();
+  // Llamados desde EventAction en cada hilo; se fusionan al final del run
+  void AddEvent(G4double primaryEnergy);
+  // weight: peso de la partícula detectada; uncollidedWeight: el del fotón
+  // primario que llegó sin colisión (0 si el evento solo trae radiación dispersada)
+  void AddTransmittedEvent(G4double primaryEnergy, G4double weight = 1., G4double uncollidedWeight = 0.);
+
+  // Espectro de entrada en el detector de este hilo (lo llena MiSensitiveDetector)
+  DetectorSpectrum *GetDetectorSpectrum() { return &detectorSpectrum; }
+
+  // Malla de dosis/fluencia de este hilo (la llena SteppingAction en el absorbente)
+  MeshTally *GetMeshTally() { return &meshTally; }
+  const MeshTally *GetMeshTally() const { return &meshTally; }
+
+  // Transmisión tras cada capa de este hilo (SteppingAction marca, EventAction cierra el evento)
+  LayerTally *GetLayerTally() { return &layerTally; }
+
+  // /run/beamToPrecision: aporta el lote del hilo al final de cada evento
+  void CheckPrecision();
+  G4bool PrecisionReached() const;
+
+  // Llamado en cada paso desde SteppingAction: solo incrementa un contador local
+  void CountStep() { ++stepCount; }
+
+  const RunSummary &GetLastRun() const { return lastRun; }
+
+  // Algún run del proceso no pudo guardar su resultado: main sale con error
+  // para que nadie tome una salida incompleta por terminada
+  static G4bool OutputsFailed() { return outputsFailed; }
+
+  // Fila de la salida por evento (búfer local del hilo, sin E/S en el evento)
+  void RecordEvent(G4int eventID, G4bool detected, G4double edep,
+                   G4double entryEnergy, G4double primaryEnergy);
 
 private:
+  // Sumas fusionadas y configuración del run (maestro, al final del run)
+  void CollectTotals(const G4Run *run, RunTotals::Totals &totals) const;
+
   DetectorConstruction *detector;
-  G4int totalEvents;
-  G4int transmittedEvents;
-
-#ifdef USE_ROOT
-  // Variables ROOT - solo datos esenciales
-  TFile *rootFile;
-  TTree *attenuationTree;
-  TH1F *attenuationHist;
-
-  // Estructura para datos del Tree
-  struct RunData
-  {
-    Int_t runID;
-    Char_t material[50];
-    Float_t thickness;
-    Int_t totalEvents;
-    Int_t transmittedEvents;
-    Float_t transmissionRatio;
-    Float_t attenuationCoeff;
-  } runData;
-#endif
+  const SweepManager *sweep;
+  EventWriter *eventWriter;
+  EventBuffer *eventBuffer;
+  PrecisionMonitor *precision;
+  G4int batchEvents;      // Eventos del hilo aún no comunicados al monitor
+  G4int batchTransmitted;
+  G4double batchWeight;   // Pesos de los transmitidos del lote (transformada exponencial)
+  G4double batchWeight2;
+  G4int currentRunID;
+  G4Accumulable<G4int> totalEvents;
+  G4Accumulable<G4int> transmittedEvents;
+  G4Accumulable<G4double> primaryEnergySum; // Para la energía media del haz
+  G4Accumulable<G4double> transmittedWeight;  // Suma de pesos (= transmitidos sin biasing)
+  G4Accumulable<G4double> transmittedWeight2; // Suma de pesos al cuadrado, para la varianza
+  G4Accumulable<G4int> uncollidedEvents;      // Haz estrecho: fotón primario sin colisión
+  G4Accumulable<G4double> uncollidedWeight;
+  G4Accumulable<G4double> uncollidedWeight2;
+  G4Accumulable<G4double> totalSteps;
+  G4long stepCount; // Pasos de este hilo; se vuelcan en totalSteps al final del run
+  RunSummary lastRun;
+  G4long runSeed; // Semilla maestra del run (EventSeeder)
+  G4Timer runTimer; // Tiempo real del run (maestro), para la figura de mérito
+  EnergyTally energyTally; // Transmisión por bin de energía primaria
+  DetectorSpectrum detectorSpectrum; // Energía de entrada en el detector (sin colisión / dispersados)
+  const EnergyBinning *energyBinning;
+  MeshTally meshTally; // Dosis y fluencia por vóxel del absorbente
+  const MeshConfig *meshConfig;
+  LayerTally layerTally; // Transmisión tras cada capa del absorbente
+  static G4bool outputsFailed; // Solo lo escribe el maestro
 };
 
 #endif // RUNACTION_HH
\ No newline at end of file
@@ -0,0 +1,136 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef RUNTOTALS_HH
+#define RUNTOTALS_HH
+
+// Sumas exactas de un run y la configuración necesaria para interpretarlas.
+// No depende de Geant4 para que gammaAtt-merge pueda fusionar fragmentos sin él.
+//
+// Todos los resultados finales (almacén, results_summary.txt, CSV por
+// energía, espectro del detector y capas, malla y árbol ROOT) se calculan a
+// partir de estas sumas: al final de un run normal (RunAction) y al fusionar
+// los fragmentos de --shard i/N (gammaAtt-merge). Un run partido en
+// fragmentos da así los mismos resultados que en un solo proceso.
+//
+// Fichero de fragmento (.gashard): texto, una entrada "nombre valores" por
+// línea; los reales con 17 cifras para que la lectura sea exacta. Los
+// arrays llevan su longitud delante. Unidades: keV, cm, g/cm3 y MeV para la
+// energía depositada.
+
+#include "ResultsStore.hh"
+#include <string>
+#include <vector>
+
+namespace RunTotals
+{
+  struct EnergyBin
+  {
+    double low = 0.; // keV; igual a high en modo líneas
+    double high = 0.;
+    double events = 0.;
+    double sumW = 0.;
+    double sumW2 = 0.;
+  };
+
+  struct Layer
+  {
+    std::string material;
+    double depth = 0.; // cm, cara posterior desde la cara de entrada
+    double sumW = 0.;
+    double sumW2 = 0.;
+  };
+
+  struct Totals
+  {
+    // --- Configuración: tiene que coincidir en todos los fragmentos ---
+    ResultsStore::Record record; // Campos de la clave y etiqueta; requested = eventos del run completo
+    int runID = 0;
+    bool weighted = false;       // Transformada exponencial: error de la varianza de los pesos
+    std::string energyBinning;   // Bordes de /tally/energyBins ("lines" sin bordes)
+    double spectrumWidth = 0.;   // keV; 0 = espectro del detector desactivado
+    int spectrumBins = 0;        // Con el bin de desbordamiento
+    std::vector<Layer> layers;   // Vacío = absorbente homogéneo
+    int meshDims[3] = {0, 0, 0};
+    double meshHalf[3] = {0., 0., 0.}; // cm
+    std::vector<double> planeDensity;  // g/cm3 de cada plano z de la malla
+
+    // --- Fragmento (0/1: run completo) ---
+    int shard = 0;
+    int shards = 0;
+    long long firstEvent = 0;
+    long long shardEvents = 0; // Eventos pedidos a este fragmento
+
+    // --- Ficheros de salida (los del primer fragmento) ---
+    std::string energyFile;
+    std::string spectrumFile;
+    std::string layerFile;
+    std::string meshBase;
+    std::string rootFile;
+    bool rootUpdate = false; // Barridos: varios puntos en el mismo fichero ROOT
+
+    // --- Sumas ---
+    long long events = 0;
+    long long transmitted = 0;
+    long long uncollided = 0;
+    double energySum = 0.; // keV
+    double sumW = 0.;
+    double sumW2 = 0.;
+    double sumWu = 0.;
+    double sumWu2 = 0.;
+    double steps = 0.;
+    double realTime = 0.; // s, suma de los fragmentos
+    std::vector<EnergyBin> energyBins; // Solo los no vacíos, ordenados por energía
+    std::vector<double> spectrumUncollided;
+    std::vector<double> spectrumScattered;
+    std::vector<double> meshEdep;     // MeV por vóxel (ponderado)
+    std::vector<double> meshFluence;  // cm de traza de fotones por vóxel (ponderada)
+  };
+
+  // Magnitudes derivadas de las sumas
+  struct Results
+  {
+    double transmission = 0.;
+    double mu = 999.;        // cm^-1
+    double relErrorT = 0.;   // Error relativo de la transmisión
+    double relError = -1.;   // Error relativo de mu
+    double meanEnergy = 0.;  // keV
+    double uncollidedRatio = 0.;
+    double muNarrow = 999.;
+    double narrowRelError = -1.;
+    double buildup = 0.;
+    double fom = 0.;         // 1/(R^2 t)
+  };
+
+  /* Error relativo (1 sigma) de mu = -ln(T)/x a partir del intervalo de
+     Wilson de la transmisión T = k/n. El espesor se cancela. Devuelve un
+     valor negativo si aún no está definido (k = 0 o k = n). */
+  double RelativeError(long long n, long long k);
+
+  /* Lo mismo con pesos (transformada exponencial): varianza de la media de
+     los pesos por evento, propagada a mu. Negativo si no está definido. */
+  double WeightedRelativeError(long long n, double sumW, double sumW2);
+
+  Results Compute(const Totals &totals);
+
+  bool Save(const std::string &path, const Totals &totals);
+  bool Load(const std::string &path, Totals &totals, std::string &error);
+
+  // Primer campo de configuración distinto ("" si se pueden fusionar)
+  std::string Mismatch(const Totals &a, const Totals &b);
+
+  // Suma un fragmento; false (y el motivo) si la configuración no coincide
+  bool Add(Totals &into, const Totals &shard, std::string &error);
+
+  // Fichero ROOT propio de un run fuera de un barrido: results/runs/<clave>.root.
+  // Dos runs distintos del mismo material ya no se pisan
+  std::string RunRootFile(const ResultsStore::Record &record);
+
+  // Escribe todas las salidas finales del run y las resume en la salida
+  // estándar; false si el run no llegó al almacén
+  bool WriteOutputs(Totals &totals, const std::string &storePath);
+}
+
+#endif // RUNTOTALS_HH
@@ -0,0 +1,55 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef SHARDING_HH
+#define SHARDING_HH
+
+#include "globals.hh"
+
+/* Runs repartidos entre procesos o nodos (--shard i/N). Cada /run/beamOn n
+   simula solo los eventos [n*i/N, n*(i+1)/N) del run completo, con su
+   número de evento global: como la semilla de cada evento depende solo de
+   (semilla maestra, run, evento) (EventSeeder), la unión de los N fragmentos
+   son exactamente los eventos del run en un solo proceso. Cada fragmento
+   escribe sus sumas en un .gashard en vez de los resultados finales, y
+   gammaAtt-merge los fusiona (RunTotals). Solo lo toca el hilo maestro. */
+class Sharding
+{
+public:
+  // "i/N" con 0 <= i < N; false si no tiene ese formato
+  static G4bool Configure(const G4String &spec);
+  static G4bool IsActive() { return count > 0; }
+  static G4int GetIndex() { return index; }
+  static G4int GetCount() { return count; }
+
+  // Inicio de /run/beamOn con el total del run; devuelve los eventos de este fragmento
+  static G4int BeginBeamOn(G4int totalEvents);
+  static G4long GetFirstEvent() { return firstEvent; }
+  static G4int GetTotalEvents() { return totalEvents; } // Del run completo
+
+  // "_shard3of8" para los ficheros de este fragmento ("" sin fragmentos)
+  static G4String Suffix();
+
+private:
+  static G4int index;
+  static G4int count; // 0: sin fragmentos
+  static G4long firstEvent;
+  static G4int totalEvents;
+};
+
+/* El mismo reparto con cualquier gestor (secuencial, MT o por tareas):
+   BeamOn es el punto por el que pasan /run/beamOn, los barridos y
+   /run/beamToPrecision. Sin --shard no cambia nada. */
+template <class RunManager>
+class ShardedRunManager : public RunManager
+{
+public:
+  void BeamOn(G4int nEvents, const char *macroFile = nullptr, G4int nSelect = -1) override
+  {
+    RunManager::BeamOn(Sharding::BeginBeamOn(nEvents), macroFile, nSelect);
+  }
+};
+
+#endif // SHARDING_HH
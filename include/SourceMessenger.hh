@@ -0,0 +1,32 @@
+#ifndef SOURCEMESSENGER_HH
+#define SOURCEMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SourceSpectrum;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class SourceMessenger : public G4UImessenger {
+public:
+    SourceMessenger(SourceSpectrum* spectrum);
+    virtual ~SourceMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    SourceSpectrum* spectrum;
+
+    G4UIdirectory* sourceDir;
+    G4UIcmdWithAString* presetCmd;
+    G4UIcommand* addLineCmd;
+    G4UIcmdWithAString* linesFileCmd;
+    G4UIcmdWithAString* spectrumFileCmd;
+    G4UIcmdWithoutParameter* monoCmd;
+    G4UIcmdWithoutParameter* listCmd;
+};
+
+#endif // SOURCEMESSENGER_HH
@@ -0,0 +1,61 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef SOURCESPECTRUM_HH
+#define SOURCESPECTRUM_HH
+
+#include "globals.hh"
+#include <vector>
+
+/* Espectro de energía de la fuente. Dos variantes:
+   - líneas discretas (presets Cs137, Co60, Am241 o fichero E intensidad)
+   - espectro continuo tabulado (fichero E fluencia, interpolación lineal)
+   Ambas se muestrean con una tabla alias (Vose) precalculada, de modo que
+   el coste por evento es constante sea cual sea el número de líneas o de
+   puntos de la tabla. Sin espectro definido la energía es la de /gun/energy. */
+class SourceSpectrum
+{
+public:
+  enum class Type
+  {
+    Mono,
+    Lines,
+    Continuous
+  };
+
+  SourceSpectrum();
+
+  void Clear(); // Vuelve a Mono
+  void AddLine(G4double energy, G4double intensity);
+  G4bool SetPreset(const G4String &name);
+  G4bool LoadLines(const G4String &path);
+  G4bool LoadContinuous(const G4String &path);
+
+  Type GetType() const { return type; }
+  G4bool IsActive() const { return type != Type::Mono; }
+
+  // u1, u2 uniformes en [0,1): u1 elige la entrada, u2 la energía dentro del tramo
+  G4double Sample(G4double u1, G4double u2) const;
+
+  void Print() const;
+
+  // Etiqueta corta para la clave del almacén de resultados (vacía en modo Mono)
+  G4String Describe() const;
+
+private:
+  G4bool ReadTable(const G4String &path, std::vector<G4double> &energies,
+                   std::vector<G4double> &values) const;
+  void BuildAliasTable(const std::vector<G4double> &weights);
+
+  Type type;
+  std::vector<G4double> energies; // Líneas, o nodos de la tabla continua
+  std::vector<G4double> values;   // Intensidades, o fluencia en cada nodo
+
+  // Tabla alias: una entrada por línea o por tramo [E_i, E_i+1]
+  std::vector<G4double> aliasProb;
+  std::vector<G4int> aliasIndex;
+};
+
+#endif // SOURCESPECTRUM_HH
@@ -0,0 +1,28 @@
+#ifndef STACKINGACTION_HH
+#define STACKINGACTION_HH
+
+#include "G4UserStackingAction.hh"
+#include "G4EmCalculator.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class SteppingAction;
+
+/* En modo rápido descarta, al crearse, los electrones del absorbente cuyo
+   alcance es menor que /fast/electronRangeCut: no pueden salir del bloque
+   (salvo por bremsstrahlung, que se desprecia con este corte). */
+class StackingAction : public G4UserStackingAction
+{
+public:
+  StackingAction(const DetectorConstruction *detector, const SteppingAction *stepping);
+  ~StackingAction() override;
+
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track *track) override;
+
+private:
+  const DetectorConstruction *detector;
+  const SteppingAction *steppingAction; // Guarda la configuración del modo rápido
+  G4EmCalculator emCalculator;
+};
+
+#endif // STACKINGACTION_HH
@@ -0,0 +1,57 @@
+#ifndef STEPPINGACTION_HH
+#define STEPPINGACTION_HH
+
+#include "G4UserSteppingAction.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class FastTrackingMessenger;
+class RunAction;
+class MeshTally;
+class LayerTally;
+class G4Step;
+
+/* Modo rápido de solo transmisión (opcional, /fast/enable):
+   - en cuanto una partícula da un paso dentro de Detector el evento ya es
+     "transmitido" (el SD ya lo registró) y se aborta el resto del evento;
+   - con /fast/killEscaping (desactivado por defecto), las partículas en el
+     aire que se alejan del detector sin poder volver al absorbente ni
+     alcanzarlo se eliminan. Se desprecia la retrodispersión en el aire del
+     mundo, así que la transmisión puede cambiar ligeramente.
+   Los ajustes que pueden cambiar los recuentos se anotan en la lista de
+   física del almacén (GetFastTag), con su propia clave. */
+class SteppingAction : public G4UserSteppingAction
+{
+public:
+  SteppingAction(const DetectorConstruction *detector, RunAction *runAction = nullptr);
+  ~SteppingAction() override;
+
+  void UserSteppingAction(const G4Step *step) override;
+
+  void SetFastMode(G4bool value) { fastMode = value; }
+  void SetKillEscaping(G4bool value) { killEscaping = value; }
+  void SetElectronRangeCut(G4double value) { electronRangeCut = value; }
+
+  G4bool IsFastMode() const { return fastMode; }
+  G4double GetElectronRangeCut() const { return electronRangeCut; }
+
+  // Sufijo de la lista de física en el almacén ("" fuera del modo rápido)
+  G4String GetFastTag() const;
+
+private:
+  // ¿Puede esta partícula del aire llegar todavía al absorbente o al detector?
+  G4bool IsEscaping(const G4Step *step) const;
+  // Transmisión por capas: fotón que cruza la cara posterior de su capa
+  void ScoreLayerExit(const G4Step *step) const;
+
+  const DetectorConstruction *detector;
+  RunAction *runAction; // Cuenta de pasos por run (benchmarks)
+  MeshTally *meshTally; // Malla del absorbente de este hilo (/score/voxels)
+  LayerTally *layerTally; // Transmisión tras cada capa (/detector/addLayer, /detector/setSlabs)
+  G4bool fastMode;
+  G4bool killEscaping;
+  G4double electronRangeCut; // Lo aplica StackingAction dentro del absorbente
+  FastTrackingMessenger *messenger;
+};
+
+#endif // STEPPINGACTION_HH
@@ -0,0 +1,53 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef SWEEPMANAGER_HH
+#define SWEEPMANAGER_HH
+
+#include "globals.hh"
+#include <vector>
+
+class SweepMessenger;
+class PrecisionMonitor;
+
+/* Barrido material x espesor x energía dentro de un único proceso.
+   Cada punto se configura con los mismos comandos que usan las macros
+   (/detector/..., /gun/energy) y se lanza con BeamOn, de modo que el
+   núcleo, las tablas de física y ROOT se inicializan una sola vez.
+   Solo existe en el hilo maestro. */
+class SweepManager
+{
+public:
+  SweepManager(PrecisionMonitor *precision = nullptr);
+  ~SweepManager();
+
+  void SetMaterials(const std::vector<G4String> &list) { materials = list; }
+  void SetThicknesses(const std::vector<G4double> &list) { thicknesses = list; }
+  void SetEnergies(const std::vector<G4double> &list) { energies = list; }
+  void SetEventsPerPoint(G4int n) { eventsPerPoint = n; }
+  void SetOutputName(const G4String &name) { outputName = name; }
+  // > 0: cada punto usa /run/beamToPrecision con /sweep/events como máximo
+  void SetRelativePrecision(G4double relError) { relativePrecision = relError; }
+
+  // Recorre la malla completa (materiales > espesores > energías)
+  void Run();
+
+  G4bool IsRunning() const { return running; }
+  const G4String &GetOutputName() const { return outputName; }
+
+private:
+  std::vector<G4String> materials;
+  std::vector<G4double> thicknesses;
+  std::vector<G4double> energies;
+  G4int eventsPerPoint;
+  G4double relativePrecision;
+  G4String outputName;
+  G4bool running;
+
+  PrecisionMonitor *precisionMonitor;
+  SweepMessenger *messenger;
+};
+
+#endif // SWEEPMANAGER_HH
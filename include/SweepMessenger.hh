@@ -0,0 +1,38 @@
+#ifndef SWEEPMESSENGER_HH
+#define SWEEPMESSENGER_HH
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+#include <vector>
+
+class SweepManager;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithoutParameter;
+
+class SweepMessenger : public G4UImessenger {
+public:
+    SweepMessenger(SweepManager* sweep);
+    virtual ~SweepMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    // Convierte "0.5 1 2 cm" en valores internos de Geant4
+    std::vector<G4double> ParseValuesWithUnit(const G4String& list, const char* defaultUnit) const;
+
+    SweepManager* sweepManager;
+
+    G4UIdirectory* sweepDir;
+    G4UIcmdWithAString* materialsCmd;
+    G4UIcmdWithAString* thicknessesCmd;
+    G4UIcmdWithAString* energiesCmd;
+    G4UIcmdWithAnInteger* eventsCmd;
+    G4UIcmdWithADouble* precisionCmd;
+    G4UIcmdWithAString* outputCmd;
+    G4UIcmdWithoutParameter* runCmd;
+};
+
+#endif // SWEEPMESSENGER_HH
@@ -0,0 +1,122 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#ifndef VOXELPHANTOM_HH
+#define VOXELPHANTOM_HH
+
+#include "G4PhantomParameterisation.hh"
+#include "G4VVolumeMaterialScanner.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class G4Material;
+
+/* Maniquí de vóxeles leído de un fichero raw proyectado en memoria (mmap):
+   no se copia al heap ni se recorre al cargarlo, así que el tiempo de carga
+   y la memoria residente dependen solo de las páginas que tocan las
+   partículas. x varía más rápido, después y, después z (orden de los CT).
+   - HU: int16 con signo (little-endian). Cada valor se convierte en un
+     material con una tabla de 65536 entradas construida a partir de los
+     rangos de /phantom/huRange (los posteriores tienen prioridad).
+   - Índices: uint8, índice en la lista de /phantom/indexMaterials; los
+     índices fuera de la lista toman el último material. */
+class VoxelPhantom
+{
+public:
+  enum DataType
+  {
+    kHounsfield,
+    kMaterialIndex
+  };
+
+  VoxelPhantom();
+  ~VoxelPhantom();
+  VoxelPhantom(const VoxelPhantom &) = delete; // Dueño de la proyección
+  VoxelPhantom &operator=(const VoxelPhantom &) = delete;
+
+  // Proyecta el fichero; headerBytes se salta antes de los datos. false si no
+  // se puede, y entonces se conserva el fichero anterior
+  G4bool Open(const G4String &path, G4int nx, G4int ny, G4int nz, const G4ThreeVector &voxelSize,
+              DataType type, std::size_t headerBytes = 0);
+  void Close();
+  G4bool IsOpen() const { return data != nullptr; }
+
+  // Conversión a materiales (nombres de /detector/setMaterial o de la base NIST)
+  void AddHURange(G4int low, G4int high, const G4String &material); // [low, high)
+  void ResetHURanges(); // Rangos por defecto
+  void SetIndexMaterials(const std::vector<G4String> &names);
+  const std::vector<G4String> &GetMaterialNames() const
+  {
+    return type == kHounsfield ? huMaterials : indexMaterials;
+  }
+
+  // Posición del material del vóxel en GetMaterialNames(); solo toca la página de ese vóxel
+  std::size_t MaterialSlot(std::size_t copyNo) const
+  {
+    if (type == kHounsfield)
+    {
+      // memcpy: con una cabecera de tamaño impar el int16 no está alineado
+      std::uint16_t hu;
+      std::memcpy(&hu, data + copyNo * sizeof(hu), sizeof(hu));
+      return huTable[hu];
+    }
+    return std::min<std::size_t>(data[copyNo], indexMaterials.size() - 1);
+  }
+  std::size_t MaterialSlot(G4int ix, G4int iy, G4int iz) const
+  {
+    return MaterialSlot((static_cast<std::size_t>(iz) * ny + iy) * nx + ix);
+  }
+
+  G4int GetNx() const { return nx; }
+  G4int GetNy() const { return ny; }
+  G4int GetNz() const { return nz; }
+  std::size_t GetNumberOfVoxels() const { return static_cast<std::size_t>(nx) * ny * nz; }
+  const G4ThreeVector &GetVoxelSize() const { return voxelSize; }
+  G4ThreeVector GetHalfSize() const { return G4ThreeVector(nx * voxelSize.x(), ny * voxelSize.y(), nz * voxelSize.z()) / 2.; }
+  const G4String &GetPath() const { return path; }
+
+private:
+  G4int SlotOf(const G4String &material); // Añade el material a huMaterials si no estaba
+
+  G4String path;
+  G4int nx, ny, nz;
+  G4ThreeVector voxelSize;
+  DataType type;
+  void *mapping;             // Fichero completo proyectado (para munmap)
+  std::size_t mappingSize;
+  const std::uint8_t *data;  // Primer vóxel, tras la cabecera
+  std::vector<std::uint8_t> huTable; // HU (como uint16) -> posición en huMaterials
+  std::vector<G4String> huMaterials;
+  std::vector<G4String> indexMaterials;
+};
+
+/* Parametrización regular sobre el maniquí proyectado. G4PhantomParameterisation
+   necesitaría un array de índices size_t por vóxel (8 bytes x 512x512xN); aquí
+   el material se lee directamente del fichero en ComputeMaterial, que es lo
+   que consultan G4RegularNavigation y el resto del núcleo. La lista de
+   materiales se da como G4VVolumeMaterialScanner para que la búsqueda de
+   materiales de las regiones no recorra todos los vóxeles. */
+class PhantomParameterisation : public G4PhantomParameterisation, public G4VVolumeMaterialScanner
+{
+public:
+  PhantomParameterisation(const VoxelPhantom *phantom, const std::vector<G4Material *> &materials);
+
+  G4Material *ComputeMaterial(const G4int copyNo, G4VPhysicalVolume *physVol,
+                              const G4VTouchable *parentTouch = nullptr) override;
+
+  G4VVolumeMaterialScanner *GetMaterialScanner() override { return this; }
+  G4int GetNumberOfMaterials() const override { return static_cast<G4int>(slotMaterials.size()); }
+  G4Material *GetMaterial(G4int idx) const override { return slotMaterials[idx]; }
+
+private:
+  const VoxelPhantom *phantom;
+  std::vector<G4Material *> slotMaterials; // Mismo orden que phantom->GetMaterialNames()
+};
+
+#endif // VOXELPHANTOM_HH
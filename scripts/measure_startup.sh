@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Mide el tiempo de arranque y la memoria máxima (RSS) de gammaAtt y
+# gammaAtt_batch con la misma macro mínima (inicialización + tablas de física).
+# Uso: ./scripts/measure_startup.sh [repeticiones]   (desde la raíz del proyecto)
+
+REPEATS=${1:-5}
+BUILD_DIR="build"
+MACRO="../mac/startup.mac"
+
+if [ ! -x /usr/bin/time ]; then
+    echo "Error: se necesita /usr/bin/time (paquete 'time')"
+    exit 1
+fi
+
+echo "=== Arranque: tiempo real y RSS máximo ($REPEATS repeticiones) ==="
+printf "%-16s %12s %12s\n" "binario" "tiempo (s)" "RSS (MB)"
+
+for BIN in gammaAtt gammaAtt_batch; do
+    if [ ! -x "$BUILD_DIR/$BIN" ]; then
+        printf "%-16s %12s %12s\n" "$BIN" "-" "-"
+        continue
+    fi
+
+    TOTAL_TIME=0
+    MAX_RSS=0
+    for ((i = 1; i <= REPEATS; i++)); do
+        # %e: segundos de tiempo real, %M: RSS máximo en KB
+        RESULT=$(cd "$BUILD_DIR" && /usr/bin/time -f "%e %M" ./$BIN "$MACRO" 2>&1 >/dev/null | tail -1)
+        T=$(echo "$RESULT" | awk '{print $1}')
+        M=$(echo "$RESULT" | awk '{print $2}')
+        TOTAL_TIME=$(echo "$TOTAL_TIME + $T" | bc -l)
+        if [ "$M" -gt "$MAX_RSS" ]; then
+            MAX_RSS=$M
+        fi
+    done
+
+    MEAN_TIME=$(echo "$TOTAL_TIME / $REPEATS" | bc -l)
+    printf "%-16s %12.3f %12.1f\n" "$BIN" "$MEAN_TIME" "$(echo "$MAX_RSS / 1024" | bc -l)"
+done
@@ -7,7 +7,7 @@ echo "=== Análisis Multi-Energía: Agua ==="
 echo "Ejecutando análisis de coeficientes de atenuación..."
 
 # Verificar que estamos en el directorio correcto
-if [ ! -f "analysis/multi_energy_analysis.C" ]; then
+if [ ! -f "analysis/plot_multi_energy.py" ]; then
     echo "Error: No se encuentra el archivo de análisis"
     echo "Ejecute desde el directorio raíz del proyecto GammaAtenuation"
     exit 1
@@ -16,16 +16,19 @@ fi
 # Crear directorio de resultados
 mkdir -p results/multi_energy
 
-# Compilar y ejecutar el análisis C++
-echo "Compilando análisis de agua..."
-g++ -o analysis/multi_energy_analysis analysis/multi_energy_analysis.C
-if [ $? -ne 0 ]; then
-    echo "Error en compilación"
+# Coeficientes GEANT4 calculados por gammaAtt en modo analítico (sin transporte)
+if [ ! -x "build/gammaAtt" ]; then
+    echo "ERROR: build/gammaAtt no encontrado"
+    echo "Ejecuta: cd build && make"
     exit 1
 fi
+echo "Calculando mu/rho con las secciones eficaces de GEANT4..."
+(cd build && ./gammaAtt ../mac/analytic_water.mac)
 
-echo "Ejecutando análisis de datos..."
-./analysis/multi_energy_analysis
+# Puntos Monte Carlo a varias energías que haya en el almacén (energy_mc.csv)
+if [ -x "build/gammaAtt-analyze" ] && [ -f "results/store.tsv" ]; then
+    build/gammaAtt-analyze results --quiet
+fi
 
 # Verificar que se generó el archivo CSV
 if [ ! -f "results/multi_energy/energy_spectrum_comparison.csv" ]; then
@@ -46,7 +49,5 @@ echo "Resultados en: results/multi_energy/"
 echo "Archivos generados:"
 echo "   - energy_spectrum_comparison.csv"
 echo "   - energy_spectrum_analysis.png"
+echo "   - energy_mc.csv (si hay runs Monte Carlo)"
 echo "   - nist_style_comparison.png"
-
-# Limpiar archivo ejecutable
-rm -f analysis/multi_energy_analysis
\ No newline at end of file
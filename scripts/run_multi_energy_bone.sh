@@ -7,7 +7,7 @@ echo "=== Análisis Multi-Energía: Hueso Compacto ==="
 echo "Ejecutando análisis de coeficientes de atenuación..."
 
 # Verificar que estamos en el directorio correcto
-if [ ! -f "analysis/multi_energy_bone_analysis.C" ]; then
+if [ ! -f "analysis/plot_multi_energy_bone.py" ]; then
     echo "Error: No se encuentra el archivo de análisis"
     echo "Ejecute desde el directorio raíz del proyecto GammaAtenuation"
     exit 1
@@ -16,16 +16,19 @@ fi
 # Crear directorio de resultados
 mkdir -p results/multi_energy
 
-# Compilar y ejecutar el análisis C++
-echo "Compilando análisis de hueso..."
-g++ -o analysis/multi_energy_bone_analysis analysis/multi_energy_bone_analysis.C
-if [ $? -ne 0 ]; then
-    echo "Error en compilación"
+# Coeficientes GEANT4 calculados por gammaAtt en modo analítico (sin transporte)
+if [ ! -x "build/gammaAtt" ]; then
+    echo "ERROR: build/gammaAtt no encontrado"
+    echo "Ejecuta: cd build && make"
     exit 1
 fi
+echo "Calculando mu/rho con las secciones eficaces de GEANT4..."
+(cd build && ./gammaAtt ../mac/analytic_bone.mac)
 
-echo "Ejecutando análisis de datos..."
-./analysis/multi_energy_bone_analysis
+# Puntos Monte Carlo a varias energías que haya en el almacén (energy_mc_bone.csv)
+if [ -x "build/gammaAtt-analyze" ] && [ -f "results/store.tsv" ]; then
+    build/gammaAtt-analyze results --quiet
+fi
 
 # Verificar que se generó el archivo CSV
 if [ ! -f "results/multi_energy/energy_spectrum_bone_comparison.csv" ]; then
@@ -45,9 +48,7 @@ echo "Análisis multi-energía para hueso compacto completado!"
 echo "Resultados en: results/multi_energy/"
 echo "Archivos generados:"
 echo "   - energy_spectrum_bone_comparison.csv"
+echo "   - energy_mc_bone.csv (si hay runs Monte Carlo)"
 echo "   - multi_energy_bone_analysis.png"
 echo "   - multi_energy_bone_analysis.pdf"
 echo "   - multi_energy_bone_analysis.svg"
-
-# Limpiar archivo ejecutable
-rm -f analysis/multi_energy_bone_analysis
\ No newline at end of file
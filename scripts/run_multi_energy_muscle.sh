@@ -7,7 +7,7 @@ echo "=== Análisis Multi-Energía: Músculo Esquelético ==="
 echo "Ejecutando análisis de coeficientes de atenuación..."
 
 # Verificar que estamos en el directorio correcto
-if [ ! -f "analysis/multi_energy_muscle_analysis.C" ]; then
+if [ ! -f "analysis/plot_multi_energy_muscle.py" ]; then
     echo "Error: No se encuentra el archivo de análisis"
     echo "Ejecute desde el directorio raíz del proyecto GammaAtenuation"
     exit 1
@@ -16,16 +16,19 @@ fi
 # Crear directorio de resultados
 mkdir -p results/multi_energy
 
-# Compilar y ejecutar el análisis C++
-echo "Compilando análisis de músculo..."
-g++ -o analysis/multi_energy_muscle_analysis analysis/multi_energy_muscle_analysis.C
-if [ $? -ne 0 ]; then
-    echo "Error en compilación"
+# Coeficientes GEANT4 calculados por gammaAtt en modo analítico (sin transporte)
+if [ ! -x "build/gammaAtt" ]; then
+    echo "ERROR: build/gammaAtt no encontrado"
+    echo "Ejecuta: cd build && make"
     exit 1
 fi
+echo "Calculando mu/rho con las secciones eficaces de GEANT4..."
+(cd build && ./gammaAtt ../mac/analytic_muscle.mac)
 
-echo "Ejecutando análisis de datos..."
-./analysis/multi_energy_muscle_analysis
+# Puntos Monte Carlo a varias energías que haya en el almacén (energy_mc_muscle.csv)
+if [ -x "build/gammaAtt-analyze" ] && [ -f "results/store.tsv" ]; then
+    build/gammaAtt-analyze results --quiet
+fi
 
 # Verificar que se generó el archivo CSV
 if [ ! -f "results/multi_energy/energy_spectrum_muscle_comparison.csv" ]; then
@@ -46,7 +49,5 @@ echo "Resultados en: results/multi_energy/"
 echo "Archivos generados:"
 echo "   - energy_spectrum_muscle_comparison.csv"
 echo "   - energy_spectrum_muscle_analysis.png"
+echo "   - energy_mc_muscle.csv (si hay runs Monte Carlo)"
 echo "   - nist_style_muscle_comparison.png"
-
-# Limpiar archivo ejecutable
-rm -f analysis/multi_energy_muscle_analysis
\ No newline at end of file
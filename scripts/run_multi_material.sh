@@ -2,7 +2,7 @@
 
 # Script Multi-Material
 # Comparación de atenuación entre agua, músculo y hueso
-# Ejecuta análisis ROOT + visualización Python
+# Ejecuta el análisis compilado (gammaAtt-analyze) + visualización Python
 
 echo "========================================"
 echo "  ANÁLISIS MULTI-MATERIAL"
@@ -12,51 +12,40 @@ echo "Espesor: 5.0 cm fijo"
 echo "Análisis: Comparación propiedades"
 echo ""
 
-# Verificar que ROOT esté disponible
-if ! command -v root &> /dev/null; then
-    echo "ERROR: ROOT no está instalado"
-    exit 1
-fi
-
 # Verificar que Python esté disponible
 if ! command -v python3 &> /dev/null; then
     echo "ERROR: Python3 no está disponible"
     exit 1
 fi
 
-# Crear directorio de resultados
-mkdir -p /home/isabel/Physiscs_projects/GammaAtenuation/results/multi_material
-
 # Ir al directorio principal
-cd /home/isabel/Physiscs_projects/GammaAtenuation
+cd "$(dirname "$0")/.." || exit 1
+mkdir -p results/multi_material
 
 echo "Paso 1: Generando datos de simulación multi-material..."
 echo "------------------------------------------------------"
 
 # Verificar que el ejecutable GEANT4 existe
-if [ ! -f "/home/isabel/Physiscs_projects/GammaAtenuation/build/gammaAtt" ]; then
-    echo "ERROR: Ejecutable GEANT4 no encontrado en /home/isabel/Physiscs_projects/GammaAtenuation/build/gammaAtt"
+if [ ! -f "build/gammaAtt" ]; then
+    echo "ERROR: Ejecutable GEANT4 no encontrado en build/gammaAtt"
     echo "Ejecuta: cd build && make"
     exit 1
 fi
 
 # Materiales a simular (espesor fijo 5.0 cm)
-declare -A MATERIALS
-MATERIALS["water"]="G4_WATER"
-MATERIALS["muscle"]="G4_MUSCLE_SKELETAL_ICRP"
-MATERIALS["bone"]="G4_BONE_COMPACT_ICRU"
+MATERIALS=(water muscle bone)
 
 THICKNESS="5.0"
 
 echo "Ejecutando simulaciones para ${#MATERIALS[@]} materiales (espesor ${THICKNESS} cm)..."
 
-for material in "${!MATERIALS[@]}"; do
-    MAC_FILE="/home/isabel/Physiscs_projects/GammaAtenuation/mac/material_${material}_${THICKNESS}cm.mac"
-    DATA_FILE="../results/data_${material}_${THICKNESS}cm.root"
-    
-    # Verificar si ya existe el archivo de datos
-    if [ -f "$DATA_FILE" ]; then
-        echo "  Material ${material}: datos existentes (saltando)"
+for material in "${MATERIALS[@]}"; do
+    MAC_FILE="mac/material_${material}_${THICKNESS}cm.mac"
+
+    # Saltar los materiales que ya están completos en el almacén de resultados
+    if build/gammaAtt-results --store results/store.tsv count --material "${material}" \
+        --thickness "${THICKNESS}" --min-events 100000 > /dev/null 2>&1; then
+        echo "  Material ${material}: ya en results/store.tsv (saltando)"
         continue
     fi
     
@@ -81,30 +70,25 @@ for material in "${!MATERIALS[@]}"; do
 EOF
     
     echo "  Simulando material ${material} (100k eventos)..."
-    cd /home/isabel/Physiscs_projects/GammaAtenuation/build
-    ./gammaAtt "$MAC_FILE"
-    
-    # Mover archivo de datos generado al directorio results
-        if [ -f "/home/isabel/Physiscs_projects/GammaAtenuation/results/data_run_${material}.root" ]; then
-            mv /home/isabel/Physiscs_projects/GammaAtenuation/results/data_run_${material}.root /home/isabel/Physiscs_projects/GammaAtenuation/results/material_${material}_5cm.root
-            echo "Archivo movido: material_${material}_5cm.root"
-        else
-            echo "WARNING: No se generó archivo de datos para material ${material}"
-        fi
-    cd ../scripts
+    (cd build && ./gammaAtt "../$MAC_FILE")
+
+    # El run queda registrado en el almacén: no hay ficheros que renombrar
+    if ! build/gammaAtt-results --store results/store.tsv count --material "${material}" \
+        --thickness "${THICKNESS}" > /dev/null 2>&1; then
+        echo "WARNING: el run de ${material} no quedó registrado en results/store.tsv"
+    fi
 done
 
 echo "Simulaciones multi-material completadas"
 echo ""
 
-echo "Paso 2: Ejecutando análisis ROOT..."
+echo "Paso 2: Ejecutando análisis..."
 echo "-----------------------------------"
 
-# Ejecutar análisis ROOT
-cd /home/isabel/Physiscs_projects/GammaAtenuation
-root -l -b -q "analysis/multi_material_analysis.C"
+# Un único análisis para todo el almacén: ajuste ponderado y bootstrap por material/energía
+build/gammaAtt-analyze results || exit 1
 
-echo "Análisis ROOT completado"
+echo "Análisis completado"
 echo ""
 
 echo "=========================================="
@@ -112,7 +96,7 @@ echo "  ANÁLISIS MULTI-MATERIAL COMPLETADO"
 echo "=========================================="
 echo ""
 echo "Datos generados en:"
-echo "  /home/isabel/Physiscs_projects/GammaAtenuation/results/multi_material/"
+echo "  results/multi_material/"
 echo ""
 echo "Para generar las gráficas, ejecuta:"
 echo "  source GA/bin/activate"
@@ -2,7 +2,7 @@
 
 # Script Multi-Espesor
 # Análisis de atenuación gamma vs espesor para agua
-# Ejecuta análisif [ ! -f "/home/isabel/Physiscs_projects/GammaAtenuation/results/multi_thickness/thickness_analysis_data.csv" ]; thens ROOT + visualización Python
+# Ejecuta el análisis compilado (gammaAtt-analyze) + visualización Python
 
 echo "========================================"
 echo "  ANÁLISIS MULTI-ESPESOR"
@@ -12,12 +12,6 @@ echo "Análisis: Ley Beer-Lambert vs espesor"
 echo "Rango: 0.5 - 15.0 cm"
 echo ""
 
-# Verificar que ROOT esté disponible
-if ! command -v root &> /dev/null; then
-    echo "ERROR: ROOT no está instalado"
-    exit 1
-fi
-
 # Verificar que Python esté disponible
 if ! command -v python3 &> /dev/null; then
     echo "ERROR: Python3 no está disponible"
@@ -45,11 +39,10 @@ echo "Ejecutando simulaciones GEANT4 para ${#THICKNESS_VALUES[@]} espesores..."
 
 for thickness in "${THICKNESS_VALUES[@]}"; do
     MAC_FILE="../mac/thickness_water_${thickness}.mac"
-    DATA_FILE="../results/data_thickness_water_${thickness}.root"
     
-    # Verificar si ya existe el archivo de datos
-    if [ -f "$DATA_FILE" ]; then
-        echo "  Espesor ${thickness} cm: datos existentes (saltando)"
+    # Saltar los puntos que ya están completos en el almacén de resultados
+    if ../build/gammaAtt-results count --material G4_WATER --thickness "$thickness" --min-events 100000 > /dev/null 2>&1; then
+        echo "  Espesor ${thickness} cm: ya en results/store.tsv (saltando)"
         continue
     fi
     
@@ -79,12 +72,11 @@ EOF
     cd ../build
     ./gammaAtt "$MAC_FILE" > /dev/null 2>&1
     
-    # Mover archivo de datos generado al directorio results
-    if [ -f "../results/data_run_water.root" ]; then
-        mv "../results/data_run_water.root" "$DATA_FILE"
-        echo "    Completado: $DATA_FILE"
+    # El run queda registrado en el almacén: no hay ficheros que renombrar
+    if ./gammaAtt-results count --material G4_WATER --thickness "$thickness" --min-events 100000 > /dev/null 2>&1; then
+        echo "    Completado"
     else
-        echo "    WARNING: No se generó archivo de datos"
+        echo "    WARNING: el run no quedó registrado en results/store.tsv"
     fi
     
     cd ../scripts
@@ -93,14 +85,14 @@ done
 echo "Simulaciones completadas"
 echo ""
 
-echo "Paso 2: Ejecutando análisis ROOT..."
+echo "Paso 2: Ejecutando análisis..."
 echo "-----------------------------------"
 
-# Ejecutar análisis ROOT
-cd /home/isabel/Physiscs_projects/GammaAtenuation
-root -l -b -q "analysis/multi_thickness_analysis.C"
+# Un único análisis para todo el almacén: ajuste ponderado y bootstrap por material/energía
+cd .. || exit 1 # analysis/ o scripts/ -> raíz del proyecto
+build/gammaAtt-analyze results || exit 1
 
-echo "Análisis ROOT completado, genere las gráficas con python analysis/plot_multi_thickness.py"
+echo "Análisis completado, genere las gráficas con python analysis/plot_multi_thickness.py"
 echo ""
 
 echo "=========================================="
@@ -108,7 +100,7 @@ echo "  ANÁLISIS MULTI-ESPESOR COMPLETADO"
 echo "=========================================="
 echo ""
 echo "Datos generados en:"
-echo "  /home/isabel/Physiscs_projects/GammaAtenuation/results/multi_thickness/"
+echo "  results/multi_thickness/"
 echo ""
 echo "Para generar las gráficas, ejecuta:"
 echo "  source GA/bin/activate"
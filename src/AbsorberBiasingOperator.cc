@@ -0,0 +1,93 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "AbsorberBiasingOperator.hh"
+#include "DetectorConstruction.hh"
+#include "G4BiasingProcessInterface.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4Gamma.hh"
+#include "G4ProcessManager.hh"
+#include "G4VProcess.hh"
+#include "G4Track.hh"
+#include "G4ios.hh"
+#include <cfloat>
+
+AbsorberBiasingOperator::AbsorberBiasingOperator(const DetectorConstruction *det)
+    : G4VBiasingOperator("AbsorberExpTransform"), detector(det), gamma(nullptr), stretch(0.)
+{
+}
+
+AbsorberBiasingOperator::~AbsorberBiasingOperator()
+{
+  for (auto &entry : operations)
+    delete entry.second;
+}
+
+void AbsorberBiasingOperator::StartRun()
+{
+  // Una operación por proceso envuelto (phot, compt, conv, Rayl), creada una vez
+  if (!gamma)
+  {
+    gamma = G4Gamma::Definition();
+    auto sharedData = G4BiasingProcessInterface::GetSharedData(gamma->GetProcessManager());
+    if (sharedData)
+    {
+      for (auto wrapper : sharedData->GetPhysicsBiasingProcessInterfaces())
+        operations[wrapper] = new G4BOptnChangeCrossSection("XSchange-" + wrapper->GetWrappedProcess()->GetProcessName());
+    }
+  }
+
+  // El valor puede cambiar entre runs desde la macro
+  stretch = detector->GetExpTransform();
+}
+
+G4VBiasingOperation *AbsorberBiasingOperator::ProposeOccurenceBiasingOperation(
+    const G4Track *track, const G4BiasingProcessInterface *callingProcess)
+{
+  if (stretch <= 0. || track->GetDefinition() != gamma)
+    return nullptr;
+
+  G4double analogLength = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+  if (analogLength > DBL_MAX / 10.)
+    return nullptr;
+
+  auto it = operations.find(callingProcess);
+  if (it == operations.end())
+    return nullptr;
+  G4BOptnChangeCrossSection *operation = it->second;
+
+  // sigma' > 0 siempre que p < 1
+  G4double analogXS = 1. / analogLength;
+  G4double biasedXS = analogXS * (1. - stretch * track->GetMomentumDirection().z());
+
+  G4VBiasingOperation *previous = callingProcess->GetPreviousOccurenceBiasingOperation();
+  if (previous == nullptr || operation->GetInteractionOccured())
+  {
+    // Nuevo recorrido libre muestreado con la sección eficaz sesgada
+    operation->SetBiasedCrossSection(biasedXS);
+    operation->Sample();
+  }
+  else
+  {
+    // Se conserva el recorrido pendiente y se actualiza sigma' (el material
+    // o la dirección pueden haber cambiado desde el último paso)
+    operation->UpdateForStep(callingProcess->GetPreviousStepSize());
+    operation->SetBiasedCrossSection(biasedXS);
+    operation->UpdateForStep(0.);
+  }
+
+  return operation;
+}
+
+void AbsorberBiasingOperator::OperationApplied(const G4BiasingProcessInterface *callingProcess,
+                                               G4BiasingAppliedCase,
+                                               G4VBiasingOperation *occurenceOperationApplied, G4double,
+                                               G4VBiasingOperation *, const G4VParticleChange *)
+{
+  auto it = operations.find(callingProcess);
+  if (it != operations.end() && it->second == occurenceOperationApplied)
+    it->second->SetInteractionOccured();
+}
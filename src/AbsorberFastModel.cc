@@ -0,0 +1,319 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "AbsorberFastModel.hh"
+#include "AnalyticEngine.hh"
+#include "DetectorConstruction.hh"
+#include "MeshTally.hh"
+#include "RunAction.hh"
+#include "G4EmCalculator.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Gamma.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4RandomDirection.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+#include "G4VSolid.hh"
+#include "G4Exp.hh"
+#include "G4Log.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+  // Malla logarítmica: 200 puntos por década dan un error de interpolación
+  // muy por debajo del estadístico incluso junto a los bordes de absorción
+  const G4double kMinEnergy = 1. * keV;
+  const G4int kDecades = 5; // Hasta 100 MeV
+  const G4int kPointsPerDecade = 200;
+  const std::size_t kPoints = kDecades * kPointsPerDecade + 1;
+  const G4double kLogStep = std::log(10.) / kPointsPerDecade;
+
+  // Los fotones que salen se dejan justo fuera de la superficie, para que el
+  // navegador los localice en el volumen siguiente y no vuelvan a disparar el modelo
+  const G4double kExitPush = 1. * nanometer;
+}
+
+AbsorberFastModel::AbsorberFastModel(const G4String &name, G4Region *envelope, const DetectorConstruction *det)
+    : G4VFastSimulationModel(name, envelope), detector(det), lastMaterial(nullptr), lastTable(nullptr),
+      rayleighPhoton(G4Gamma::Gamma(), G4ThreeVector(0., 0., 1.), 0.)
+{
+}
+
+G4bool AbsorberFastModel::IsApplicable(const G4ParticleDefinition &particle)
+{
+  return &particle == G4Gamma::Definition();
+}
+
+G4bool AbsorberFastModel::ModelTrigger(const G4FastTrack &)
+{
+  // Activado y con absorbente homogéneo y analógico
+  if (!detector->UsesFastSimModel())
+    return false;
+
+  // La malla de dosis y fluencia necesita los pasos dentro del absorbente
+  auto runAction = static_cast<const RunAction *>(G4RunManager::GetRunManager()->GetUserRunAction());
+  return !(runAction && runAction->GetMeshTally()->IsActive());
+}
+
+void AbsorberFastModel::DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep)
+{
+  const G4Track *track = fastTrack.GetPrimaryTrack();
+  const MaterialTable &table = GetTable(fastTrack.GetEnvelopeLogicalVolume()->GetMaterial());
+
+  Photon primary{fastTrack.GetPrimaryTrackLocalPosition(), fastTrack.GetPrimaryTrackLocalDirection(),
+                 track->GetKineticEnergy(), 0.};
+  std::vector<Photon> pending; // Fotones de aniquilación aún por recorrer
+  G4double deposit = 0.;
+  G4bool primaryExits = Transport(fastTrack, table, primary, pending, deposit);
+
+  std::vector<Photon> exiting;
+  while (!pending.empty())
+  {
+    Photon photon = pending.back();
+    pending.pop_back();
+    if (Transport(fastTrack, table, photon, pending, deposit))
+      exiting.push_back(photon);
+  }
+
+  G4double time = track->GetGlobalTime();
+  if (primaryExits)
+  {
+    fastStep.ProposePrimaryTrackFinalPosition(primary.position + kExitPush * primary.direction);
+    fastStep.ProposePrimaryTrackFinalMomentumDirection(primary.direction);
+    fastStep.ProposePrimaryTrackFinalKineticEnergy(primary.energy);
+  }
+  else
+  {
+    fastStep.ProposePrimaryTrackFinalPosition(primary.position);
+    fastStep.KillPrimaryTrack();
+  }
+  fastStep.ProposePrimaryTrackFinalTime(time + primary.path / c_light);
+  fastStep.ProposePrimaryTrackPathLength(primary.path);
+  fastStep.ProposeTotalEnergyDeposited(deposit);
+
+  if (exiting.empty())
+    return;
+  fastStep.SetNumberOfSecondaryTracks(static_cast<G4int>(exiting.size()));
+  for (const Photon &photon : exiting)
+  {
+    G4DynamicParticle particle(G4Gamma::Gamma(), photon.direction, photon.energy);
+    G4Track *secondary = fastStep.CreateSecondaryTrack(particle, photon.position + kExitPush * photon.direction,
+                                                       time + photon.path / c_light);
+    secondary->SetWeight(track->GetWeight());
+  }
+}
+
+G4bool AbsorberFastModel::Transport(const G4FastTrack &fastTrack, const MaterialTable &table, Photon &photon,
+                                    std::vector<Photon> &pending, G4double &deposit)
+{
+  const G4VSolid *solid = fastTrack.GetEnvelopeSolid();
+  G4double mu[kNumberOfChannels];
+  while (true)
+  {
+    // Por debajo de la malla el fotón se absorbe donde está (fotoeléctrico)
+    if (photon.energy < kMinEnergy)
+    {
+      deposit += photon.energy;
+      return false;
+    }
+
+    std::size_t bin = 0;
+    G4double total = Coefficients(table, photon.energy, mu, bin);
+    G4double toExit = solid->DistanceToOut(photon.position, photon.direction);
+    G4double distance = (total > 0.) ? -G4Log(G4UniformRand()) / total : DBL_MAX;
+    if (distance >= toExit)
+    {
+      photon.position += toExit * photon.direction;
+      photon.path += toExit;
+      return true;
+    }
+    photon.position += distance * photon.direction;
+    photon.path += distance;
+
+    G4double pick = G4UniformRand() * total;
+    if ((pick -= mu[kPhotoelectric]) < 0.)
+    {
+      deposit += photon.energy;
+      return false;
+    }
+    if ((pick -= mu[kCompton]) < 0.)
+    {
+      G4double scattered = SampleCompton(photon.energy, photon.direction);
+      deposit += photon.energy - scattered; // Electrón de retroceso
+      photon.energy = scattered;
+      continue;
+    }
+    if ((pick -= mu[kRayleigh]) < 0.)
+    {
+      SampleRayleigh(table, bin, photon.energy, photon.direction);
+      continue;
+    }
+
+    // Producción de pares: el par deposita su energía cinética y el
+    // positrón se aniquila en reposo en el mismo punto
+    deposit += photon.energy - 2. * electron_mass_c2;
+    G4ThreeVector direction = G4RandomDirection();
+    pending.push_back({photon.position, direction, electron_mass_c2, photon.path});
+    pending.push_back({photon.position, -direction, electron_mass_c2, photon.path});
+    return false;
+  }
+}
+
+/* Klein-Nishina con el muestreo de G4KleinNishinaCompton (Butcher y Messel),
+   el modelo de Compton de G4EmStandardPhysics. Devuelve la energía del fotón
+   dispersado y gira su dirección. */
+G4double AbsorberFastModel::SampleCompton(G4double energy, G4ThreeVector &direction) const
+{
+  G4double e0m = energy / electron_mass_c2;
+  G4double eps0 = 1. / (1. + 2. * e0m);
+  G4double eps0sq = eps0 * eps0;
+  G4double alpha1 = -G4Log(eps0);
+  G4double alpha2 = alpha1 + 0.5 * (1. - eps0sq);
+
+  G4double epsilon, epsilonsq, onecost, sint2, greject;
+  do
+  {
+    if (alpha1 > alpha2 * G4UniformRand())
+    {
+      epsilon = G4Exp(-alpha1 * G4UniformRand());
+      epsilonsq = epsilon * epsilon;
+    }
+    else
+    {
+      epsilonsq = eps0sq + (1. - eps0sq) * G4UniformRand();
+      epsilon = std::sqrt(epsilonsq);
+    }
+    onecost = (1. - epsilon) / (epsilon * e0m);
+    sint2 = onecost * (2. - onecost);
+    greject = 1. - epsilon * sint2 / (1. + epsilonsq);
+  } while (greject < G4UniformRand());
+
+  G4double sint = std::sqrt(std::max(0., sint2));
+  G4double phi = twopi * G4UniformRand();
+  G4ThreeVector scattered(sint * std::cos(phi), sint * std::sin(phi), 1. - onecost);
+  scattered.rotateUz(direction);
+  direction = scattered;
+  return epsilon * energy;
+}
+
+/* Rayleigh: el elemento se elige con su fracción de la sección eficaz y el
+   ángulo con el generador de G4LivermoreRayleighModel (ajuste de los factores
+   de forma, sin ficheros de datos) */
+void AbsorberFastModel::SampleRayleigh(const MaterialTable &table, std::size_t bin, G4double energy,
+                                       G4ThreeVector &direction)
+{
+  const std::vector<G4double> &cumulative = table.rayleighElement[bin];
+  std::size_t element = std::lower_bound(cumulative.begin(), cumulative.end(), G4UniformRand()) - cumulative.begin();
+  element = std::min(element, table.elements.size() - 1);
+
+  rayleighPhoton.SetKineticEnergy(energy);
+  rayleighPhoton.SetMomentumDirection(direction);
+  direction = rayleighGenerator.SampleDirection(&rayleighPhoton, energy, table.elements[element]->GetZasInt());
+}
+
+G4double AbsorberFastModel::Coefficients(const MaterialTable &table, G4double energy, G4double mu[],
+                                         std::size_t &bin) const
+{
+  G4double x = G4Log(energy / kMinEnergy) / kLogStep;
+  bin = std::min(static_cast<std::size_t>(std::max(x, 0.)), kPoints - 2);
+  G4double f = std::min(std::max(x - bin, 0.), 1.);
+
+  G4double total = 0.;
+  for (G4int c = 0; c < kNumberOfChannels; ++c)
+  {
+    G4double low = table.mu[c][bin];
+    G4double high = table.mu[c][bin + 1];
+    // Log-log entre puntos (exacto para tramos de ley de potencias); lineal
+    // si alguno es cero (umbral de pares)
+    mu[c] = (low > 0. && high > 0.)
+                ? G4Exp(table.logMu[c][bin] + f * (table.logMu[c][bin + 1] - table.logMu[c][bin]))
+                : low + f * (high - low);
+    total += mu[c];
+  }
+  return total;
+}
+
+const AbsorberFastModel::MaterialTable &AbsorberFastModel::GetTable(const G4Material *material)
+{
+  if (material == lastMaterial)
+    return *lastTable;
+
+  auto it = tables.find(material);
+  if (it == tables.end())
+  {
+    it = tables.emplace(material, MaterialTable()).first;
+    BuildTable(material, it->second);
+  }
+  lastMaterial = material;
+  lastTable = &it->second;
+  return *lastTable;
+}
+
+void AbsorberFastModel::BuildTable(const G4Material *material, MaterialTable &table) const
+{
+  G4EmCalculator calculator;
+  const G4ParticleDefinition *gamma = G4Gamma::Definition();
+
+  for (G4int c = 0; c < kNumberOfChannels; ++c)
+  {
+    table.mu[c].assign(kPoints, 0.);
+    table.logMu[c].assign(kPoints, 0.);
+  }
+  const G4ElementVector *elements = material->GetElementVector();
+  const G4double *atomDensity = material->GetVecNbOfAtomsPerVolume();
+  table.elements.assign(elements->begin(), elements->end());
+  table.rayleighElement.assign(kPoints, std::vector<G4double>(elements->size(), 1.));
+
+  // Cada proceso de PhysicsList en su canal; uno desconocido absorbe el fotón
+  std::vector<G4String> processes = AnalyticEngine::PhotonProcesses();
+  std::vector<G4int> channels;
+  G4bool hasRayleigh = false;
+  for (const auto &name : processes)
+  {
+    if (name == "compt")
+      channels.push_back(kCompton);
+    else if (name == "Rayl")
+      channels.push_back(kRayleigh);
+    else if (name == "conv")
+      channels.push_back(kConversion);
+    else
+      channels.push_back(kPhotoelectric);
+    hasRayleigh = hasRayleigh || name == "Rayl";
+  }
+
+  for (std::size_t i = 0; i < kPoints; ++i)
+  {
+    G4double energy = kMinEnergy * std::exp(i * kLogStep);
+    for (std::size_t p = 0; p < processes.size(); ++p)
+      table.mu[channels[p]][i] += calculator.ComputeCrossSectionPerVolume(energy, gamma, processes[p], material);
+
+    if (!hasRayleigh || elements->size() < 2)
+      continue;
+    std::vector<G4double> &cumulative = table.rayleighElement[i];
+    G4double sum = 0.;
+    for (std::size_t e = 0; e < elements->size(); ++e)
+      cumulative[e] = sum += atomDensity[e] * calculator.ComputeCrossSectionPerAtom(energy, gamma, "Rayl", (*elements)[e]);
+    for (auto &value : cumulative)
+      value = (sum > 0.) ? value / sum : 1.;
+  }
+
+  for (G4int c = 0; c < kNumberOfChannels; ++c)
+    for (std::size_t i = 0; i < kPoints; ++i)
+      if (table.mu[c][i] > 0.)
+        table.logMu[c][i] = std::log(table.mu[c][i]);
+
+  if (G4Threading::G4GetThreadId() <= 0)
+    G4cout << "Modelo rápido: tablas de " << material->GetName() << " (" << processes.size() << " procesos, "
+           << kPoints << " energías)" << G4endl;
+}
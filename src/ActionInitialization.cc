@@ -0,0 +1,61 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "ActionInitialization.hh"
+#include "DetectorConstruction.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "RunAction.hh"
+#include "EventAction.hh"
+#include "SteppingAction.hh"
+#include "StackingAction.hh"
+#include "SweepManager.hh"
+#include "EventWriter.hh"
+#include "PrecisionMonitor.hh"
+#include "AnalyticEngine.hh"
+#include "EnergyTally.hh"
+#include "MeshTally.hh"
+
+ActionInitialization::ActionInitialization(DetectorConstruction *det)
+    : G4VUserActionInitialization(), detector(det)
+{
+  // Se construye en el hilo maestro, antes de leer cualquier macro
+  precisionMonitor = new PrecisionMonitor();
+  sweepManager = new SweepManager(precisionMonitor);
+  eventWriter = new EventWriter();
+  analyticEngine = new AnalyticEngine(detector);
+  energyBinning = new EnergyBinning();
+  meshConfig = new MeshConfig();
+}
+
+ActionInitialization::~ActionInitialization()
+{
+  delete meshConfig;
+  delete energyBinning;
+  delete analyticEngine;
+  delete eventWriter;
+  delete sweepManager;
+  delete precisionMonitor;
+}
+
+void ActionInitialization::BuildForMaster() const
+{
+  // El maestro no genera eventos: solo fusiona acumulables y escribe ficheros
+  SetUserAction(new RunAction(detector, sweepManager, eventWriter, precisionMonitor, energyBinning, meshConfig));
+}
+
+void ActionInitialization::Build() const
+{
+  SetUserAction(new PrimaryGeneratorAction());
+
+  auto runAction = new RunAction(detector, sweepManager, eventWriter, precisionMonitor, energyBinning, meshConfig);
+  SetUserAction(runAction);
+
+  SetUserAction(new EventAction(runAction));
+
+  // Modo rápido (desactivado por defecto, /fast/enable)
+  auto steppingAction = new SteppingAction(detector, runAction);
+  SetUserAction(steppingAction);
+  SetUserAction(new StackingAction(detector, steppingAction));
+}
@@ -0,0 +1,79 @@
+#include "AnalyticMessenger.hh"
+#include "AnalyticEngine.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+AnalyticMessenger::AnalyticMessenger(AnalyticEngine *engine)
+    : G4UImessenger(), analyticEngine(engine)
+{
+    // Crear directorio de comandos
+    analyticDir = new G4UIdirectory("/analytic/");
+    analyticDir->SetGuidance("Coeficientes de atenuación de haz estrecho sin transporte (G4EmCalculator)");
+
+    energiesCmd = new G4UIcmdWithAString("/analytic/energies", this);
+    energiesCmd->SetGuidance("Lista de energías con unidad opcional al final (por defecto keV)");
+    energiesCmd->SetGuidance("Sin lista (o 'nist') se usa la malla NIST del material");
+    energiesCmd->SetParameterName("energies", true);
+    energiesCmd->SetDefaultValue("nist");
+    energiesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    outputCmd = new G4UIcmdWithAString("/analytic/output", this);
+    outputCmd->SetGuidance("Fichero CSV de salida");
+    outputCmd->SetGuidance("Por defecto ../results/multi_energy/energy_spectrum[_<material>]_comparison.csv");
+    outputCmd->SetParameterName("file", false);
+    outputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    runCmd = new G4UIcmdWithoutParameter("/analytic/run", this);
+    runCmd->SetGuidance("Calcula mu y mu/rho del material actual en toda la malla de energías");
+    runCmd->AvailableForStates(G4State_Idle);
+}
+
+AnalyticMessenger::~AnalyticMessenger()
+{
+    delete energiesCmd;
+    delete outputCmd;
+    delete runCmd;
+    delete analyticDir;
+}
+
+void AnalyticMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == energiesCmd)
+    {
+        std::vector<G4String> tokens;
+        std::istringstream is(newValue);
+        G4String token;
+        while (is >> token)
+            tokens.push_back(token);
+
+        std::vector<G4double> energies;
+        if (!tokens.empty() && tokens.front() != "nist")
+        {
+            // Si el último elemento no es un número se interpreta como la unidad
+            G4double unit = G4UIcommand::ValueOf("keV");
+            char *end = nullptr;
+            std::strtod(tokens.back().c_str(), &end);
+            if (*end != '\0')
+            {
+                unit = G4UIcommand::ValueOf(tokens.back());
+                tokens.pop_back();
+            }
+            for (const auto &t : tokens)
+                energies.push_back(G4UIcommand::ConvertToDouble(t) * unit);
+        }
+        analyticEngine->SetEnergies(energies);
+    }
+    else if (command == outputCmd)
+    {
+        analyticEngine->SetOutputFile(newValue);
+    }
+    else if (command == runCmd)
+    {
+        analyticEngine->Run();
+    }
+}
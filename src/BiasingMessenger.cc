@@ -0,0 +1,34 @@
+#include "BiasingMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADouble.hh"
+
+BiasingMessenger::BiasingMessenger(DetectorConstruction *detector)
+    : G4UImessenger(), detectorConstruction(detector)
+{
+    // Crear directorio de comandos
+    biasDir = new G4UIdirectory("/bias/");
+    biasDir->SetGuidance("Reducción de varianza en el absorbente (requiere arrancar con --bias)");
+
+    expTransformCmd = new G4UIcmdWithADouble("/bias/expTransform", this);
+    expTransformCmd->SetGuidance("Parámetro p de la transformada exponencial para fotones");
+    expTransformCmd->SetGuidance("sigma' = sigma * (1 - p cos(theta)); 0 = simulación analógica");
+    expTransformCmd->SetGuidance("Valores típicos: 0.5-0.9 para blindajes gruesos");
+    expTransformCmd->SetParameterName("p", false);
+    expTransformCmd->SetRange("p >= 0. && p < 1.");
+    expTransformCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+BiasingMessenger::~BiasingMessenger()
+{
+    delete expTransformCmd;
+    delete biasDir;
+}
+
+void BiasingMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == expTransformCmd)
+    {
+        detectorConstruction->SetExpTransform(expTransformCmd->GetNewDoubleValue(newValue));
+    }
+}
@@ -8,84 +8,406 @@ Fecha: Octubre 2025
 #include "G4Box.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
+#include "LayerParameterisation.hh"
+#include "VoxelPhantom.hh"
+#include "PhantomMessenger.hh"
 #include "G4NistManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
+#include "G4GeometryManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+#include <algorithm>
 // Construcción del sentiveDetector para el volumen
 #include "G4SDManager.hh"
 #include "MiSensitiveDetector.hh"
+// Reducción de varianza en el absorbente
+#include "AbsorberBiasingOperator.hh"
+#include "BiasingMessenger.hh"
+// Simulación rápida del absorbente
+#include "AbsorberFastModel.hh"
+#include "FastSimMessenger.hh"
+#include "G4Region.hh"
+#include "G4ProductionCutsTable.hh"
+#include "PerformanceMonitor.hh"
 
 /* Defino los valores por defecto que tenrá mi detector cuando arranque la simualción*/
 DetectorConstruction::DetectorConstruction()
-    : materialType("water"), thickness(5.0 * cm)
+    : materialType("water"), thickness(5.0 * cm), storeHits(false), biasing(false),
+      expTransform(0.), fastSimulation(false), fastSimActive(true), absorberRegion(nullptr), slabs(1), phantom(nullptr), usePhantom(false), logicDetector(nullptr),
+      physWorld(nullptr), solidAbsorber(nullptr), logicAbsorber(nullptr),
+      physDetector(nullptr), logicLayer(nullptr), layerParam(nullptr),
+      logicVoxel(nullptr), phantomParam(nullptr), visAbsorber(nullptr), visDetector(nullptr)
 {
     messenger = new DetectorMessenger(this);
+    biasingMessenger = new BiasingMessenger(this);
+    fastSimMessenger = new FastSimMessenger(this);
+    phantom = new VoxelPhantom();
+    phantomMessenger = new PhantomMessenger(this);
 } // Material inicial es agua, con espesor de 5cm.
 
 DetectorConstruction::~DetectorConstruction()
 {
     delete messenger;
+    delete biasingMessenger;
+    delete fastSimMessenger;
+    delete phantomMessenger;
+    delete layerParam;
+    delete phantomParam;
+    delete phantom;
+    delete visAbsorber;
+    delete visDetector;
 }
 
 /* Cambiamos el material dinámicamente */
 void DetectorConstruction::SetMaterialType(const G4String &material)
 { // Setmaterial -> deja elegir otro amterial desde la interfaz macros.
     materialType = material;
-    // Forzar reconstrucción si ya está construido
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    if (!layers.empty())
+        G4cerr << "AVISO: con capas definidas el material lo fija cada capa (/detector/clearLayers)" << G4endl;
+    if (HasPhantom())
+        G4cerr << "AVISO: con un maniquí cargado el material lo fija cada vóxel (/phantom/clear)" << G4endl;
+    if (!logicAbsorber || !layers.empty() || HasPhantom())
+        return; // Aún no construido: Construct() usará el nuevo material
+
+    // Solo cambia el material del volumen lógico existente; las tablas de
+    // física se actualizan para el nuevo material al comenzar el siguiente run
+    G4Material *newMaterial = DefineMaterials(materialType);
+    logicAbsorber->SetMaterial(newMaterial);
+    if (logicLayer)
+        logicLayer->SetMaterial(newMaterial); // Láminas (réplicas) del mismo material
+    visAbsorber->SetColour(AbsorberColour());
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
 }
 
 /* Cambiar espesor dinámicamente */
 void DetectorConstruction::SetThickness(G4double thick)
 { // Puede cambiar de 5cm a 10cm desde la interfaz macros.
+    if (!layers.empty() || HasPhantom())
+    {
+        G4cerr << "AVISO: con capas o maniquí el espesor lo fija la geometría; se ignora /detector/setThickness" << G4endl;
+        return;
+    }
     thickness = thick;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    if (!solidAbsorber)
+        return;
+
+    // El ancho de las réplicas es fijo: las láminas se vuelven a construir
+    if (logicLayer)
+    {
+        RebuildGeometry();
+        return;
+    }
+
+    // Redimensiona la caja y desplaza el detector sin reconstruir nada. Solo se
+    // abren (y se vuelven a voxelizar) las optimizaciones del mundo, que es la
+    // madre de ambos volúmenes.
+    auto geometryManager = G4GeometryManager::GetInstance();
+    G4bool wasClosed = geometryManager->IsGeometryClosed();
+    if (wasClosed)
+        geometryManager->OpenGeometry(physDetector);
+
+    solidAbsorber->SetZHalfLength(thickness / 2.0);
+    physDetector->SetTranslation(DetectorPosition());
+
+    if (wasClosed)
+        geometryManager->CloseGeometry(true, false, physDetector);
+}
+
+/* Añade una capa al final de la pila (lado del detector) */
+void DetectorConstruction::AddLayer(const G4String &material, G4double thick)
+{
+    if (layers.empty())
+        thickness = 0.;
+    layers.push_back({material, thick});
+    thickness += thick;
+
+    // Etiqueta para resultados: las capas consecutivas del mismo material se
+    // muestran una vez (100 láminas de agua siguen siendo "water")
+    if (layers.size() == 1 || layers[layers.size() - 2].material != material)
+        layerLabel += (layers.size() == 1 ? "" : "+") + material;
+    RebuildGeometry();
+}
+
+void DetectorConstruction::ClearLayers()
+{
+    if (layers.empty())
+        return;
+    layers.clear();
+    layerLabel.clear();
+    RebuildGeometry(); // Se conserva el espesor total de la pila
+}
+
+void DetectorConstruction::SetSlabs(G4int n)
+{
+    slabs = n;
+    if (!layers.empty())
+        G4cerr << "AVISO: /detector/setSlabs solo se aplica al absorbente homogéneo (sin capas)" << G4endl;
+    RebuildGeometry();
+}
+
+/* Maniquí de vóxeles: mientras está cargado ocupa el lugar del absorbente
+   (mismo centro, cara de entrada hacia la fuente) */
+G4bool DetectorConstruction::LoadPhantom(const G4String &path, G4int nx, G4int ny, G4int nz,
+                                         const G4ThreeVector &voxelSize, G4bool hounsfield, std::size_t headerBytes)
+{
+    // Si falla, el maniquí anterior (si lo había) sigue intacto
+    if (!phantom->Open(path, nx, ny, nz, voxelSize,
+                       hounsfield ? VoxelPhantom::kHounsfield : VoxelPhantom::kMaterialIndex, headerBytes))
+        return false;
+    if (!layers.empty())
+        G4cerr << "AVISO: el maniquí sustituye a las capas mientras esté cargado" << G4endl;
+
+    usePhantom = true;
+    thickness = 2. * phantom->GetHalfSize().z();
+    G4String name = path.substr(path.find_last_of('/') + 1);
+    phantomLabel = "phantom:" + name.substr(0, name.find_last_of('.'));
+    RebuildGeometry();
+    return true;
+}
+
+void DetectorConstruction::ClearPhantom()
+{
+    if (!HasPhantom())
+        return;
+    // El fichero sigue proyectado hasta el siguiente /phantom/load: la geometría
+    // actual lo usa hasta que se reconstruye (sus páginas no ocupan memoria propia)
+    usePhantom = false;
+    phantomLabel.clear();
+    RebuildGeometry(); // Se conserva el espesor del maniquí
+}
+
+void DetectorConstruction::AddPhantomHURange(G4int low, G4int high, const G4String &material)
+{
+    phantom->AddHURange(low, high, material);
+    if (HasPhantom())
+        RebuildGeometry(); // Lista de materiales de la parametrización
+}
+
+void DetectorConstruction::ResetPhantomHURanges()
+{
+    phantom->ResetHURanges();
+    if (HasPhantom())
+        RebuildGeometry();
+}
+
+void DetectorConstruction::SetPhantomIndexMaterials(const std::vector<G4String> &names)
+{
+    phantom->SetIndexMaterials(names);
+    if (HasPhantom())
+        RebuildGeometry();
+}
+
+G4bool DetectorConstruction::HasPhantom() const
+{
+    return usePhantom && phantom->IsOpen();
+}
+
+G4String DetectorConstruction::GetMaterial() const
+{
+    if (HasPhantom())
+        return phantomLabel;
+    return layers.empty() ? materialType : layerLabel;
+}
+
+G4ThreeVector DetectorConstruction::GetAbsorberHalfSize() const
+{
+    if (HasPhantom())
+        return phantom->GetHalfSize();
+    return G4ThreeVector(absorberHalfXY, absorberHalfXY, thickness / 2.0);
+}
+
+/* Cambios que no se pueden hacer en sitio (número o ancho de las capas):
+   el gestor vuelve a llamar a Construct() antes del siguiente run */
+void DetectorConstruction::RebuildGeometry()
+{
+    if (physWorld)
+        G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+G4int DetectorConstruction::GetNumberOfLayers() const
+{
+    if (HasPhantom())
+        return 0; // El maniquí ocupa el lugar de las capas
+    if (!layers.empty())
+        return static_cast<G4int>(layers.size());
+    return (slabs > 1) ? slabs : 0;
+}
+
+G4bool DetectorConstruction::IsHeterogeneous() const
+{
+    if (HasPhantom())
+        return true;
+    for (const auto &layer : layers)
+        if (layer.material != layers.front().material)
+            return true;
+    return false;
+}
+
+std::vector<G4double> DetectorConstruction::GetLayerBackFaces() const
+{
+    std::vector<G4double> faces;
+    G4double z = -thickness / 2.0;
+    if (HasPhantom())
+        return faces;
+    if (!layers.empty())
+    {
+        for (const auto &layer : layers)
+            faces.push_back(z += layer.thickness);
+    }
+    else if (slabs > 1)
+    {
+        for (G4int i = 1; i <= slabs; ++i)
+            faces.push_back(z + i * thickness / slabs);
+    }
+    return faces;
+}
+
+G4String DetectorConstruction::GetLayerMaterial(G4int layer) const
+{
+    return layers.empty() ? materialType : layers[layer].material;
+}
+
+G4double DetectorConstruction::GetDensityAt(G4double z) const
+{
+    // Maniquí: densidad del vóxel del eje del haz en ese plano
+    if (HasPhantom() && !phantomMaterials.empty())
+    {
+        G4int iz = static_cast<G4int>((z + thickness / 2.0) / phantom->GetVoxelSize().z());
+        iz = std::min(std::max(iz, 0), phantom->GetNz() - 1);
+        return phantomMaterials[phantom->MaterialSlot(phantom->GetNx() / 2, phantom->GetNy() / 2, iz)]->GetDensity();
+    }
+
+    if (layers.empty() || layerMaterials.size() != layers.size())
+        return logicAbsorber->GetMaterial()->GetDensity();
+
+    G4double back = -thickness / 2.0;
+    for (std::size_t i = 0; i < layers.size(); ++i)
+    {
+        back += layers[i].thickness;
+        if (z < back)
+            return layerMaterials[i]->GetDensity();
+    }
+    return layerMaterials.back()->GetDensity();
+}
+
+G4double DetectorConstruction::GetMeanDensity() const
+{
+    // Maniquí: media a lo largo del eje del haz (solo se leen nz vóxeles)
+    if (HasPhantom() && !phantomMaterials.empty())
+    {
+        G4double sum = 0.;
+        for (G4int iz = 0; iz < phantom->GetNz(); ++iz)
+            sum += phantomMaterials[phantom->MaterialSlot(phantom->GetNx() / 2, phantom->GetNy() / 2, iz)]->GetDensity();
+        return sum / phantom->GetNz();
+    }
+
+    if (layers.empty() || layerMaterials.size() != layers.size())
+        return logicAbsorber->GetMaterial()->GetDensity();
+
+    G4double massThickness = 0.;
+    for (std::size_t i = 0; i < layers.size(); ++i)
+        massThickness += layerMaterials[i]->GetDensity() * layers[i].thickness;
+    return massThickness / thickness;
+}
+
+/* Parámetro de la transformada exponencial; se lee al comenzar cada run */
+void DetectorConstruction::SetExpTransform(G4double p)
+{
+    expTransform = p;
+    if (p > 0. && !biasing)
+        G4cerr << "AVISO: /bias/expTransform no tiene efecto sin --bias al arrancar" << G4endl;
+}
+
+/* Modelo rápido o transporte completo; se aplica desde el siguiente evento */
+void DetectorConstruction::SetFastSimActive(G4bool value)
+{
+    fastSimActive = value;
+    if (value && !fastSimulation)
+        G4cerr << "AVISO: /fastsim/enable no tiene efecto sin --fastsim al arrancar" << G4endl;
+}
+
+G4bool DetectorConstruction::UsesFastSimModel() const
+{
+    // Con capas o maniquí el transporte completo puntúa cada volumen hijo, y la
+    // transformada exponencial corrige el peso en cada paso
+    return fastSimulation && fastSimActive && GetNumberOfLayers() == 0 && !HasPhantom() &&
+           !(biasing && expTransform > 0.);
+}
+
+/* Posición del detector: 5 cm detrás de la cara de salida del absorbente */
+G4ThreeVector DetectorConstruction::DetectorPosition() const
+{
+    return G4ThreeVector(0, 0, thickness / 2.0 + 5 * cm);
+}
+
+/* Colores segun material */
+G4Colour DetectorConstruction::AbsorberColour() const
+{
+    if (materialType == "water")
+        return G4Colour(0, 0, 1, 0.4); // Azul
+    else if (materialType == "muscle")
+        return G4Colour(1, 0.8, 0.6, 0.4); // Color carne
+    else if (materialType == "bone")
+        return G4Colour(1, 1, 0.8, 0.4); // Color hueso
+    else if (materialType == "lead")
+        return G4Colour(0.5, 0.5, 0.5, 0.4); // Gris
+    else if (materialType == "concrete")
+        return G4Colour(0.6, 0.6, 0.6, 0.4); // Gris claro
+    return G4Colour(0, 0, 1, 0.4); // Azul por defecto
 }
 
 /* Deefinición de materiales */
-G4Material *DetectorConstruction::DefineMaterials()
+G4Material *DetectorConstruction::DefineMaterials(const G4String &m)
 {
     G4NistManager *nist = G4NistManager::Instance();
     G4Material *material = nullptr;
 
-    // Normalizar materialType por si acaso
-    G4String m = materialType;
-    // opcional: forzar minúsculas si quieres (requiere transformación manual)
-
     if (m == "water")
     {
         material = nist->FindOrBuildMaterial("G4_WATER");
     }
     else if (m == "muscle")
     {
-        // Segun ICRU Report 44
-        G4double density = 1.05 * g / cm3;
-        material = new G4Material("muscle", density, 9);
-        material->AddElement(nist->FindOrBuildElement("H"), 10.2 * perCent);
-        material->AddElement(nist->FindOrBuildElement("C"), 14.3 * perCent);
-        material->AddElement(nist->FindOrBuildElement("N"), 3.4 * perCent);
-        material->AddElement(nist->FindOrBuildElement("O"), 71.0 * perCent);
-        material->AddElement(nist->FindOrBuildElement("Na"), 0.1 * perCent);
-        material->AddElement(nist->FindOrBuildElement("P"), 0.2 * perCent);
-        material->AddElement(nist->FindOrBuildElement("S"), 0.5 * perCent);
-        material->AddElement(nist->FindOrBuildElement("Cl"), 0.1 * perCent);
-        material->AddElement(nist->FindOrBuildElement("K"), 0.2 * perCent);
+        // Segun ICRU Report 44 (se reutiliza si ya se definió antes)
+        material = G4Material::GetMaterial("muscle", false);
+        if (!material)
+        {
+            G4double density = 1.05 * g / cm3;
+            material = new G4Material("muscle", density, 9);
+            material->AddElement(nist->FindOrBuildElement("H"), 10.2 * perCent);
+            material->AddElement(nist->FindOrBuildElement("C"), 14.3 * perCent);
+            material->AddElement(nist->FindOrBuildElement("N"), 3.4 * perCent);
+            material->AddElement(nist->FindOrBuildElement("O"), 71.0 * perCent);
+            material->AddElement(nist->FindOrBuildElement("Na"), 0.1 * perCent);
+            material->AddElement(nist->FindOrBuildElement("P"), 0.2 * perCent);
+            material->AddElement(nist->FindOrBuildElement("S"), 0.5 * perCent);
+            material->AddElement(nist->FindOrBuildElement("Cl"), 0.1 * perCent);
+            material->AddElement(nist->FindOrBuildElement("K"), 0.2 * perCent);
+        }
     }
     else if (m == "bone")
     {
         // Hueso segun ICRU report 44
-        G4double density = 1.92 * g / cm3;
-        material = new G4Material("bone", density, 9);
-        material->AddElement(nist->FindOrBuildElement("H"), 3.4 * perCent);
-        material->AddElement(nist->FindOrBuildElement("C"), 15.5 * perCent);
-        material->AddElement(nist->FindOrBuildElement("N"), 4.2 * perCent);
-        material->AddElement(nist->FindOrBuildElement("O"), 43.5 * perCent);
-        material->AddElement(nist->FindOrBuildElement("Na"), 0.1 * perCent);
-        material->AddElement(nist->FindOrBuildElement("Mg"), 0.2 * perCent);
-        material->AddElement(nist->FindOrBuildElement("P"), 16.9 * perCent);
-        material->AddElement(nist->FindOrBuildElement("S"), 0.2 * perCent);
-        material->AddElement(nist->FindOrBuildElement("Ca"), 16.0 * perCent);
+        material = G4Material::GetMaterial("bone", false);
+        if (!material)
+        {
+            G4double density = 1.92 * g / cm3;
+            material = new G4Material("bone", density, 9);
+            material->AddElement(nist->FindOrBuildElement("H"), 3.4 * perCent);
+            material->AddElement(nist->FindOrBuildElement("C"), 15.5 * perCent);
+            material->AddElement(nist->FindOrBuildElement("N"), 4.2 * perCent);
+            material->AddElement(nist->FindOrBuildElement("O"), 43.5 * perCent);
+            material->AddElement(nist->FindOrBuildElement("Na"), 0.1 * perCent);
+            material->AddElement(nist->FindOrBuildElement("Mg"), 0.2 * perCent);
+            material->AddElement(nist->FindOrBuildElement("P"), 16.9 * perCent);
+            material->AddElement(nist->FindOrBuildElement("S"), 0.2 * perCent);
+            material->AddElement(nist->FindOrBuildElement("Ca"), 16.0 * perCent);
+        }
     }
     else if (m == "lead")
     {
@@ -132,63 +454,181 @@ DetectorConstruction::~DetectorConstruction() {}*/
 
 G4VPhysicalVolume *DetectorConstruction::Construct()
 {
+    GAMMAATT_PERF_SCOPE(kGeometry);
+
+    // Si se pide una reconstrucción completa, liberar la geometría anterior
+    if (physWorld)
+    {
+        if (absorberRegion)
+            absorberRegion->RemoveRootLogicalVolume(logicAbsorber, false); // Se libera con el almacén
+        G4GeometryManager::GetInstance()->OpenGeometry();
+        G4PhysicalVolumeStore::GetInstance()->Clean();
+        G4LogicalVolumeStore::GetInstance()->Clean();
+        G4SolidStore::GetInstance()->Clean();
+        delete visAbsorber;
+        delete visDetector;
+    }
+
     // Mundo mínimo de aire para que compile
     G4NistManager *nist = G4NistManager::Instance();
 
-    // --- 1. Mundo ---
-    G4double world_size = 1.0 * m;
+    // --- 1. Mundo (se amplía si el maniquí no cabe) ---
+    G4ThreeVector absorberHalf = GetAbsorberHalfSize();
+    G4double world_size = std::max(1.0 * m, 1.1 * std::max({absorberHalf.x(), absorberHalf.y(), absorberHalf.z() + 10 * cm}));
     G4Material *world_mat = nist->FindOrBuildMaterial("G4_AIR"); // Aquí se modifica el material del mundo
     auto solidWorld = new G4Box("World", world_size, world_size, world_size);
     auto logicWorld = new G4LogicalVolume(solidWorld, world_mat, "World");
-    auto physWorld = new G4PVPlacement(0, {}, logicWorld, "World", 0, false, 0);
+    physWorld = new G4PVPlacement(0, {}, logicWorld, "World", 0, false, 0);
     logicWorld->SetVisAttributes(G4VisAttributes::GetInvisible()); // Invisible
 
     // --- 2. Materiales absorbentes ---
-    G4Material *absorber_mat = DefineMaterials(); // nist->FindOrBuildMaterial("G4_WATER"); -> Material absorbente
+    // Con capas, la envolvente toma el material de la primera y con maniquí es
+    // agua (las capas y los vóxeles la llenan por completo)
+    G4Material *absorber_mat = DefineMaterials(HasPhantom() ? G4String("water")
+                                               : layers.empty() ? materialType : layers.front().material);
     if (!absorber_mat)
     {
         G4cerr << "Fatal: absorber_mat es NULL. Usando G4_WATER temporalmente." << G4endl;
         absorber_mat = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
     }
-    G4double absorber_thickness = thickness; // 5 cm -> espesor del material absorbente
-    auto solidAbs = new G4Box("Absorber", 10 * cm, 10 * cm, absorber_thickness / 2.0);
-    auto logicAbs = new G4LogicalVolume(solidAbs, absorber_mat, "Absorber");
-    new G4PVPlacement(0, G4ThreeVector(0, 0, 0), logicAbs, "Absorber", logicWorld, false, 0);
+    solidAbsorber = new G4Box("Absorber", absorberHalf.x(), absorberHalf.y(), absorberHalf.z());
+    logicAbsorber = new G4LogicalVolume(solidAbsorber, absorber_mat, "Absorber");
+    new G4PVPlacement(0, G4ThreeVector(0, 0, 0), logicAbsorber, "Absorber", logicWorld, false, 0);
+
+    // Región del modelo rápido: la caja completa, con los cortes por defecto
+    if (fastSimulation)
+    {
+        if (!absorberRegion)
+        {
+            absorberRegion = new G4Region("AbsorberRegion");
+            absorberRegion->SetProductionCuts(
+                G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts());
+        }
+        absorberRegion->AddRootLogicalVolume(logicAbsorber);
+    }
 
     // Colores segun material
-    G4VisAttributes *visAbs;
-    if (materialType == "water")
-        visAbs = new G4VisAttributes(G4Colour(0, 0, 1, 0.4)); // Azul
-    else if (materialType == "muscle")
-        visAbs = new G4VisAttributes(G4Colour(1, 0.8, 0.6, 0.4)); // Color carne
-    else if (materialType == "bone")
-        visAbs = new G4VisAttributes(G4Colour(1, 1, 0.8, 0.4)); // Color hueso
-    else if (materialType == "lead")
-        visAbs = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5, 0.4)); // Gris
-    else if (materialType == "concrete")
-        visAbs = new G4VisAttributes(G4Colour(0.6, 0.6, 0.6, 0.4)); // Gris claro
-    else
-        visAbs = new G4VisAttributes(G4Colour(0, 0, 1, 0.4)); // Azul por defecto
-    logicAbs->SetVisAttributes(visAbs);
+    visAbsorber = new G4VisAttributes(AbsorberColour());
+    logicAbsorber->SetVisAttributes(visAbsorber);
+
+    ConstructLayers();
+    ConstructPhantom();
 
     // --- 3. Detector ---
     G4Material *detector_mat = nist->FindOrBuildMaterial("G4_AIR"); // Material del detector
-    auto solidDet = new G4Box("Detector", 15 * cm, 15 * cm, 2 * mm);
+    auto solidDet = new G4Box("Detector", detectorHalfXY, detectorHalfXY, detectorHalfZ);
     auto logicDet = new G4LogicalVolume(solidDet, detector_mat, "Detector");
-    new G4PVPlacement(0, G4ThreeVector(0, 0, absorber_thickness / 2.0 + 5 * cm),
-                      logicDet, "Detector", logicWorld, false, 0);
-    auto visDet = new G4VisAttributes(G4Colour(1, 0, 0, 0.6)); // Rojo
-    logicDet->SetVisAttributes(visDet);
+    physDetector = new G4PVPlacement(0, DetectorPosition(),
+                                     logicDet, "Detector", logicWorld, false, 0);
+    visDetector = new G4VisAttributes(G4Colour(1, 0, 0, 0.6)); // Rojo
+    logicDet->SetVisAttributes(visDetector);
+    logicDetector = logicDet;
 
-    // --- 4. Detector lógico: sensitivedetector. ---
+    return physWorld;
+}
+
+/* Capas dentro de la envolvente Absorber, con un único volumen lógico:
+   - pila heterogénea (/detector/addLayer): G4PVParameterised, que da a cada
+     copia su espesor, su posición y su material;
+   - láminas iguales del mismo material (/detector/setSlabs): G4PVReplica.
+   En ambos casos la memoria y la voxelización no dependen del número de capas. */
+void DetectorConstruction::ConstructLayers()
+{
+    logicLayer = nullptr;
+    delete layerParam; // Sus volúmenes ya se liberaron al limpiar los almacenes
+    layerParam = nullptr;
+    layerMaterials.clear();
+
+    if (HasPhantom())
+        return;
+    if (!layers.empty())
+    {
+        std::vector<G4double> thicknesses;
+        for (const auto &layer : layers)
+        {
+            thicknesses.push_back(layer.thickness);
+            layerMaterials.push_back(DefineMaterials(layer.material));
+        }
+        auto solidLayer = new G4Box("Layer", absorberHalfXY, absorberHalfXY, layers.front().thickness / 2.0);
+        logicLayer = new G4LogicalVolume(solidLayer, layerMaterials.front(), "Layer");
+        layerParam = new LayerParameterisation(absorberHalfXY, -thickness / 2.0, thicknesses, layerMaterials);
+        new G4PVParameterised("Layer", logicLayer, logicAbsorber, kZAxis, static_cast<G4int>(layers.size()), layerParam);
+    }
+    else if (slabs > 1)
+    {
+        auto solidLayer = new G4Box("Layer", absorberHalfXY, absorberHalfXY, thickness / (2.0 * slabs));
+        logicLayer = new G4LogicalVolume(solidLayer, logicAbsorber->GetMaterial(), "Layer");
+        new G4PVReplica("Layer", logicLayer, logicAbsorber, kZAxis, slabs, thickness / slabs);
+    }
+    else
+        return;
+
+    logicLayer->SetVisAttributes(visAbsorber);
+    G4cout << "Absorbente: " << GetNumberOfLayers() << " capas (" << GetMaterial() << ", "
+           << thickness / cm << " cm)" << G4endl;
+}
+
+/* Maniquí: G4PhantomParameterisation sobre la caja Absorber, que mide
+   exactamente nx*dx x ny*dy x nz*dz. Con el identificador de estructura
+   regular el navegador usa G4RegularNavigation: localiza el vóxel por
+   aritmética y salta de una vez los vóxeles consecutivos del mismo material,
+   sin voxelización inteligente sobre millones de copias. */
+void DetectorConstruction::ConstructPhantom()
+{
+    logicVoxel = nullptr;
+    delete phantomParam; // Sus volúmenes ya se liberaron al limpiar los almacenes
+    phantomParam = nullptr;
+    phantomMaterials.clear();
+    if (!HasPhantom())
+        return;
+
+    for (const auto &name : phantom->GetMaterialNames())
+        phantomMaterials.push_back(DefineMaterials(name));
+
+    G4ThreeVector voxel = phantom->GetVoxelSize();
+    auto solidVoxel = new G4Box("Voxel", voxel.x() / 2., voxel.y() / 2., voxel.z() / 2.);
+    logicVoxel = new G4LogicalVolume(solidVoxel, phantomMaterials.front(), "Voxel");
+    logicVoxel->SetVisAttributes(G4VisAttributes::GetInvisible()); // Millones de copias
+
+    phantomParam = new PhantomParameterisation(phantom, phantomMaterials);
+    phantomParam->BuildContainerSolid(solidAbsorber);
+    phantomParam->CheckVoxelsFillContainer(solidAbsorber->GetXHalfLength(), solidAbsorber->GetYHalfLength(),
+                                           solidAbsorber->GetZHalfLength());
+    auto physVoxels = new G4PVParameterised("Voxels", logicVoxel, logicAbsorber, kUndefined,
+                                            static_cast<G4int>(phantom->GetNumberOfVoxels()), phantomParam);
+    physVoxels->SetRegularStructureId(1);
+
+    G4cout << "Maniquí: " << phantom->GetNumberOfVoxels() << " vóxeles, " << phantomMaterials.size()
+           << " materiales, " << 2. * solidAbsorber->GetZHalfLength() / cm << " cm en z" << G4endl;
+}
+
+/* --- 4. Detector lógico: sensitivedetector. ---
+   Se llama en cada hilo de trabajo (y en modo secuencial), ya que los SD
+   son objetos locales a cada hilo. */
+void DetectorConstruction::ConstructSDandField()
+{
     auto sdManager = G4SDManager::GetSDMpointer();
     auto sd = sdManager->FindSensitiveDetector("MyDetectorSD", false);
     if (!sd)
     {
-        sd = new MiSensitiveDetector("MyDetectorSD");
+        sd = new MiSensitiveDetector("MyDetectorSD", this);
         sdManager->AddNewDetector(sd);
     }
-    logicDet->SetSensitiveDetector(sd);
+    SetSensitiveDetector(logicDetector, sd);
 
-    return physWorld;
+    // Operador de biasing (uno por hilo); solo si los procesos de fotones
+    // están envueltos por G4GenericBiasingPhysics
+    if (biasing && !G4VBiasingOperator::GetBiasingOperator(logicAbsorber))
+    {
+        auto biasingOperator = new AbsorberBiasingOperator(this);
+        biasingOperator->AttachTo(logicAbsorber);
+        if (logicLayer)
+            biasingOperator->AttachTo(logicLayer); // Las capas no heredan el operador de la envolvente
+        if (logicVoxel)
+            biasingOperator->AttachTo(logicVoxel);
+    }
+
+    // Modelo rápido del absorbente (uno por hilo; el gestor de la región es local a cada hilo)
+    if (absorberRegion && !absorberRegion->GetFastSimulationManager())
+        new AbsorberFastModel("AbsorberModel", absorberRegion, this);
 }
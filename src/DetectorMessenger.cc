@@ -3,7 +3,12 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIparameter.hh"
 #include "G4SystemOfUnits.hh"
+#include <sstream>
 
 DetectorMessenger::DetectorMessenger(DetectorConstruction *detector)
     : G4UImessenger(), detectorConstruction(detector)
@@ -33,12 +38,49 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction *detector)
     thicknessCmd->SetUnitCategory("Length");
     thicknessCmd->SetRange("thickness > 0");
     thicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // Comando para guardar hits individuales (solo útil para visualizar)
+    storeHitsCmd = new G4UIcmdWithABool("/detector/storeHits", this);
+    storeHitsCmd->SetGuidance("Guarda un MiHit por paso en el detector (para /vis/scene/add/hits)");
+    storeHitsCmd->SetGuidance("Desactivado por defecto en modo batch: la puntuación no lo necesita");
+    storeHitsCmd->SetParameterName("store", true);
+    storeHitsCmd->SetDefaultValue(true);
+    storeHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // Absorbente por capas: cada llamada añade una capa detrás de la anterior
+    addLayerCmd = new G4UIcommand("/detector/addLayer", this);
+    addLayerCmd->SetGuidance("Añade una capa al absorbente (de la fuente hacia el detector)");
+    addLayerCmd->SetGuidance("El espesor total pasa a ser la suma de las capas");
+    addLayerCmd->SetGuidance("Ej: /detector/addLayer muscle 2 cm");
+    addLayerCmd->SetParameter(new G4UIparameter("material", 's', false));
+    auto layerThickness = new G4UIparameter("thickness", 'd', false);
+    layerThickness->SetParameterRange("thickness > 0");
+    addLayerCmd->SetParameter(layerThickness);
+    auto layerUnit = new G4UIparameter("unit", 's', true);
+    layerUnit->SetDefaultValue("cm");
+    addLayerCmd->SetParameter(layerUnit);
+    addLayerCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    clearLayersCmd = new G4UIcmdWithoutParameter("/detector/clearLayers", this);
+    clearLayersCmd->SetGuidance("Elimina las capas: vuelve al absorbente homogéneo de /detector/setMaterial");
+    clearLayersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    slabsCmd = new G4UIcmdWithAnInteger("/detector/setSlabs", this);
+    slabsCmd->SetGuidance("Divide el absorbente homogéneo en n láminas iguales (G4PVReplica)");
+    slabsCmd->SetGuidance("Da la transmisión tras cada lámina; 1 = una sola pieza");
+    slabsCmd->SetParameterName("n", false);
+    slabsCmd->SetRange("n >= 1");
+    slabsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 DetectorMessenger::~DetectorMessenger()
 {
     delete materialCmd;
     delete thicknessCmd;
+    delete storeHitsCmd;
+    delete addLayerCmd;
+    delete clearLayersCmd;
+    delete slabsCmd;
     delete detectorDir;
 }
 
@@ -68,4 +110,30 @@ void DetectorMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
             detectorConstruction->SetThickness(thickness);
         }
     }
-}
\ No newline at end of file
+
+    else if (command == storeHitsCmd)
+    {
+        detectorConstruction->SetStoreHits(storeHitsCmd->GetNewBoolValue(newValue));
+    }
+
+    else if (command == addLayerCmd)
+    {
+        G4String material, unit;
+        G4double value;
+        std::istringstream is(newValue);
+        is >> material >> value >> unit;
+        detectorConstruction->AddLayer(material, value * G4UIcommand::ValueOf(unit));
+        G4cout << "Capa añadida: " << material << " " << value << " " << unit << " (total "
+               << detectorConstruction->GetThickness() / cm << " cm)" << G4endl;
+    }
+
+    else if (command == clearLayersCmd)
+    {
+        detectorConstruction->ClearLayers();
+    }
+
+    else if (command == slabsCmd)
+    {
+        detectorConstruction->SetSlabs(slabsCmd->GetNewIntValue(newValue));
+    }
+}
@@ -0,0 +1,184 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "EnergyTally.hh"
+#include "EnergyTallyMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+EnergyBinning::EnergyBinning()
+    : outputFile("../results/energy_transmission.csv"), spectrumBins(200), spectrumMax(2. * MeV),
+      spectrumFile("../results/detector_spectrum.csv")
+{
+  messenger = new EnergyTallyMessenger(this);
+}
+
+EnergyBinning::~EnergyBinning()
+{
+  delete messenger;
+}
+
+void EnergyBinning::SetBins(G4int n, G4double emin, G4double emax, G4bool logScale)
+{
+  edges.resize(n + 1);
+  for (G4int i = 0; i <= n; ++i)
+  {
+    G4double f = static_cast<G4double>(i) / n;
+    edges[i] = logScale ? emin * std::pow(emax / emin, f) : emin + f * (emax - emin);
+  }
+}
+
+EnergyTally::EnergyTally(const G4String &name, const EnergyBinning *bin)
+    : G4VAccumulable(name), binning(bin), dropped(0.)
+{
+}
+
+void EnergyTally::Configure()
+{
+  edges = binning ? binning->GetEdges() : std::vector<G4double>();
+  bins.assign(edges.empty() ? 0 : edges.size() - 1, Bin());
+  for (std::size_t i = 0; i < bins.size(); ++i)
+  {
+    bins[i].low = edges[i];
+    bins[i].high = edges[i + 1];
+  }
+}
+
+EnergyTally::Bin *EnergyTally::Find(G4double energy)
+{
+  if (!edges.empty())
+  {
+    // Búsqueda binaria sobre los bordes; sin reservas de memoria
+    auto it = std::upper_bound(edges.begin(), edges.end(), energy);
+    if (it == edges.begin() || it == edges.end())
+      return nullptr;
+    return &bins[it - edges.begin() - 1];
+  }
+
+  auto it = lines.find(energy);
+  if (it != lines.end())
+    return &it->second;
+  if (lines.size() >= maxLines)
+  {
+    // Un aviso por proceso (no por hilo ni por evento): los eventos que no
+    // caben se cuentan en dropped
+    static std::atomic<G4bool> warned{false};
+    if (!warned.exchange(true))
+      G4cerr << GetName() << ": más de " << maxLines << " energías primarias distintas; las nuevas no se"
+             << " cuentan por energía. Para un espectro continuo define bins con /tally/energyBins" << G4endl;
+    return nullptr;
+  }
+  Bin &bin = lines[energy];
+  bin.low = bin.high = energy;
+  return &bin;
+}
+
+void EnergyTally::AddEvent(G4double energy)
+{
+  if (Bin *bin = Find(energy))
+    bin->events += 1.;
+  else
+    dropped += 1.;
+}
+
+void EnergyTally::AddTransmitted(G4double energy, G4double weight)
+{
+  if (Bin *bin = Find(energy))
+  {
+    bin->sumW += weight;
+    bin->sumW2 += weight * weight;
+  }
+}
+
+void EnergyTally::Merge(const G4VAccumulable &other)
+{
+  const auto &tally = static_cast<const EnergyTally &>(other);
+  for (std::size_t i = 0; i < bins.size() && i < tally.bins.size(); ++i)
+  {
+    bins[i].events += tally.bins[i].events;
+    bins[i].sumW += tally.bins[i].sumW;
+    bins[i].sumW2 += tally.bins[i].sumW2;
+  }
+  for (const auto &entry : tally.lines)
+  {
+    Bin &bin = lines[entry.first];
+    bin.low = bin.high = entry.first;
+    bin.events += entry.second.events;
+    bin.sumW += entry.second.sumW;
+    bin.sumW2 += entry.second.sumW2;
+  }
+  dropped += tally.dropped;
+}
+
+void EnergyTally::Reset()
+{
+  for (auto &bin : bins)
+    bin.events = bin.sumW = bin.sumW2 = 0.;
+  lines.clear();
+  dropped = 0.;
+}
+
+void EnergyTally::Print(G4PrintOptions) const
+{
+  G4cout << GetName() << ": " << GetBins().size() << " bins de energía";
+  if (dropped > 0.)
+    G4cout << " (" << dropped << " eventos fuera de rango o del límite de líneas)";
+  G4cout << G4endl;
+}
+
+std::vector<EnergyTally::Bin> EnergyTally::GetBins() const
+{
+  std::vector<Bin> result;
+  for (const auto &bin : bins)
+    if (bin.events > 0.)
+      result.push_back(bin);
+  for (const auto &entry : lines)
+    result.push_back(entry.second);
+  return result;
+}
+
+DetectorSpectrum::DetectorSpectrum(const G4String &name, const EnergyBinning *bin)
+    : G4VAccumulable(name), binning(bin), inverseWidth(0.)
+{
+}
+
+void DetectorSpectrum::Configure()
+{
+  G4int n = binning ? binning->GetSpectrumBins() : 0;
+  if (n <= 0 || binning->GetSpectrumMax() <= 0.)
+  {
+    uncollided.clear();
+    scattered.clear();
+    inverseWidth = 0.;
+    return;
+  }
+  inverseWidth = n / binning->GetSpectrumMax();
+  uncollided.assign(n + 1, 0.);
+  scattered.assign(n + 1, 0.);
+}
+
+void DetectorSpectrum::Merge(const G4VAccumulable &other)
+{
+  const auto &spectrum = static_cast<const DetectorSpectrum &>(other);
+  for (std::size_t i = 0; i < uncollided.size() && i < spectrum.uncollided.size(); ++i)
+  {
+    uncollided[i] += spectrum.uncollided[i];
+    scattered[i] += spectrum.scattered[i];
+  }
+}
+
+void DetectorSpectrum::Reset()
+{
+  std::fill(uncollided.begin(), uncollided.end(), 0.);
+  std::fill(scattered.begin(), scattered.end(), 0.);
+}
+
+void DetectorSpectrum::Print(G4PrintOptions) const
+{
+  G4cout << GetName() << ": " << GetNumberOfBins() << " bins de " << GetBinWidth() / keV << " keV" << G4endl;
+}
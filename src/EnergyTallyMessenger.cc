@@ -0,0 +1,122 @@
+#include "EnergyTallyMessenger.hh"
+#include "EnergyTally.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include <sstream>
+
+EnergyTallyMessenger::EnergyTallyMessenger(EnergyBinning *bin)
+    : G4UImessenger(), binning(bin)
+{
+    // Crear directorio de comandos
+    tallyDir = new G4UIdirectory("/tally/");
+    tallyDir->SetGuidance("Transmisión por bin de energía primaria y espectro del detector");
+
+    energyBinsCmd = new G4UIcommand("/tally/energyBins", this);
+    energyBinsCmd->SetGuidance("Bins de energía para espectros continuos");
+    energyBinsCmd->SetGuidance("Ej: /tally/energyBins 50 10 150 keV lin");
+    auto nParam = new G4UIparameter("n", 'i', false);
+    nParam->SetParameterRange("n > 0");
+    energyBinsCmd->SetParameter(nParam);
+    energyBinsCmd->SetParameter(new G4UIparameter("emin", 'd', false));
+    energyBinsCmd->SetParameter(new G4UIparameter("emax", 'd', false));
+    auto unitParam = new G4UIparameter("unit", 's', true);
+    unitParam->SetDefaultValue("keV");
+    energyBinsCmd->SetParameter(unitParam);
+    auto scaleParam = new G4UIparameter("scale", 's', true);
+    scaleParam->SetDefaultValue("lin");
+    scaleParam->SetParameterCandidates("lin log");
+    energyBinsCmd->SetParameter(scaleParam);
+    energyBinsCmd->SetToBeBroadcasted(false);
+    energyBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    linesCmd = new G4UIcmdWithoutParameter("/tally/lines", this);
+    linesCmd->SetGuidance("Un bin por cada energía primaria distinta (por defecto; fuentes de líneas)");
+    linesCmd->SetToBeBroadcasted(false);
+    linesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    outputCmd = new G4UIcmdWithAString("/tally/output", this);
+    outputCmd->SetGuidance("CSV al que se añaden los bins de cada run");
+    outputCmd->SetParameterName("file", false);
+    outputCmd->SetToBeBroadcasted(false);
+    outputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    spectrumBinsCmd = new G4UIcommand("/tally/spectrumBins", this);
+    spectrumBinsCmd->SetGuidance("Espectro de energía de los fotones que entran en el detector");
+    spectrumBinsCmd->SetGuidance("(sin colisión / dispersados). 0 bins lo desactiva.");
+    spectrumBinsCmd->SetGuidance("Ej: /tally/spectrumBins 200 2 MeV");
+    auto binsParam = new G4UIparameter("n", 'i', false);
+    binsParam->SetParameterRange("n >= 0");
+    spectrumBinsCmd->SetParameter(binsParam);
+    auto maxParam = new G4UIparameter("emax", 'd', true);
+    maxParam->SetDefaultValue(2.);
+    spectrumBinsCmd->SetParameter(maxParam);
+    auto maxUnitParam = new G4UIparameter("unit", 's', true);
+    maxUnitParam->SetDefaultValue("MeV");
+    spectrumBinsCmd->SetParameter(maxUnitParam);
+    spectrumBinsCmd->SetToBeBroadcasted(false);
+    spectrumBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    spectrumOutputCmd = new G4UIcmdWithAString("/tally/spectrumOutput", this);
+    spectrumOutputCmd->SetGuidance("CSV al que se añade el espectro del detector de cada run");
+    spectrumOutputCmd->SetParameterName("file", false);
+    spectrumOutputCmd->SetToBeBroadcasted(false);
+    spectrumOutputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+EnergyTallyMessenger::~EnergyTallyMessenger()
+{
+    delete energyBinsCmd;
+    delete linesCmd;
+    delete outputCmd;
+    delete spectrumBinsCmd;
+    delete spectrumOutputCmd;
+    delete tallyDir;
+}
+
+void EnergyTallyMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == energyBinsCmd)
+    {
+        G4int n;
+        G4double emin, emax;
+        G4String unit, scale;
+        std::istringstream is(newValue);
+        is >> n >> emin >> emax >> unit >> scale;
+        G4double value = G4UIcommand::ValueOf(unit);
+        if (emax <= emin || (scale == "log" && emin <= 0.))
+        {
+            G4cerr << "/tally/energyBins: rango de energías no válido" << G4endl;
+            return;
+        }
+        binning->SetBins(n, emin * value, emax * value, scale == "log");
+    }
+    else if (command == linesCmd)
+    {
+        binning->ClearBins();
+    }
+    else if (command == outputCmd)
+    {
+        binning->SetOutputFile(newValue);
+    }
+    else if (command == spectrumBinsCmd)
+    {
+        G4int n;
+        G4double emax;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> n >> emax >> unit;
+        if (n > 0 && emax <= 0.)
+        {
+            G4cerr << "/tally/spectrumBins: energía máxima no válida" << G4endl;
+            return;
+        }
+        binning->SetSpectrumBins(n, emax * G4UIcommand::ValueOf(unit));
+    }
+    else if (command == spectrumOutputCmd)
+    {
+        binning->SetSpectrumFile(newValue);
+    }
+}
@@ -1,50 +1,76 @@
 #include "EventAction.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4SDManager.hh"
-#include "MiHit.hh"
+#include "G4RunManager.hh"
+#include "MiSensitiveDetector.hh"
+#include "PerformanceMonitor.hh"
 #include "G4ios.hh"
 
 EventAction::EventAction(RunAction *runAct)
-    : G4UserEventAction(), runAction(runAct)
+    : G4UserEventAction(), runAction(runAct), detectorSD(nullptr), skipped(false)
 {
-  outputFile.open("../results/event_data.csv", std::ios::out); // sobrescribe cada corrida
-  if (!outputFile.is_open())
-    G4Exception("EventAction", "001", FatalException, "Cannot open output file");
+  // La salida por evento la gestiona RunAction (búfer por hilo + EventWriter)
 }
 
 EventAction::~EventAction()
 {
-  if (outputFile.is_open())
-    outputFile.close();
   G4cout << "EventAction deleted " << this << G4endl;
 }
 
 void EventAction::BeginOfEventAction(const G4Event *event)
 {
-  // nada costoso o dependiente de objetos externos
+  // /run/beamToPrecision: otro hilo ya alcanzó la precisión; el evento no
+  // se transporta ni se cuenta, y este hilo deja de pedir más
+  skipped = runAction->PrecisionReached();
+  if (skipped)
+  {
+    auto runManager = G4RunManager::GetRunManager();
+    runManager->AbortRun(true);
+    runManager->AbortEvent();
+    return;
+  }
+
+  // El SD de este hilo se busca una vez; el espectro de entrada lo llena él
+  // mismo sobre el acumulable de este RunAction
+  if (!detectorSD)
+  {
+    detectorSD = static_cast<MiSensitiveDetector *>(
+        G4SDManager::GetSDMpointer()->FindSensitiveDetector("MyDetectorSD", false));
+    if (detectorSD)
+      detectorSD->SetSpectrum(runAction->GetDetectorSpectrum());
+  }
 }
 
 void EventAction::EndOfEventAction(const G4Event *event)
 {
+  if (skipped)
+    return;
+
   G4int eventID = event->GetEventID();
   G4int detected = 0;
 
-  G4HCofThisEvent *HCE = event->GetHCofThisEvent();
-  if (HCE)
+  G4double primaryEnergy = 0.;
+  if (event->GetPrimaryVertex() && event->GetPrimaryVertex()->GetPrimary())
+    primaryEnergy = event->GetPrimaryVertex()->GetPrimary()->GetKineticEnergy();
+  runAction->AddEvent(primaryEnergy);
+  if (runAction->GetLayerTally()->IsActive())
+    runAction->GetLayerTally()->EndEvent();
+
+  // Puntuación del SD de este hilo (sin recorrer colecciones de hits)
+  G4double edep = 0., entryEnergy = 0.;
+  if (detectorSD && detectorSD->GetEventScore().hit)
   {
-    G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID("DetectorHitsCollection");
-    if (hcID >= 0)
-    {
-      auto hitsCollection = static_cast<MiHitsCollection *>(HCE->GetHC(hcID));
-      if (hitsCollection && hitsCollection->GetSize() > 0)
-      {
-        detected = 1;
-        // aaa
-        runAction->AddTransmittedEvent();
-      }
-    }
+    detected = 1;
+    const DetectorScore &score = detectorSD->GetEventScore();
+    runAction->AddTransmittedEvent(primaryEnergy, score.weight, score.uncollidedWeight);
+    edep = score.edep;
+    entryEnergy = score.entryEnergy;
   }
 
-  outputFile << eventID << " , " << detected << "\n";
+  runAction->RecordEvent(eventID, detected, edep, entryEnergy, primaryEnergy);
+  runAction->CheckPrecision();
+  GAMMAATT_PERF_EVENT();
 }
\ No newline at end of file
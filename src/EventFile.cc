@@ -0,0 +1,250 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "EventFile.hh"
+#include <cstring>
+
+#ifdef GAMMAATT_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace EventFile
+{
+  static const char kFileMagic[8] = {'G', 'A', 'E', 'V', 'T', '0', '0', '1'};
+  static const char kBlockMagic[4] = {'B', 'L', 'K', '1'};
+
+  std::size_t TypeWidth(ColumnType type)
+  {
+    switch (type)
+    {
+    case kInt32:
+      return 4;
+    case kUInt8:
+      return 1;
+    case kFloat32:
+      return 4;
+    }
+    return 0;
+  }
+
+  const std::vector<Column> &EventColumns()
+  {
+    static const std::vector<Column> columns = {
+        {"runID", kInt32},
+        {"eventID", kInt32},
+        {"detected", kUInt8},
+        {"edep_keV", kFloat32},
+        {"entryEnergy_keV", kFloat32},
+        {"primaryEnergy_keV", kFloat32}};
+    return columns;
+  }
+
+  bool CompressionAvailable()
+  {
+#ifdef GAMMAATT_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void Block::Reserve(std::size_t n)
+  {
+    runID.reserve(n);
+    eventID.reserve(n);
+    detected.reserve(n);
+    edep.reserve(n);
+    entryEnergy.reserve(n);
+    primaryEnergy.reserve(n);
+  }
+
+  void Block::Clear()
+  {
+    // clear() conserva la capacidad: no hay reservas nuevas al reutilizar el bloque
+    runID.clear();
+    eventID.clear();
+    detected.clear();
+    edep.clear();
+    entryEnergy.clear();
+    primaryEnergy.clear();
+  }
+
+  template <typename T>
+  static void Append(std::vector<char> &out, const std::vector<T> &column)
+  {
+    const char *bytes = reinterpret_cast<const char *>(column.data());
+    out.insert(out.end(), bytes, bytes + column.size() * sizeof(T));
+  }
+
+  template <typename T>
+  static const char *Extract(const char *data, std::size_t nRows, std::vector<T> &column)
+  {
+    column.resize(nRows);
+    std::memcpy(column.data(), data, nRows * sizeof(T));
+    return data + nRows * sizeof(T);
+  }
+
+  void Block::Pack(std::vector<char> &out) const
+  {
+    out.clear();
+    Append(out, runID);
+    Append(out, eventID);
+    Append(out, detected);
+    Append(out, edep);
+    Append(out, entryEnergy);
+    Append(out, primaryEnergy);
+  }
+
+  bool Block::Unpack(const char *data, std::size_t nRows)
+  {
+    data = Extract(data, nRows, runID);
+    data = Extract(data, nRows, eventID);
+    data = Extract(data, nRows, detected);
+    data = Extract(data, nRows, edep);
+    data = Extract(data, nRows, entryEnergy);
+    Extract(data, nRows, primaryEnergy);
+    return true;
+  }
+
+  static std::size_t RowWidth(const std::vector<Column> &columns)
+  {
+    std::size_t width = 0;
+    for (const auto &c : columns)
+      width += TypeWidth(c.type);
+    return width;
+  }
+
+  bool WriteHeader(std::FILE *file)
+  {
+    const auto &columns = EventColumns();
+    std::uint32_t nColumns = columns.size();
+    if (std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file) != sizeof(kFileMagic))
+      return false;
+    std::fwrite(&nColumns, sizeof(nColumns), 1, file);
+    for (const auto &c : columns)
+    {
+      std::uint8_t type = c.type;
+      std::uint8_t length = c.name.size();
+      std::fwrite(&type, 1, 1, file);
+      std::fwrite(&length, 1, 1, file);
+      std::fwrite(c.name.data(), 1, length, file);
+    }
+    return !std::ferror(file);
+  }
+
+  bool WriteBlock(std::FILE *file, const Block &block, bool compress)
+  {
+    // Buffers de trabajo del hilo escritor, reutilizados entre bloques
+    static thread_local std::vector<char> packed;
+    static thread_local std::vector<char> compressed;
+
+    block.Pack(packed);
+    const std::vector<char> *payload = &packed;
+    std::uint32_t flags = 0;
+
+#ifdef GAMMAATT_USE_ZLIB
+    if (compress)
+    {
+      uLongf size = compressBound(packed.size());
+      compressed.resize(size);
+      if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &size,
+                    reinterpret_cast<const Bytef *>(packed.data()), packed.size(), Z_BEST_SPEED) == Z_OK)
+      {
+        compressed.resize(size);
+        payload = &compressed;
+        flags |= kCompressed;
+      }
+    }
+#else
+    (void)compress;
+#endif
+
+    std::uint32_t nRows = block.Size();
+    std::uint32_t bytes = payload->size();
+    std::fwrite(kBlockMagic, 1, sizeof(kBlockMagic), file);
+    std::fwrite(&nRows, sizeof(nRows), 1, file);
+    std::fwrite(&flags, sizeof(flags), 1, file);
+    std::fwrite(&bytes, sizeof(bytes), 1, file);
+    std::fwrite(payload->data(), 1, bytes, file);
+    return !std::ferror(file);
+  }
+
+  Reader::Reader(const std::string &path)
+      : file(std::fopen(path.c_str(), "rb")), headerOk(false)
+  {
+    if (!file)
+      return;
+
+    char magic[sizeof(kFileMagic)];
+    std::uint32_t nColumns = 0;
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 ||
+        std::fread(&nColumns, sizeof(nColumns), 1, file) != 1)
+      return;
+
+    for (std::uint32_t i = 0; i < nColumns; ++i)
+    {
+      std::uint8_t type = 0, length = 0;
+      if (std::fread(&type, 1, 1, file) != 1 || std::fread(&length, 1, 1, file) != 1)
+        return;
+      std::string name(length, '\0');
+      if (std::fread(&name[0], 1, length, file) != length)
+        return;
+      columns.push_back({name, static_cast<ColumnType>(type)});
+    }
+
+    // Solo se conoce la versión 001 del esquema
+    const auto &expected = EventColumns();
+    headerOk = (columns.size() == expected.size());
+    for (std::size_t i = 0; headerOk && i < columns.size(); ++i)
+      headerOk = (columns[i].name == expected[i].name && columns[i].type == expected[i].type);
+  }
+
+  Reader::~Reader()
+  {
+    if (file)
+      std::fclose(file);
+  }
+
+  bool Reader::NextBlock(Block &block)
+  {
+    if (!IsOpen())
+      return false;
+
+    char magic[sizeof(kBlockMagic)];
+    std::uint32_t nRows = 0, flags = 0, bytes = 0;
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        std::memcmp(magic, kBlockMagic, sizeof(magic)) != 0 ||
+        std::fread(&nRows, sizeof(nRows), 1, file) != 1 ||
+        std::fread(&flags, sizeof(flags), 1, file) != 1 ||
+        std::fread(&bytes, sizeof(bytes), 1, file) != 1)
+      return false;
+
+    payload.resize(bytes);
+    if (std::fread(payload.data(), 1, bytes, file) != bytes)
+      return false; // Bloque truncado (p.ej. proceso interrumpido)
+
+    std::size_t expectedBytes = nRows * RowWidth(columns);
+    const std::vector<char> *data = &payload;
+    if (flags & kCompressed)
+    {
+#ifdef GAMMAATT_USE_ZLIB
+      unpacked.resize(expectedBytes);
+      uLongf size = expectedBytes;
+      if (uncompress(reinterpret_cast<Bytef *>(unpacked.data()), &size,
+                     reinterpret_cast<const Bytef *>(payload.data()), bytes) != Z_OK ||
+          size != expectedBytes)
+        return false;
+      data = &unpacked;
+#else
+      return false; // Fichero comprimido pero compilado sin zlib
+#endif
+    }
+    if (data->size() != expectedBytes)
+      return false;
+
+    return block.Unpack(data->data(), nRows);
+  }
+}
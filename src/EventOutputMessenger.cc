@@ -0,0 +1,63 @@
+#include "EventOutputMessenger.hh"
+#include "EventWriter.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+
+EventOutputMessenger::EventOutputMessenger(EventWriter *writer)
+    : G4UImessenger(), eventWriter(writer)
+{
+    // Crear directorio de comandos
+    outputDir = new G4UIdirectory("/output/");
+    outputDir->SetGuidance("Salida por evento");
+
+    sinkCmd = new G4UIcmdWithAString("/output/eventSink", this);
+    sinkCmd->SetGuidance("Formato de la salida por evento");
+    sinkCmd->SetGuidance("  binary: columnar .gaev (por defecto), ver gammaAtt-events");
+    sinkCmd->SetGuidance("  csv:    texto, una fila por evento");
+    sinkCmd->SetGuidance("  none:   sin salida por evento");
+    sinkCmd->SetParameterName("sink", false);
+    sinkCmd->SetCandidates("none csv binary");
+    sinkCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fileCmd = new G4UIcmdWithAString("/output/eventFile", this);
+    fileCmd->SetGuidance("Ruta del fichero por evento, sin extensión");
+    fileCmd->SetParameterName("file", false);
+    fileCmd->SetDefaultValue("../results/event_data");
+    fileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    compressCmd = new G4UIcmdWithABool("/output/compress", this);
+    compressCmd->SetGuidance("Comprime con zlib cada bloque de la salida binaria");
+    compressCmd->SetParameterName("compress", true);
+    compressCmd->SetDefaultValue(true);
+    compressCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+EventOutputMessenger::~EventOutputMessenger()
+{
+    delete sinkCmd;
+    delete fileCmd;
+    delete compressCmd;
+    delete outputDir;
+}
+
+void EventOutputMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == sinkCmd)
+    {
+        if (newValue == "none")
+            eventWriter->SetFormat(EventWriter::Format::None);
+        else if (newValue == "csv")
+            eventWriter->SetFormat(EventWriter::Format::Csv);
+        else
+            eventWriter->SetFormat(EventWriter::Format::Binary);
+    }
+    else if (command == fileCmd)
+    {
+        eventWriter->SetFileName(newValue);
+    }
+    else if (command == compressCmd)
+    {
+        eventWriter->SetCompression(compressCmd->GetNewBoolValue(newValue));
+    }
+}
@@ -0,0 +1,43 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "EventSeeder.hh"
+#include "Randomize.hh"
+#include "G4Threading.hh"
+
+std::atomic<G4long> EventSeeder::masterSeed{0};
+std::atomic<G4int> EventSeeder::currentRun{0};
+std::atomic<G4long> EventSeeder::eventOffset{0};
+std::vector<unsigned long> EventSeeder::savedEngine;
+
+void EventSeeder::BeginRun(G4long seed, G4int runID, G4long firstEvent)
+{
+  masterSeed.store(seed, std::memory_order_relaxed);
+  currentRun.store(runID, std::memory_order_relaxed);
+  eventOffset.store(firstEvent, std::memory_order_relaxed);
+
+  // Con hilos, SeedEvent actúa sobre los motores de los hilos y el maestro
+  // conserva su semilla; en secuencial hay que restaurarlo en EndRun
+  if (!G4Threading::IsMultithreadedApplication())
+    savedEngine = G4Random::getTheEngine()->put();
+}
+
+void EventSeeder::EndRun()
+{
+  if (savedEngine.empty())
+    return;
+  G4Random::getTheEngine()->get(savedEngine);
+  savedEngine.clear();
+}
+
+void EventSeeder::SeedEvent(G4int eventID)
+{
+  std::uint64_t key = EventKey(static_cast<std::uint64_t>(GetMasterSeed()),
+                               currentRun.load(std::memory_order_relaxed), GetEventOffset() + eventID);
+
+  // Dos semillas no nulas (el 0 termina la lista)
+  long seeds[3] = {static_cast<long>(key >> 33) + 1, static_cast<long>((key >> 2) & 0x7fffffff) + 1, 0};
+  G4Random::setTheSeeds(seeds);
+}
@@ -0,0 +1,77 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "EventSink.hh"
+#include "G4ios.hh"
+
+CsvEventSink::CsvEventSink() : file(nullptr) {}
+
+CsvEventSink::~CsvEventSink()
+{
+  Close();
+}
+
+G4bool CsvEventSink::Open(const G4String &path)
+{
+  file = std::fopen(path.c_str(), "w");
+  if (!file)
+    return false;
+
+  const auto &columns = EventFile::EventColumns();
+  for (std::size_t i = 0; i < columns.size(); ++i)
+    std::fprintf(file, "%s%s", i ? "," : "", columns[i].name.c_str());
+  std::fprintf(file, "\n");
+  return true;
+}
+
+void CsvEventSink::Write(const EventFile::Block &block)
+{
+  for (std::size_t i = 0; i < block.Size(); ++i)
+    std::fprintf(file, "%d,%d,%u,%g,%g,%g\n", block.runID[i], block.eventID[i],
+                 static_cast<unsigned>(block.detected[i]), block.edep[i],
+                 block.entryEnergy[i], block.primaryEnergy[i]);
+}
+
+void CsvEventSink::Close()
+{
+  if (file)
+    std::fclose(file);
+  file = nullptr;
+}
+
+BinaryEventSink::BinaryEventSink(G4bool comp) : file(nullptr), compress(comp)
+{
+  if (compress && !EventFile::CompressionAvailable())
+  {
+    G4cerr << "EventSink: compilado sin zlib, la salida binaria no se comprimirá" << G4endl;
+    compress = false;
+  }
+}
+
+BinaryEventSink::~BinaryEventSink()
+{
+  Close();
+}
+
+G4bool BinaryEventSink::Open(const G4String &path)
+{
+  file = std::fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  return EventFile::WriteHeader(file);
+}
+
+void BinaryEventSink::Write(const EventFile::Block &block)
+{
+  if (!EventFile::WriteBlock(file, block, compress))
+    G4cerr << "EventSink: error escribiendo bloque de eventos" << G4endl;
+}
+
+void BinaryEventSink::Close()
+{
+  if (file)
+    std::fclose(file);
+  file = nullptr;
+}
@@ -0,0 +1,176 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "EventWriter.hh"
+#include "EventSink.hh"
+#include "EventOutputMessenger.hh"
+#include "Sharding.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+EventWriter::EventWriter()
+    : format(Format::Binary), fileName("../results/event_data"), compress(false),
+      sink(nullptr), writing(false), stopping(false)
+{
+  messenger = new EventOutputMessenger(this);
+}
+
+EventWriter::~EventWriter()
+{
+  Stop();
+  delete messenger;
+}
+
+void EventWriter::SetFormat(Format value)
+{
+  Stop(); // El siguiente run abre un fichero nuevo con la nueva configuración
+  format = value;
+}
+
+void EventWriter::SetFileName(const G4String &value)
+{
+  Stop();
+  fileName = value;
+}
+
+void EventWriter::SetCompression(G4bool value)
+{
+  Stop();
+  compress = value;
+}
+
+void EventWriter::Start()
+{
+  if (sink || format == Format::None)
+    return;
+
+  if (format == Format::Csv)
+    sink = new CsvEventSink();
+  else
+    sink = new BinaryEventSink(compress);
+
+  // Con --shard cada fragmento escribe su propio fichero (se concatenan después)
+  G4String path = fileName + Sharding::Suffix() + sink->GetExtension();
+  if (!sink->Open(path))
+  {
+    G4cerr << "EventWriter: no se puede abrir " << path << "; salida por evento desactivada" << G4endl;
+    delete sink;
+    sink = nullptr;
+    format = Format::None;
+    return;
+  }
+  G4cout << "EventWriter: salida por evento en " << path << G4endl;
+
+  stopping = false;
+  writerThread = std::thread(&EventWriter::Loop, this);
+}
+
+void EventWriter::Submit(EventBlockSlot *slot)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(slot);
+  }
+  pending.notify_one();
+}
+
+void EventWriter::Flush()
+{
+  if (!sink)
+    return;
+  std::unique_lock<std::mutex> lock(mutex);
+  drained.wait(lock, [this] { return queue.empty() && !writing; });
+}
+
+void EventWriter::Stop()
+{
+  if (!sink)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  pending.notify_one();
+  writerThread.join();
+
+  sink->Close();
+  delete sink;
+  sink = nullptr;
+}
+
+void EventWriter::Loop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    pending.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (queue.empty())
+      break; // stopping y sin trabajo pendiente
+
+    EventBlockSlot *slot = queue.front();
+    queue.pop_front();
+    writing = true;
+
+    // La escritura se hace sin el cerrojo: los hilos pueden seguir entregando
+    lock.unlock();
+    sink->Write(slot->block);
+    slot->busy.store(false, std::memory_order_release);
+    lock.lock();
+
+    writing = false;
+    if (queue.empty())
+      drained.notify_all();
+  }
+}
+
+EventBuffer::EventBuffer(EventWriter *w, std::size_t size)
+    : writer(w), blockSize(size), active(0)
+{
+  slots[0].block.Reserve(blockSize);
+  slots[1].block.Reserve(blockSize);
+}
+
+EventBuffer::~EventBuffer()
+{
+  // No destruir un bloque que el escritor aún está usando
+  for (auto &slot : slots)
+    while (slot.busy.load(std::memory_order_acquire))
+      std::this_thread::yield();
+}
+
+void EventBuffer::Add(G4int runID, G4int eventID, G4bool detected, G4double edep,
+                      G4double entryEnergy, G4double primaryEnergy)
+{
+  if (!writer || !writer->IsEnabled())
+    return;
+
+  auto &block = slots[active].block;
+  block.runID.push_back(runID);
+  block.eventID.push_back(eventID);
+  block.detected.push_back(detected ? 1 : 0);
+  block.edep.push_back(edep / keV);
+  block.entryEnergy.push_back(entryEnergy / keV);
+  block.primaryEnergy.push_back(primaryEnergy / keV);
+
+  if (block.Size() >= blockSize)
+    Flush();
+}
+
+void EventBuffer::Flush()
+{
+  auto &slot = slots[active];
+  if (slot.block.Size() == 0)
+    return;
+
+  slot.busy.store(true, std::memory_order_release);
+  writer->Submit(&slot);
+
+  // Cambiar al otro bloque; solo se espera si el escritor va más lento que la simulación
+  active = 1 - active;
+  auto &next = slots[active];
+  while (next.busy.load(std::memory_order_acquire))
+    std::this_thread::yield();
+  next.block.Clear();
+}
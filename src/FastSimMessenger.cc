@@ -0,0 +1,41 @@
+#include "FastSimMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+
+FastSimMessenger::FastSimMessenger(DetectorConstruction *detector)
+    : G4UImessenger(), detectorConstruction(detector)
+{
+    // Crear directorio de comandos (/fast/ es el modo de solo transmisión)
+    fastSimDir = new G4UIdirectory("/fastsim/");
+    fastSimDir->SetGuidance("Modelo rápido del absorbente (requiere arrancar con --fastsim)");
+
+    enableCmd = new G4UIcmdWithABool("/fastsim/enable", this);
+    enableCmd->SetGuidance("Muestrea el destino de cada fotón en el absorbente (absorbido, sin colisión o");
+    enableCmd->SetGuidance("dispersado) en lugar de transportarlo paso a paso");
+    enableCmd->SetGuidance("false vuelve al transporte completo, por ejemplo para validar el modelo");
+    enableCmd->SetParameterName("enable", true);
+    enableCmd->SetDefaultValue(true);
+    enableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+FastSimMessenger::~FastSimMessenger()
+{
+    delete enableCmd;
+    delete fastSimDir;
+}
+
+void FastSimMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == enableCmd)
+    {
+        detectorConstruction->SetFastSimActive(enableCmd->GetNewBoolValue(newValue));
+    }
+}
+
+G4String FastSimMessenger::GetCurrentValue(G4UIcommand *command)
+{
+    if (command == enableCmd)
+        return enableCmd->ConvertToString(detectorConstruction->UsesFastSimModel());
+    return "";
+}
@@ -0,0 +1,60 @@
+#include "FastTrackingMessenger.hh"
+#include "SteppingAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+FastTrackingMessenger::FastTrackingMessenger(SteppingAction *stepping)
+    : G4UImessenger(), steppingAction(stepping)
+{
+    // Crear directorio de comandos
+    fastDir = new G4UIdirectory("/fast/");
+    fastDir->SetGuidance("Modo rápido de solo transmisión");
+
+    enableCmd = new G4UIcmdWithABool("/fast/enable", this);
+    enableCmd->SetGuidance("Termina cada evento en cuanto se decide si hay transmisión");
+    enableCmd->SetParameterName("enable", true);
+    enableCmd->SetDefaultValue(true);
+    enableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    killEscapingCmd = new G4UIcmdWithABool("/fast/killEscaping", this);
+    killEscapingCmd->SetGuidance("Elimina partículas en el aire que ya no pueden alcanzar el detector");
+    killEscapingCmd->SetGuidance("Desactivado por defecto: desprecia la retrodispersión en el aire y puede cambiar la transmisión");
+    killEscapingCmd->SetParameterName("kill", true);
+    killEscapingCmd->SetDefaultValue(true);
+    killEscapingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    electronRangeCmd = new G4UIcmdWithADoubleAndUnit("/fast/electronRangeCut", this);
+    electronRangeCmd->SetGuidance("Descarta electrones creados en el absorbente con alcance menor que este valor");
+    electronRangeCmd->SetGuidance("0 desactiva el corte (por defecto)");
+    electronRangeCmd->SetParameterName("range", false);
+    electronRangeCmd->SetDefaultUnit("mm");
+    electronRangeCmd->SetUnitCategory("Length");
+    electronRangeCmd->SetRange("range >= 0");
+    electronRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+FastTrackingMessenger::~FastTrackingMessenger()
+{
+    delete enableCmd;
+    delete killEscapingCmd;
+    delete electronRangeCmd;
+    delete fastDir;
+}
+
+void FastTrackingMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == enableCmd)
+    {
+        steppingAction->SetFastMode(enableCmd->GetNewBoolValue(newValue));
+    }
+    else if (command == killEscapingCmd)
+    {
+        steppingAction->SetKillEscaping(killEscapingCmd->GetNewBoolValue(newValue));
+    }
+    else if (command == electronRangeCmd)
+    {
+        steppingAction->SetElectronRangeCut(electronRangeCmd->GetNewDoubleValue(newValue));
+    }
+}
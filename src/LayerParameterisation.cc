@@ -0,0 +1,41 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "LayerParameterisation.hh"
+#include "G4Box.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ThreeVector.hh"
+
+LayerParameterisation::LayerParameterisation(G4double hxy, G4double zLow, const std::vector<G4double> &thicknesses,
+                                             const std::vector<G4Material *> &mats)
+    : G4VPVParameterisation(), halfXY(hxy), materials(mats)
+{
+  G4double z = zLow;
+  for (G4double t : thicknesses)
+  {
+    centres.push_back(z + t / 2.0);
+    halfZ.push_back(t / 2.0);
+    z += t;
+  }
+}
+
+void LayerParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume *physVol) const
+{
+  physVol->SetTranslation(G4ThreeVector(0, 0, centres[copyNo]));
+  physVol->SetRotation(nullptr);
+}
+
+void LayerParameterisation::ComputeDimensions(G4Box &box, const G4int copyNo, const G4VPhysicalVolume *) const
+{
+  box.SetXHalfLength(halfXY);
+  box.SetYHalfLength(halfXY);
+  box.SetZHalfLength(halfZ[copyNo]);
+}
+
+// El navegador asigna este material al volumen lógico compartido al entrar en la capa
+G4Material *LayerParameterisation::ComputeMaterial(const G4int copyNo, G4VPhysicalVolume *, const G4VTouchable *)
+{
+  return materials[copyNo];
+}
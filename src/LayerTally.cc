@@ -0,0 +1,61 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "LayerTally.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4ios.hh"
+#include <algorithm>
+
+LayerTally::LayerTally(const G4String &name)
+    : G4VAccumulable(name), tolerance(0.)
+{
+}
+
+void LayerTally::Configure(const std::vector<G4double> &faces)
+{
+  backFaces = faces;
+  tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  eventWeight.assign(backFaces.size(), 0.);
+  touched.clear();
+  sumW.assign(backFaces.size(), 0.);
+  sumW2.assign(backFaces.size(), 0.);
+}
+
+void LayerTally::EndEvent()
+{
+  for (G4int layer : touched)
+  {
+    G4double w = eventWeight[layer];
+    sumW[layer] += w;
+    sumW2[layer] += w * w;
+    eventWeight[layer] = 0.;
+  }
+  touched.clear();
+}
+
+void LayerTally::Merge(const G4VAccumulable &other)
+{
+  const auto &tally = static_cast<const LayerTally &>(other);
+  if (tally.sumW.size() != sumW.size())
+    return;
+  for (std::size_t i = 0; i < sumW.size(); ++i)
+  {
+    sumW[i] += tally.sumW[i];
+    sumW2[i] += tally.sumW2[i];
+  }
+}
+
+void LayerTally::Reset()
+{
+  std::fill(sumW.begin(), sumW.end(), 0.);
+  std::fill(sumW2.begin(), sumW2.end(), 0.);
+  std::fill(eventWeight.begin(), eventWeight.end(), 0.);
+  touched.clear();
+}
+
+void LayerTally::Print(G4PrintOptions) const
+{
+  G4cout << GetName() << ": " << backFaces.size() << " capas" << G4endl;
+}
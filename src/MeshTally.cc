@@ -0,0 +1,158 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "MeshTally.hh"
+#include "MeshTallyMessenger.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4Gamma.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MeshConfig::MeshConfig()
+    : nx(0), ny(0), nz(0), outputBase("../results/mesh")
+{
+  messenger = new MeshTallyMessenger(this);
+}
+
+MeshConfig::~MeshConfig()
+{
+  delete messenger;
+}
+
+MeshTally::MeshTally(const G4String &name, const MeshConfig *conf)
+    : G4VAccumulable(name), config(conf), nx(0), ny(0), nz(0)
+{
+}
+
+void MeshTally::Configure(const G4ThreeVector &halfSize)
+{
+  if (!config || !config->IsActive())
+  {
+    nx = ny = nz = 0;
+    edep.clear();
+    fluence.clear();
+    return;
+  }
+
+  nx = config->GetNx();
+  ny = config->GetNy();
+  nz = config->GetNz();
+  low = -halfSize;
+  voxelSize = G4ThreeVector(2. * halfSize.x() / nx, 2. * halfSize.y() / ny, 2. * halfSize.z() / nz);
+  inverseSize = G4ThreeVector(1. / voxelSize.x(), 1. / voxelSize.y(), 1. / voxelSize.z());
+
+  // Mismo tamaño en todos los hilos: Merge suma elemento a elemento
+  std::size_t n = static_cast<std::size_t>(nx) * ny * nz;
+  edep.assign(n, 0.);
+  fluence.assign(n, 0.);
+}
+
+void MeshTally::Score(const G4Step *step)
+{
+  const G4StepPoint *pre = step->GetPreStepPoint();
+  const G4StepPoint *post = step->GetPostStepPoint();
+  const G4ThreeVector &p0 = pre->GetPosition();
+  const G4ThreeVector &p1 = post->GetPosition();
+  G4double weight = pre->GetWeight();
+
+  // Dosis: todo el depósito del paso al vóxel de su punto medio
+  G4double deposit = step->GetTotalEnergyDeposit();
+  if (deposit > 0.)
+  {
+    G4ThreeVector mid = 0.5 * (p0 + p1) - low;
+    G4int ix = std::min(std::max(static_cast<G4int>(mid.x() * inverseSize.x()), 0), nx - 1);
+    G4int iy = std::min(std::max(static_cast<G4int>(mid.y() * inverseSize.y()), 0), ny - 1);
+    G4int iz = std::min(std::max(static_cast<G4int>(mid.z() * inverseSize.z()), 0), nz - 1);
+    edep[Index(ix, iy, iz)] += deposit * weight;
+  }
+
+  // Fluencia: solo fotones
+  if (step->GetTrack()->GetDefinition() == G4Gamma::Definition())
+    AddTrackLength(p0, p1, weight);
+}
+
+void MeshTally::AddTrackLength(const G4ThreeVector &start, const G4ThreeVector &end, G4double weight)
+{
+  G4ThreeVector delta = end - start;
+  G4double length = delta.mag();
+  if (length <= 0.)
+    return;
+
+  // Coordenadas en unidades de vóxel; el paso se recorre con t en [0, 1]
+  G4double u[3] = {(start.x() - low.x()) * inverseSize.x(), (start.y() - low.y()) * inverseSize.y(),
+                   (start.z() - low.z()) * inverseSize.z()};
+  G4double du[3] = {delta.x() * inverseSize.x(), delta.y() * inverseSize.y(), delta.z() * inverseSize.z()};
+  const G4int n[3] = {nx, ny, nz};
+
+  G4int index[3], stepDir[3];
+  G4double tMax[3], tDelta[3];
+  const G4double infinity = std::numeric_limits<G4double>::infinity();
+  for (G4int a = 0; a < 3; ++a)
+  {
+    // El punto inicial puede estar justo en la cara exterior: se lleva al vóxel del borde
+    index[a] = std::min(std::max(static_cast<G4int>(std::floor(u[a])), 0), n[a] - 1);
+    if (du[a] > 0.)
+    {
+      stepDir[a] = 1;
+      tMax[a] = (index[a] + 1 - u[a]) / du[a];
+      tDelta[a] = 1. / du[a];
+    }
+    else if (du[a] < 0.)
+    {
+      stepDir[a] = -1;
+      tMax[a] = (index[a] - u[a]) / du[a];
+      tDelta[a] = -1. / du[a];
+    }
+    else
+    {
+      stepDir[a] = 0;
+      tMax[a] = infinity;
+      tDelta[a] = infinity;
+    }
+  }
+
+  // Amanatides-Woo: avanza siempre por el eje cuya frontera se alcanza antes
+  G4double t = 0.;
+  G4double scale = length * weight;
+  while (true)
+  {
+    G4int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+    G4double tNext = std::min(tMax[axis], 1.);
+    if (tNext > t)
+      fluence[Index(index[0], index[1], index[2])] += (tNext - t) * scale;
+    if (tNext >= 1.)
+      break;
+    t = tNext;
+    index[axis] += stepDir[axis];
+    if (index[axis] < 0 || index[axis] >= n[axis])
+      break; // Sale de la malla (redondeo en la cara del absorbente)
+    tMax[axis] += tDelta[axis];
+  }
+}
+
+void MeshTally::Merge(const G4VAccumulable &other)
+{
+  const auto &mesh = static_cast<const MeshTally &>(other);
+  if (mesh.edep.size() != edep.size())
+    return;
+  for (std::size_t i = 0; i < edep.size(); ++i)
+    edep[i] += mesh.edep[i];
+  for (std::size_t i = 0; i < fluence.size(); ++i)
+    fluence[i] += mesh.fluence[i];
+}
+
+void MeshTally::Reset()
+{
+  std::fill(edep.begin(), edep.end(), 0.);
+  std::fill(fluence.begin(), fluence.end(), 0.);
+}
+
+void MeshTally::Print(G4PrintOptions) const
+{
+  G4cout << GetName() << ": malla " << nx << "x" << ny << "x" << nz << G4endl;
+}
@@ -0,0 +1,56 @@
+#include "MeshTallyMessenger.hh"
+#include "MeshTally.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include <sstream>
+
+MeshTallyMessenger::MeshTallyMessenger(MeshConfig *conf)
+    : G4UImessenger(), config(conf)
+{
+    // Los nombres no coinciden con los de la puntuación por comandos de
+    // Geant4 (/score/create/..., /score/mesh/...), que comparte el directorio
+    scoreDir = new G4UIdirectory("/score/");
+    scoreDir->SetGuidance("Malla de dosis y fluencia superpuesta al absorbente");
+
+    voxelsCmd = new G4UIcommand("/score/voxels", this);
+    voxelsCmd->SetGuidance("Vóxeles de la malla en x, y, z (z = profundidad). 0 0 0 la desactiva.");
+    voxelsCmd->SetGuidance("Ej: /score/voxels 100 100 100");
+    for (const char *axis : {"nx", "ny", "nz"})
+    {
+        auto param = new G4UIparameter(axis, 'i', false);
+        param->SetParameterRange(G4String(axis) + " >= 0");
+        voxelsCmd->SetParameter(param);
+    }
+    voxelsCmd->SetToBeBroadcasted(false);
+    voxelsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    outputCmd = new G4UIcmdWithAString("/score/meshOutput", this);
+    outputCmd->SetGuidance("Prefijo de los ficheros de la malla (<prefijo>_run<N>.gamesh, _depth.csv, .root)");
+    outputCmd->SetParameterName("base", false);
+    outputCmd->SetToBeBroadcasted(false);
+    outputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+MeshTallyMessenger::~MeshTallyMessenger()
+{
+    delete voxelsCmd;
+    delete outputCmd;
+    delete scoreDir;
+}
+
+void MeshTallyMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == voxelsCmd)
+    {
+        G4int nx = 0, ny = 0, nz = 0;
+        std::istringstream is(newValue);
+        is >> nx >> ny >> nz;
+        config->SetVoxels(nx, ny, nz);
+    }
+    else if (command == outputCmd)
+    {
+        config->SetOutputBase(newValue);
+    }
+}
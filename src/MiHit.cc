@@ -1,5 +1,6 @@
 #include "MiHit.hh"
 
+G4ThreadLocal G4Allocator<MiHit>* MiHitAllocator = nullptr;
 
 MiHit::MiHit() : G4VHit(), fEdep(0.), fPos(G4ThreeVector()) {}
 MiHit::~MiHit() {}
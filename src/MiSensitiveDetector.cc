@@ -1,11 +1,17 @@
 #include "MiSensitiveDetector.hh"
 #include "MiHit.hh" 
+#include "DetectorConstruction.hh"
+#include "EnergyTally.hh"
+#include "PerformanceMonitor.hh"
 #include "G4Step.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4SDManager.hh"
+#include "G4Gamma.hh"
+#include "G4Track.hh"
+#include <cmath>
 
-MiSensitiveDetector::MiSensitiveDetector(const G4String& name)
-    : G4VSensitiveDetector(name), hitsCollection(nullptr) {
+MiSensitiveDetector::MiSensitiveDetector(const G4String& name, const DetectorConstruction* det)
+    : G4VSensitiveDetector(name), detector(det), spectrum(nullptr), hitsCollection(nullptr), hcID(-1) {
     
     // Aquí registramos el nombre de la colección de hits
     collectionName.insert("DetectorHitsCollection");
@@ -15,32 +21,64 @@ MiSensitiveDetector::~MiSensitiveDetector() {
     G4cout << "MiSensitiveDetector deleted " << this << G4endl;
 }
 
-void MiSensitiveDetector::Initialize(G4HCofThisEvent* hce) {    
-    hitsCollection = new MiHitsCollection(SensitiveDetectorName, collectionName[0]);
-    
-    G4cout << "MiSensitiveDetector::Initialize: SD name= " << SensitiveDetectorName << " collectionName[0]= " << collectionName[0] << G4endl;
+void MiSensitiveDetector::Initialize(G4HCofThisEvent* hce) {
+    score.Reset();
 
+    // La colección de hits solo hace falta para dibujarlos; en producción el
+    // camino de puntuación no reserva memoria
+    hitsCollection = nullptr;
+    if (!detector->GetStoreHits())
+        return;
 
-    static G4int hcID = -1;
+    hitsCollection = new MiHitsCollection(SensitiveDetectorName, collectionName[0]);
     if (hcID < 0) {
         hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-        G4cout << "MiSensitiveDetector: got hcID = " << hcID << G4endl;
     }
     hce->AddHitsCollection(hcID, hitsCollection);
 }
 
 G4bool MiSensitiveDetector::ProcessHits(G4Step* step, G4TouchableHistory* /*history*/) {
-    auto hit = new MiHit();
-    
-    // Energía depositada
-    hit->SetEdep(step->GetTotalEnergyDeposit());
+    GAMMAATT_PERF_COUNT(sdCalls, 1);
+    auto prePoint = step->GetPreStepPoint();
 
-    // posicion del pre-step point
-    hit->SetPos(step->GetPreStepPoint()->GetPosition());
+    if (!score.hit) {
+        score.hit = true;
+        score.firstPos = prePoint->GetPosition();
+        score.entryEnergy = prePoint->GetKineticEnergy();
+        score.weight = prePoint->GetWeight();
+    }
+    score.edep += step->GetTotalEnergyDeposit();
 
+    // Fotón que cruza la frontera del detector: sin colisión si es un primario
+    // con la energía y la dirección con las que salió de la fuente
+    if (prePoint->GetStepStatus() == fGeomBoundary) {
+        const G4Track* track = step->GetTrack();
+        if (track->GetDefinition() == G4Gamma::Definition()) {
+            G4double energy = prePoint->GetKineticEnergy();
+            G4bool uncollided = track->GetParentID() == 0 &&
+                                std::abs(energy - track->GetVertexKineticEnergy()) <= 1e-9 * energy &&
+                                prePoint->GetMomentumDirection().dot(track->GetVertexMomentumDirection()) >= 1. - 1e-12;
+            if (uncollided && !score.uncollided) {
+                score.uncollided = true;
+                score.uncollidedWeight = prePoint->GetWeight();
+            }
+            if (spectrum)
+                spectrum->Fill(energy, prePoint->GetWeight(), uncollided);
+        }
+    }
 
-    // Insertamos en la colección 
-    hitsCollection->insert(hit);
+    if (hitsCollection) {
+        auto hit = new MiHit(); // Del pool por hilo (G4Allocator)
+
+        // Energía depositada
+        hit->SetEdep(step->GetTotalEnergyDeposit());
+
+        // posicion del pre-step point
+        hit->SetPos(prePoint->GetPosition());
+
+        // Insertamos en la colección 
+        hitsCollection->insert(hit);
+    }
 
     return true;
-}
\ No newline at end of file
+}
@@ -0,0 +1,189 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "PerformanceMonitor.hh"
+
+#ifdef GAMMAATT_INSTRUMENT
+
+#include "G4AutoLock.hh"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+  G4ThreadLocal PerformanceMonitor::ThreadCounters *localCounters = nullptr;
+
+  const char *kPhaseNames[PerformanceMonitor::kNumPhases] = {
+      "geometry", "physics_list", "physics_tables", "event_loop", "output_flush"};
+  const char *kVolumeNames[PerformanceMonitor::kNumVolumes] = {"world", "absorber", "detector"};
+
+  // En modo multihilo el maestro no procesa eventos: no es un hilo a muestrear
+  G4bool IsEventThread()
+  {
+    return !(G4Threading::IsMasterThread() && G4Threading::IsMultithreadedApplication());
+  }
+}
+
+PerformanceMonitor::PerformanceMonitor()
+{
+  std::fill(phaseTime, phaseTime + kNumPhases, 0.);
+  std::fill(phaseStart, phaseStart + kNumPhases, -1.);
+}
+
+PerformanceMonitor *PerformanceMonitor::Instance()
+{
+  static PerformanceMonitor instance;
+  return &instance;
+}
+
+PerformanceMonitor::ThreadCounters &PerformanceMonitor::Local()
+{
+  if (!localCounters)
+    localCounters = new ThreadCounters();
+  return *localCounters;
+}
+
+void PerformanceMonitor::BeginPhase(Phase phase)
+{
+  if (G4Threading::IsMasterThread())
+    phaseStart[phase] = Now();
+}
+
+void PerformanceMonitor::EndPhase(Phase phase)
+{
+  if (!G4Threading::IsMasterThread() || phaseStart[phase] < 0.)
+    return;
+  AddPhaseTime(phase, Now() - phaseStart[phase]);
+  phaseStart[phase] = -1.;
+}
+
+void PerformanceMonitor::AddPhaseTime(Phase phase, G4double seconds)
+{
+  if (!G4Threading::IsMasterThread())
+    return;
+  G4AutoLock lock(&mutex);
+  phaseTime[phase] += seconds;
+}
+
+void PerformanceMonitor::BeginThreadRun()
+{
+  if (!IsEventThread())
+    return;
+  ThreadCounters &c = Local();
+  c = ThreadCounters();
+  c.start = Now();
+}
+
+void PerformanceMonitor::Sample(ThreadCounters &c)
+{
+  c.samples.emplace_back(Now() - c.start, c.events);
+
+  // Runs muy largos: se conserva una muestra de cada dos y se espacian las siguientes
+  if (c.samples.size() >= kMaxSamples)
+  {
+    std::size_t kept = 0;
+    for (std::size_t i = 1; i < c.samples.size(); i += 2)
+      c.samples[kept++] = c.samples[i];
+    c.samples.resize(kept);
+    c.sampleEvery *= 2;
+  }
+}
+
+void PerformanceMonitor::CollectThread()
+{
+  if (!IsEventThread())
+    return;
+  ThreadCounters &c = Local();
+  G4double elapsed = Now() - c.start;
+
+  G4AutoLock lock(&mutex);
+  for (G4int v = 0; v < kNumVolumes; ++v)
+    totals.steps[v] += c.steps[v];
+  totals.tracks += c.tracks;
+  totals.secondaries += c.secondaries;
+  totals.sdCalls += c.sdCalls;
+  totals.events += c.events;
+  threads.push_back({G4Threading::G4GetThreadId(), c.events, elapsed, c.samples});
+}
+
+void PerformanceMonitor::WriteRunReport(G4int runID, const G4String &material, G4double thicknessCm)
+{
+  G4AutoLock lock(&mutex);
+  std::sort(threads.begin(), threads.end(),
+            [](const ThreadReport &a, const ThreadReport &b) { return a.thread < b.thread; });
+
+  G4long totalSteps = 0;
+  for (G4int v = 0; v < kNumVolumes; ++v)
+    totalSteps += totals.steps[v];
+  G4double perEvent = totals.events > 0 ? 1. / totals.events : 0.;
+
+  // --- Bloque legible en results_summary.txt ---
+  std::ofstream summary("../results/results_summary.txt", std::ios::app);
+  summary << "--- Rendimiento ---\n";
+  summary << "Geometría: " << phaseTime[kGeometry] << " s, lista de física: " << phaseTime[kPhysicsList]
+          << " s, tablas: " << phaseTime[kPhysicsTables] << " s\n";
+  summary << "Bucle de eventos: " << phaseTime[kEventLoop] << " s, volcado de salida: "
+          << phaseTime[kOutputFlush] << " s\n";
+  summary << "Pasos: " << totalSteps << " (" << totalSteps * perEvent << " por evento; absorbente "
+          << totals.steps[kAbsorber] << ", detector " << totals.steps[kDetector] << ", mundo "
+          << totals.steps[kWorld] << ")\n";
+  summary << "Trazas: " << totals.tracks << ", secundarias: " << totals.secondaries
+          << ", llamadas al SD: " << totals.sdCalls << "\n";
+  for (const auto &t : threads)
+  {
+    // Tasa instantánea entre muestras consecutivas: detecta hilos que se frenan
+    G4double minRate = 0., maxRate = 0.;
+    for (std::size_t i = 1; i < t.samples.size(); ++i)
+    {
+      G4double dt = t.samples[i].first - t.samples[i - 1].first;
+      if (dt <= 0.)
+        continue;
+      G4double rate = (t.samples[i].second - t.samples[i - 1].second) / dt;
+      minRate = (minRate == 0.) ? rate : std::min(minRate, rate);
+      maxRate = std::max(maxRate, rate);
+    }
+    summary << "Hilo " << t.thread << ": " << t.events << " eventos en " << t.seconds << " s ("
+            << (t.seconds > 0. ? t.events / t.seconds : 0.) << " ev/s";
+    if (maxRate > 0.)
+      summary << ", muestras " << minRate << "-" << maxRate << " ev/s";
+    summary << ")\n";
+  }
+  summary.close();
+
+  // --- Una línea JSON por run, junto a los resultados físicos ---
+  std::ostringstream json;
+  json << "{\"run\": " << runID << ", \"material\": \"" << material << "\", \"thickness_cm\": " << thicknessCm
+       << ", \"events\": " << totals.events << ", \"phases_s\": {";
+  for (G4int p = 0; p < kNumPhases; ++p)
+    json << (p ? ", " : "") << "\"" << kPhaseNames[p] << "\": " << phaseTime[p];
+  json << "}, \"steps\": {";
+  for (G4int v = 0; v < kNumVolumes; ++v)
+    json << (v ? ", " : "") << "\"" << kVolumeNames[v] << "\": " << totals.steps[v];
+  json << "}, \"tracks\": " << totals.tracks << ", \"secondaries\": " << totals.secondaries
+       << ", \"sd_calls\": " << totals.sdCalls << ", \"threads\": [";
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    const ThreadReport &t = threads[i];
+    json << (i ? ", " : "") << "{\"thread\": " << t.thread << ", \"events\": " << t.events
+         << ", \"seconds\": " << t.seconds << ", \"samples\": [";
+    for (std::size_t s = 0; s < t.samples.size(); ++s)
+      json << (s ? ", " : "") << "[" << t.samples[s].first << ", " << t.samples[s].second << "]";
+    json << "]}";
+  }
+  json << "]}\n";
+  std::ofstream("../results/performance.jsonl", std::ios::app) << json.str();
+
+  std::cout << "Rendimiento: bucle " << phaseTime[kEventLoop] << " s, " << totalSteps * perEvent
+            << " pasos/evento (results/performance.jsonl)" << std::endl;
+
+  // Las fases de inicialización solo aparecen en el run que las pagó
+  std::fill(phaseTime, phaseTime + kNumPhases, 0.);
+  totals = ThreadCounters();
+  threads.clear();
+}
+
+#endif // GAMMAATT_INSTRUMENT
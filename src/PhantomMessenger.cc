@@ -0,0 +1,131 @@
+#include "PhantomMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4SystemOfUnits.hh"
+#include <sstream>
+#include <vector>
+
+PhantomMessenger::PhantomMessenger(DetectorConstruction *detector)
+    : G4UImessenger(), detectorConstruction(detector)
+{
+    // Crear directorio de comandos
+    phantomDir = new G4UIdirectory("/phantom/");
+    phantomDir->SetGuidance("Maniquí de vóxeles (CT) en lugar del absorbente");
+
+    loadCmd = new G4UIcommand("/phantom/load", this);
+    loadCmd->SetGuidance("Proyecta en memoria un fichero raw de vóxeles (x más rápido, después y, después z)");
+    loadCmd->SetGuidance("hu: int16 en unidades Hounsfield; index: uint8, índice en /phantom/indexMaterials");
+    loadCmd->SetGuidance("El haz atraviesa el maniquí a lo largo de su eje z");
+    loadCmd->SetGuidance("Ej: /phantom/load ../data/ct.raw 512 512 120 0.98 0.98 2.5 mm hu 0");
+    loadCmd->SetParameter(new G4UIparameter("file", 's', false));
+    for (const char *name : {"nx", "ny", "nz"})
+    {
+        auto param = new G4UIparameter(name, 'i', false);
+        param->SetParameterRange(G4String(name) + " > 0");
+        loadCmd->SetParameter(param);
+    }
+    for (const char *name : {"dx", "dy", "dz"})
+    {
+        auto param = new G4UIparameter(name, 'd', false);
+        param->SetParameterRange(G4String(name) + " > 0.");
+        loadCmd->SetParameter(param);
+    }
+    auto unitParam = new G4UIparameter("unit", 's', true);
+    unitParam->SetDefaultValue("mm");
+    // Solo unidades de longitud: una desconocida daría vóxeles de tamaño 0
+    unitParam->SetParameterCandidates(G4UIcommand::UnitsList("Length"));
+    loadCmd->SetParameter(unitParam);
+    auto typeParam = new G4UIparameter("type", 's', true);
+    typeParam->SetDefaultValue("hu");
+    typeParam->SetParameterCandidates("hu index");
+    loadCmd->SetParameter(typeParam);
+    auto headerParam = new G4UIparameter("headerBytes", 'i', true);
+    headerParam->SetDefaultValue(0);
+    headerParam->SetParameterRange("headerBytes >= 0");
+    loadCmd->SetParameter(headerParam);
+    loadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    clearCmd = new G4UIcmdWithoutParameter("/phantom/clear", this);
+    clearCmd->SetGuidance("Vuelve al absorbente de /detector/...");
+    clearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    huRangeCmd = new G4UIcommand("/phantom/huRange", this);
+    huRangeCmd->SetGuidance("Asigna un material a los HU en [min, max); los rangos posteriores tienen prioridad");
+    huRangeCmd->SetGuidance("Por defecto: aire < -400 <= water < 20 <= muscle < 200 <= bone < 3000 <= lead");
+    huRangeCmd->SetGuidance("Ej: /phantom/huRange -100 20 G4_ADIPOSE_TISSUE_ICRP");
+    huRangeCmd->SetParameter(new G4UIparameter("min", 'i', false));
+    huRangeCmd->SetParameter(new G4UIparameter("max", 'i', false));
+    huRangeCmd->SetParameter(new G4UIparameter("material", 's', false));
+    huRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    resetHUCmd = new G4UIcmdWithoutParameter("/phantom/resetHU", this);
+    resetHUCmd->SetGuidance("Vuelve a los rangos de HU por defecto");
+    resetHUCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    indexMaterialsCmd = new G4UIcmdWithAString("/phantom/indexMaterials", this);
+    indexMaterialsCmd->SetGuidance("Materiales de los índices 0, 1, 2... de un fichero de tipo index");
+    indexMaterialsCmd->SetGuidance("Por defecto: G4_AIR water muscle bone lead concrete");
+    indexMaterialsCmd->SetParameterName("materials", false);
+    indexMaterialsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+PhantomMessenger::~PhantomMessenger()
+{
+    delete loadCmd;
+    delete clearCmd;
+    delete huRangeCmd;
+    delete resetHUCmd;
+    delete indexMaterialsCmd;
+    delete phantomDir;
+}
+
+void PhantomMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == loadCmd)
+    {
+        G4String file, unit, type;
+        G4int nx, ny, nz;
+        G4double dx, dy, dz;
+        long headerBytes;
+        std::istringstream is(newValue);
+        is >> file >> nx >> ny >> nz >> dx >> dy >> dz >> unit >> type >> headerBytes;
+        G4double scale = G4UIcommand::ValueOf(unit);
+        if (G4UIcommand::CategoryOf(unit) != "Length" || scale <= 0.)
+        {
+            G4cerr << "/phantom/load: unidad de longitud desconocida " << unit << "; no se ha cargado " << file
+                   << G4endl;
+            return;
+        }
+        if (!detectorConstruction->LoadPhantom(file, nx, ny, nz, G4ThreeVector(dx, dy, dz) * scale, type == "hu",
+                                               static_cast<std::size_t>(headerBytes)))
+            G4cerr << "/phantom/load: no se ha cargado " << file << G4endl;
+    }
+    else if (command == clearCmd)
+    {
+        detectorConstruction->ClearPhantom();
+    }
+    else if (command == huRangeCmd)
+    {
+        G4int low, high;
+        G4String material;
+        std::istringstream is(newValue);
+        is >> low >> high >> material;
+        detectorConstruction->AddPhantomHURange(low, high, material);
+    }
+    else if (command == resetHUCmd)
+    {
+        detectorConstruction->ResetPhantomHURanges();
+    }
+    else if (command == indexMaterialsCmd)
+    {
+        std::vector<G4String> names;
+        std::istringstream is(newValue);
+        for (G4String name; is >> name;)
+            names.push_back(name);
+        detectorConstruction->SetPhantomIndexMaterials(names);
+    }
+}
@@ -0,0 +1,78 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "PhotonOnlyPhysics.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Proton.hh"
+#include "G4PhysicsListHelper.hh"
+#include "G4ProcessManager.hh"
+#include "G4PhotoElectricEffect.hh"
+#include "G4ComptonScattering.hh"
+#include "G4RayleighScattering.hh"
+#include "G4GammaConversion.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Track.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RandomDirection.hh"
+
+PhotonOnlyPhysics::PhotonOnlyPhysics()
+    : G4VPhysicsConstructor("PhotonOnly")
+{
+  // Mismo tipo que las listas EM estándar: /phys/select las sustituye entre sí
+  SetPhysicsType(bElectromagnetic);
+}
+
+void PhotonOnlyPhysics::ConstructParticle()
+{
+  G4Gamma::Gamma();
+  G4Electron::Electron();
+  G4Positron::Positron();
+  G4Proton::Proton(); // La tabla de cortes de producción lo necesita
+}
+
+void PhotonOnlyPhysics::ConstructProcess()
+{
+  G4PhysicsListHelper *helper = G4PhysicsListHelper::GetPhysicsListHelper();
+  G4ParticleDefinition *gamma = G4Gamma::Gamma();
+  helper->RegisterProcess(new G4PhotoElectricEffect(), gamma);
+  helper->RegisterProcess(new G4ComptonScattering(), gamma);
+  helper->RegisterProcess(new G4RayleighScattering(), gamma);
+  helper->RegisterProcess(new G4GammaConversion(), gamma);
+
+  // Cada partícula necesita su propia instancia del proceso
+  G4ParticleDefinition *charged[] = {G4Electron::Electron(), G4Positron::Positron()};
+  for (G4ParticleDefinition *particle : charged)
+    particle->GetProcessManager()->AddDiscreteProcess(new LocalDepositProcess());
+}
+
+LocalDepositProcess::LocalDepositProcess()
+    : G4VProcess("localDeposit", fGeneral)
+{
+}
+
+G4double LocalDepositProcess::PostStepGetPhysicalInteractionLength(const G4Track &, G4double,
+                                                                   G4ForceCondition *condition)
+{
+  *condition = NotForced;
+  return 0.;
+}
+
+G4VParticleChange *LocalDepositProcess::PostStepDoIt(const G4Track &track, const G4Step &)
+{
+  aParticleChange.Initialize(track);
+  aParticleChange.ProposeLocalEnergyDeposit(track.GetKineticEnergy());
+  aParticleChange.ProposeTrackStatus(fStopAndKill);
+
+  if (track.GetDefinition() == G4Positron::Positron())
+  {
+    G4ThreeVector direction = G4RandomDirection();
+    aParticleChange.SetNumberOfSecondaries(2);
+    aParticleChange.AddSecondary(new G4DynamicParticle(G4Gamma::Gamma(), direction, electron_mass_c2));
+    aParticleChange.AddSecondary(new G4DynamicParticle(G4Gamma::Gamma(), -direction, electron_mass_c2));
+  }
+  return &aParticleChange;
+}
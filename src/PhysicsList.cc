@@ -1,17 +1,91 @@
 #include "PhysicsList.hh"
 #include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option1.hh"
+#include "G4EmStandardPhysics_option3.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4EmPenelopePhysics.hh"
+#include "G4EmLowEPPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4StateManager.hh"
+#include "PhotonOnlyPhysics.hh"
+#include "PhysicsTableCache.hh"
+#include "PhysicsListMessenger.hh"
+#include "PerformanceMonitor.hh"
+
+namespace {
+    G4VPhysicsConstructor* CreateEM(const G4String& name) {
+        if (name == "standard") return new G4EmStandardPhysics();
+        if (name == "opt1") return new G4EmStandardPhysics_option1();
+        if (name == "opt3") return new G4EmStandardPhysics_option3();
+        if (name == "opt4") return new G4EmStandardPhysics_option4();
+        if (name == "livermore") return new G4EmLivermorePhysics();
+        if (name == "penelope") return new G4EmPenelopePhysics();
+        if (name == "lowEP") return new G4EmLowEPPhysics();
+        if (name == "photon") return new PhotonOnlyPhysics();
+        return nullptr;
+    }
+}
 
 PhysicsList::PhysicsList()
-    : G4VModularPhysicsList() {
-        // Registrar la física electromagnética estándar para fotones
-        RegisterPhysics(new G4EmStandardPhysics());
+    : G4VModularPhysicsList(), emName("standard") {
+        // Física electromagnética estándar para fotones. Sin decaimientos:
+        // solo costaban tiempo de inicialización en un estudio de atenuación
+        RegisterPhysics(CreateEM(emName));
 
-        // Registrar decaimientos
-        decayPhysics = new G4DecayPhysics();
-        RegisterPhysics(decayPhysics);
+        // Se construye en el hilo maestro, el único que construye las tablas
+        tableCache = new PhysicsTableCache(this);
+        messenger = new PhysicsListMessenger(this);
     }
 
 PhysicsList::~PhysicsList() {
-    // NO eliminar decayPhysics manualmente
-    // G4VModularPhysicsList se encarga de la limpieza automáticamente
-}
\ No newline at end of file
+    // Los constructores registrados los elimina G4VModularPhysicsList
+    delete messenger;
+    delete tableCache;
+}
+
+const std::vector<G4String>& PhysicsList::GetEMNames() {
+    static const std::vector<G4String> names = {"standard", "opt1", "opt3", "opt4",
+                                                "livermore", "penelope", "lowEP", "photon"};
+    return names;
+}
+
+G4bool PhysicsList::SelectEM(const G4String& name) {
+    if (G4StateManager::GetStateManager()->GetCurrentState() != G4State_PreInit) {
+        G4cerr << "La lista de física solo se puede cambiar antes de Initialize" << G4endl;
+        return false;
+    }
+    if (name == emName) {
+        return true;
+    }
+    G4VPhysicsConstructor* constructor = CreateEM(name);
+    if (!constructor) {
+        G4cerr << "Lista de física desconocida: " << name << G4endl;
+        return false;
+    }
+    // Sustituye al constructor del mismo tipo (bElectromagnetic) y lo elimina
+    ReplacePhysics(constructor);
+    emName = name;
+    return true;
+}
+
+void PhysicsList::EnableBiasing() {
+    // Los procesos de los fotones quedan envueltos en G4BiasingProcessInterface;
+    // sin operador asociado al volumen se comportan como los analógicos
+    auto biasingPhysics = new G4GenericBiasingPhysics();
+    biasingPhysics->Bias("gamma");
+    RegisterPhysics(biasingPhysics);
+}
+
+void PhysicsList::EnableFastSimulation() {
+    // El modelo lo asocia DetectorConstruction a la región AbsorberRegion
+    auto fastSimulationPhysics = new G4FastSimulationPhysics();
+    fastSimulationPhysics->ActivateFastSimulation("gamma");
+    RegisterPhysics(fastSimulationPhysics);
+}
+
+void PhysicsList::ConstructProcess() {
+    GAMMAATT_PERF_SCOPE(kPhysicsList);
+    G4VModularPhysicsList::ConstructProcess();
+}
@@ -0,0 +1,65 @@
+#include "PhysicsListMessenger.hh"
+#include "PhysicsList.hh"
+#include "PhysicsTableCache.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList *list)
+    : G4UImessenger(), physicsList(list)
+{
+    // Crear directorio de comandos
+    physDir = new G4UIdirectory("/phys/");
+    physDir->SetGuidance("Opciones de la lista de física");
+
+    G4String candidates;
+    for (const G4String &name : PhysicsList::GetEMNames())
+        candidates += (candidates.empty() ? "" : " ") + name;
+
+    selectCmd = new G4UIcmdWithAString("/phys/select", this);
+    selectCmd->SetGuidance("Física electromagnética: standard (por defecto), opt1, opt3, opt4,");
+    selectCmd->SetGuidance("livermore, penelope, lowEP o photon (solo procesos de fotones;");
+    selectCmd->SetGuidance("los electrones y positrones depositan su energía donde se crean)");
+    selectCmd->SetGuidance("Solo antes de /run/initialize; gammaAtt inicializa antes de la macro: usar --physics");
+    selectCmd->SetParameterName("list", false);
+    selectCmd->SetCandidates(candidates);
+    selectCmd->SetToBeBroadcasted(false);
+    selectCmd->AvailableForStates(G4State_PreInit);
+
+    tableCacheCmd = new G4UIcmdWithAString("/phys/tableCache", this);
+    tableCacheCmd->SetGuidance("Directorio de la caché de tablas de física ('none' la desactiva)");
+    tableCacheCmd->SetGuidance("Por defecto $GAMMAATT_PHYSICS_CACHE o ../cache/physics");
+    tableCacheCmd->SetParameterName("dir", false);
+    tableCacheCmd->SetToBeBroadcasted(false);
+    tableCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+    delete selectCmd;
+    delete tableCacheCmd;
+    delete physDir;
+}
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == selectCmd)
+    {
+        physicsList->SelectEM(newValue);
+    }
+    else if (command == tableCacheCmd)
+    {
+        physicsList->GetTableCache()->SetDirectory(newValue == "none" ? G4String() : newValue);
+    }
+}
+
+G4String PhysicsListMessenger::GetCurrentValue(G4UIcommand *command)
+{
+    if (command == selectCmd)
+        return physicsList->GetEMName();
+    if (command == tableCacheCmd)
+    {
+        const G4String &dir = physicsList->GetTableCache()->GetDirectory();
+        return dir.empty() ? G4String("none") : dir;
+    }
+    return "";
+}
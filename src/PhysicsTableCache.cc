@@ -0,0 +1,222 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "PhysicsTableCache.hh"
+#include "PerformanceMonitor.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4StateManager.hh"
+#include "G4EmParameters.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VVolumeMaterialScanner.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Version.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  // FNV-1a de 64 bits: suficiente para distinguir configuraciones
+  G4String HashKey(const G4String &text)
+  {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : text)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+  }
+
+  // Una entrada solo es válida cuando se terminó de escribir
+  const char *kCompleteMarker = "COMPLETE";
+}
+
+PhysicsTableCache::PhysicsTableCache(G4VModularPhysicsList *list)
+    : G4VStateDependent(), physicsList(list), previousState(G4State_PreInit),
+      pending(false), retrieving(false)
+{
+  const char *env = std::getenv("GAMMAATT_PHYSICS_CACHE");
+  directory = env ? env : "../cache/physics";
+}
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  if (previousState == G4State_Idle && requestedState == G4State_Init)
+  {
+    GAMMAATT_PERF_BEGIN(kPhysicsTables);
+    BeginBuild();
+  }
+  else if (previousState == G4State_Idle && requestedState == G4State_GeomClosed)
+  {
+    EndBuild();
+    GAMMAATT_PERF_END(kPhysicsTables);
+  }
+
+  previousState = requestedState;
+  return true;
+}
+
+G4String PhysicsTableCache::DescribeConfiguration() const
+{
+  std::ostringstream os;
+  os << std::setprecision(10);
+
+  os << "geant4 " << G4VERSION_NUMBER << " " << G4Version << "\n";
+
+  // Lista de física: constructores registrados y opciones EM
+  for (G4int i = 0;; ++i)
+  {
+    const G4VPhysicsConstructor *constructor = physicsList->GetPhysics(i);
+    if (!constructor)
+      break;
+    os << "physics " << constructor->GetPhysicsName() << "\n";
+  }
+  G4EmParameters::Instance()->StreamInfo(os);
+
+  // Cortes por defecto, por región y rango de energías de la tabla
+  os << "defaultCut " << physicsList->GetDefaultCutValue() / mm << "\n";
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  os << "cutRange " << cutsTable->GetLowEdgeEnergy() / eV << " " << cutsTable->GetHighEdgeEnergy() / eV << "\n";
+  for (const G4Region *region : *G4RegionStore::GetInstance())
+  {
+    os << "region " << region->GetName();
+    if (const G4ProductionCuts *cuts = region->GetProductionCuts())
+      for (G4int i = 0; i < NumberOfG4CutIndex; ++i)
+        os << " " << cuts->GetProductionCut(i) / mm;
+    os << "\n";
+  }
+
+  // Composición de los materiales de la geometría (ordenados por nombre)
+  std::map<G4String, const G4Material *> materials;
+  for (const G4LogicalVolume *volume : *G4LogicalVolumeStore::GetInstance())
+    if (volume->GetMaterial())
+      materials[volume->GetMaterial()->GetName()] = volume->GetMaterial();
+  // Los volúmenes parametrizados (capas, maniquí) cambian de material en cada
+  // copia; si la parametrización da su lista de materiales no se recorren las copias
+  for (G4VPhysicalVolume *volume : *G4PhysicalVolumeStore::GetInstance())
+  {
+    G4VPVParameterisation *param = volume->IsParameterised() ? volume->GetParameterisation() : nullptr;
+    if (!param)
+      continue;
+    if (G4VVolumeMaterialScanner *scanner = param->GetMaterialScanner())
+    {
+      for (G4int i = 0; i < scanner->GetNumberOfMaterials(); ++i)
+        if (const G4Material *material = scanner->GetMaterial(i))
+          materials[material->GetName()] = material;
+    }
+    else
+    {
+      for (G4int i = 0; i < volume->GetMultiplicity(); ++i)
+        if (const G4Material *material = param->ComputeMaterial(i, volume))
+          materials[material->GetName()] = material;
+    }
+  }
+  for (const auto &entry : materials)
+  {
+    const G4Material *material = entry.second;
+    os << "material " << material->GetName() << " " << material->GetDensity() / (g / cm3) << " "
+       << material->GetTemperature() / kelvin << " " << material->GetState() << " "
+       << material->GetIonisation()->GetMeanExcitationEnergy() / eV << "\n";
+    const G4double *fractions = material->GetFractionVector();
+    for (std::size_t i = 0; i < material->GetNumberOfElements(); ++i)
+    {
+      const G4Element *element = material->GetElement(i);
+      os << "  " << element->GetName() << " " << element->GetZ() << " "
+         << element->GetN() << " " << fractions[i] << "\n";
+    }
+  }
+
+  return os.str();
+}
+
+void PhysicsTableCache::BeginBuild()
+{
+  pending = false;
+  if (directory.empty())
+    return;
+
+  G4String description = DescribeConfiguration();
+  G4String key = HashKey(description);
+  if (key == builtKey)
+    return; // Las tablas en memoria ya corresponden a esta configuración
+
+  pendingKey = key;
+  pending = true;
+
+  fs::path entry = fs::path(directory) / key;
+  retrieving = fs::exists(entry / kCompleteMarker);
+  if (retrieving)
+    physicsList->SetPhysicsTableRetrieved(entry.string());
+  else
+    physicsList->ResetPhysicsTableRetrieved();
+
+  timer.Start();
+}
+
+void PhysicsTableCache::EndBuild()
+{
+  if (!pending)
+    return;
+  pending = false;
+  timer.Stop();
+  G4double elapsed = timer.GetRealElapsed();
+
+  fs::path entry = fs::path(directory) / pendingKey;
+  if (retrieving)
+  {
+    physicsList->ResetPhysicsTableRetrieved();
+    G4cout << "Tablas de física: recuperadas de la caché (arranque en caliente) en "
+           << elapsed << " s [" << pendingKey << "]" << G4endl;
+  }
+  else
+  {
+    G4cout << "Tablas de física: construidas (arranque en frío) en " << elapsed << " s" << G4endl;
+
+    // Se escribe en un directorio temporal y se publica con un rename atómico,
+    // así varios procesos de un barrido pueden compartir la caché
+    std::error_code ec;
+    fs::path staging = fs::path(directory) / (pendingKey + ".tmp" + std::to_string(::getpid()));
+    fs::create_directories(staging, ec);
+    if (!ec && physicsList->StorePhysicsTable(staging.string()))
+    {
+      std::ofstream(staging / "key.txt") << DescribeConfiguration();
+      std::ofstream(staging / kCompleteMarker) << elapsed << "\n";
+      fs::rename(staging, entry, ec);
+      if (ec)
+        fs::remove_all(staging, ec); // Otro proceso la publicó antes
+      else
+        G4cout << "Tablas de física: guardadas en " << entry.string() << G4endl;
+    }
+    else
+    {
+      fs::remove_all(staging, ec);
+      G4cerr << "AVISO: no se pudieron guardar las tablas de física en " << directory << G4endl;
+    }
+  }
+
+  builtKey = pendingKey;
+}
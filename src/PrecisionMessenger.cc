@@ -0,0 +1,58 @@
+#include "PrecisionMessenger.hh"
+#include "PrecisionMonitor.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include <sstream>
+
+PrecisionMessenger::PrecisionMessenger(PrecisionMonitor *monitor)
+    : G4UImessenger(), precisionMonitor(monitor)
+{
+    // Los comandos se añaden al directorio /run/ que ya crea Geant4
+    beamToPrecisionCmd = new G4UIcommand("/run/beamToPrecision", this);
+    beamToPrecisionCmd->SetGuidance("Ejecuta eventos hasta que el coeficiente de atenuación");
+    beamToPrecisionCmd->SetGuidance("alcanza el error relativo pedido o se llega a maxEvents");
+    beamToPrecisionCmd->SetGuidance("Ej: /run/beamToPrecision 0.01 1000000");
+
+    auto relErrorParam = new G4UIparameter("relError", 'd', false);
+    relErrorParam->SetGuidance("Error relativo objetivo de mu (1 sigma)");
+    relErrorParam->SetParameterRange("relError > 0. && relError < 1.");
+    beamToPrecisionCmd->SetParameter(relErrorParam);
+
+    auto maxEventsParam = new G4UIparameter("maxEvents", 'i', false);
+    maxEventsParam->SetGuidance("Número máximo de eventos");
+    maxEventsParam->SetParameterRange("maxEvents > 0");
+    beamToPrecisionCmd->SetParameter(maxEventsParam);
+
+    beamToPrecisionCmd->SetToBeBroadcasted(false);
+    beamToPrecisionCmd->AvailableForStates(G4State_Idle);
+
+    checkIntervalCmd = new G4UIcmdWithAnInteger("/run/precisionCheckInterval", this);
+    checkIntervalCmd->SetGuidance("Eventos por hilo entre comprobaciones de /run/beamToPrecision");
+    checkIntervalCmd->SetParameterName("events", false);
+    checkIntervalCmd->SetRange("events > 0");
+    checkIntervalCmd->SetToBeBroadcasted(false);
+    checkIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+PrecisionMessenger::~PrecisionMessenger()
+{
+    delete beamToPrecisionCmd;
+    delete checkIntervalCmd;
+}
+
+void PrecisionMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == beamToPrecisionCmd)
+    {
+        G4double relError = 0.;
+        G4int maxEvents = 0;
+        std::istringstream is(newValue);
+        is >> relError >> maxEvents;
+        precisionMonitor->BeamToPrecision(relError, maxEvents);
+    }
+    else if (command == checkIntervalCmd)
+    {
+        precisionMonitor->SetCheckInterval(checkIntervalCmd->GetNewIntValue(newValue));
+    }
+}
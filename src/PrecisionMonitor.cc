@@ -0,0 +1,76 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "PrecisionMonitor.hh"
+#include "PrecisionMessenger.hh"
+#include "RunTotals.hh"
+#include "Sharding.hh"
+#include "G4RunManager.hh"
+#include "G4ios.hh"
+#include "G4AutoLock.hh"
+
+PrecisionMonitor::PrecisionMonitor()
+    : targetRelError(0.), minEvents(1000), checkInterval(1000), weighted(false),
+      events(0), transmitted(0), sumW(0.), sumW2(0.), reached(false)
+{
+  messenger = new PrecisionMessenger(this);
+}
+
+PrecisionMonitor::~PrecisionMonitor()
+{
+  delete messenger;
+}
+
+void PrecisionMonitor::BeamToPrecision(G4double relError, G4int maxEvents)
+{
+  // Cada fragmento pararía con su propio error: las sumas ya no serían las de un run
+  if (Sharding::IsActive())
+  {
+    G4cerr << "/run/beamToPrecision no es compatible con --shard: usa /run/beamOn" << G4endl;
+    return;
+  }
+
+  G4cout << "=== Run hasta " << relError * 100. << " % de error relativo en mu (máx. "
+         << maxEvents << " eventos) ===" << G4endl;
+
+  targetRelError = relError;
+  G4RunManager::GetRunManager()->BeamOn(maxEvents);
+  targetRelError = 0.;
+}
+
+void PrecisionMonitor::Reset(G4bool isWeighted)
+{
+  G4AutoLock lock(&mutex);
+  weighted = isWeighted;
+  events = 0;
+  transmitted = 0;
+  sumW = 0.;
+  sumW2 = 0.;
+  reached = false;
+}
+
+G4bool PrecisionMonitor::Update(G4int nEvents, G4int nTransmitted, G4double batchW, G4double batchW2)
+{
+  G4double relError;
+  {
+    G4AutoLock lock(&mutex);
+    events += nEvents;
+    transmitted += nTransmitted;
+    sumW += batchW;
+    sumW2 += batchW2;
+    if (events < minEvents)
+      return reached;
+    // El mismo error que dará RunTotals::Compute al final del run
+    relError = weighted ? RunTotals::WeightedRelativeError(events, sumW, sumW2) : RelativeError(events, transmitted);
+  }
+  if (relError > 0. && relError <= targetRelError)
+    reached = true;
+  return reached;
+}
+
+G4double PrecisionMonitor::RelativeError(G4long n, G4long k)
+{
+  return RunTotals::RelativeError(n, k);
+}
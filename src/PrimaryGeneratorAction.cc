@@ -1,8 +1,14 @@
 #include "PrimaryGeneratorAction.hh"
 #include "G4ParticleGun.hh"
+#include "G4Event.hh"
 #include "G4ParticleTable.hh"
 #include "G4Gamma.hh"
 #include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include "SourceSpectrum.hh"
+#include "SourceMessenger.hh"
+#include "EventSeeder.hh"
+#include <sstream>
 
 PrimaryGeneratorAction::PrimaryGeneratorAction()
 {
@@ -15,12 +21,44 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
     particleGun->SetParticleEnergy(662 * keV);                            // Cs-137: 662 keV (no MeV!)
     particleGun->SetParticleMomentumDirection(G4ThreeVector(0., 0., 1.)); // Dirección en z
     particleGun->SetParticlePosition(G4ThreeVector(0., 0., -50. * cm));   // Posición inicial
+
+    // Espectro opcional (/source/...)
+    spectrum = new SourceSpectrum();
+    messenger = new SourceMessenger(spectrum);
 }
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+    delete messenger;
+    delete spectrum;
     delete particleGun;
 }
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event *anEvent)
 {
+    // Primer uso del motor en el evento (va antes que BeginOfEventAction): el
+    // estado depende solo de (semilla maestra, run, evento), no del hilo
+    EventSeeder::SeedEvent(anEvent->GetEventID());
+
+    // Coste constante por evento: tabla alias precalculada. La energía de
+    // /gun/energy se restaura tras el vértice: es la que vale al volver a
+    // /source/mono y la que anota GetSpectrumTag()
+    if (spectrum->IsActive())
+    {
+        const G4double gunEnergy = particleGun->GetParticleEnergy();
+        particleGun->SetParticleEnergy(spectrum->Sample(G4UniformRand(), G4UniformRand()));
+        particleGun->GeneratePrimaryVertex(anEvent);
+        particleGun->SetParticleEnergy(gunEnergy);
+        return;
+    }
+
     particleGun->GeneratePrimaryVertex(anEvent);
-}
\ No newline at end of file
+}
+
+G4String PrimaryGeneratorAction::GetSpectrumTag() const
+{
+    if (spectrum->IsActive())
+        return spectrum->Describe();
+
+    std::ostringstream os;
+    os << "mono:" << particleGun->GetParticleEnergy() / keV << "keV";
+    return os.str();
+}
@@ -0,0 +1,281 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "ResultsStore.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ResultsStore
+{
+  namespace
+  {
+    std::string FormatDouble(double value)
+    {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+      return buffer;
+    }
+
+    std::string HeaderLine()
+    {
+      std::string line = "#";
+      for (std::size_t i = 0; i < Columns().size(); ++i)
+        line += (i ? "\t" : "") + Columns()[i];
+      return line + "\n";
+    }
+
+    std::string RecordLine(const Record &r)
+    {
+      std::ostringstream os;
+      os << r.key << '\t' << r.timestamp << '\t' << r.material << '\t' << r.label << '\t'
+         << FormatDouble(r.density) << '\t' << FormatDouble(r.thickness) << '\t' << r.spectrum << '\t'
+         << r.physics << '\t' << r.seed << '\t' << r.requested << '\t' << r.events << '\t'
+         << r.transmitted << '\t' << FormatDouble(r.transmission) << '\t' << FormatDouble(r.mu) << '\t'
+         << FormatDouble(r.relError) << '\t' << FormatDouble(r.meanEnergy) << '\t' << FormatDouble(r.fom)
+         << '\t' << r.uncollided << '\t' << FormatDouble(r.muNarrow) << '\t' << FormatDouble(r.narrowRelError)
+         << '\t' << FormatDouble(r.buildup) << '\n';
+      return os.str();
+    }
+
+    // Asigna un campo por nombre de columna (las desconocidas se ignoran)
+    void SetField(Record &r, const std::string &column, const std::string &value)
+    {
+      auto toLL = [&]() { return std::atoll(value.c_str()); };
+      auto toD = [&]() { return std::atof(value.c_str()); };
+      if (column == "key") r.key = value;
+      else if (column == "timestamp") r.timestamp = toLL();
+      else if (column == "material") r.material = value;
+      else if (column == "label") r.label = value;
+      else if (column == "density_gcm3") r.density = toD();
+      else if (column == "thickness_cm") r.thickness = toD();
+      else if (column == "spectrum") r.spectrum = value;
+      else if (column == "physics") r.physics = value;
+      else if (column == "seed") r.seed = toLL();
+      else if (column == "requested") r.requested = toLL();
+      else if (column == "events") r.events = toLL();
+      else if (column == "transmitted") r.transmitted = toLL();
+      else if (column == "transmission") r.transmission = toD();
+      else if (column == "mu_cm1") r.mu = toD();
+      else if (column == "rel_error") r.relError = toD();
+      else if (column == "mean_energy_keV") r.meanEnergy = toD();
+      else if (column == "fom") r.fom = toD();
+      else if (column == "uncollided") r.uncollided = toLL();
+      else if (column == "mu_narrow_cm1") r.muNarrow = toD();
+      else if (column == "narrow_rel_error") r.narrowRelError = toD();
+      else if (column == "buildup") r.buildup = toD();
+    }
+
+    // Última línea de cabecera del fichero abierto en fd (vacía si no hay).
+    // Lo normal es que el fichero empiece con la cabecera actual; si no, se
+    // busca hacia atrás por bloques y solo se lee lo escrito desde el último
+    // cambio de formato
+    std::string LastHeader(int fd, off_t size)
+    {
+      const std::string current = HeaderLine();
+      std::string first(std::min<off_t>(size, static_cast<off_t>(current.size())), '\0');
+      if (::pread(fd, &first[0], first.size(), 0) == static_cast<ssize_t>(first.size()) && first == current)
+        return current; // Fichero creado con el formato actual
+
+      const off_t block = 1 << 16;
+      std::string tail; // Desde la posición 'offset' hasta el final del fichero
+      off_t offset = size;
+      while (offset > 0)
+      {
+        off_t start = std::max<off_t>(0, offset - block);
+        std::string chunk(static_cast<std::size_t>(offset - start), '\0');
+        if (::pread(fd, &chunk[0], chunk.size(), start) != static_cast<ssize_t>(chunk.size()))
+          return "";
+        tail = chunk + tail;
+        offset = start;
+
+        // Cabecera completa: empieza al principio del fichero o tras un salto de línea
+        for (std::size_t pos = tail.rfind('#'); pos != std::string::npos;
+             pos = pos ? tail.rfind('#', pos - 1) : std::string::npos)
+        {
+          if (pos == 0 && offset > 0)
+            break; // No se sabe si es inicio de línea: leer otro bloque
+          if (pos > 0 && tail[pos - 1] != '\n')
+            continue;
+          std::size_t end = tail.find('\n', pos);
+          return tail.substr(pos, end == std::string::npos ? std::string::npos : end - pos + 1);
+        }
+      }
+      return "";
+    }
+
+    std::vector<std::string> Split(const std::string &line)
+    {
+      std::vector<std::string> fields;
+      std::size_t start = 0;
+      while (true)
+      {
+        std::size_t end = line.find('\t', start);
+        fields.push_back(line.substr(start, end - start));
+        if (end == std::string::npos)
+          break;
+        start = end + 1;
+      }
+      return fields;
+    }
+  }
+
+  const std::vector<std::string> &Columns()
+  {
+    static const std::vector<std::string> columns = {
+        "key", "timestamp", "material", "label", "density_gcm3", "thickness_cm", "spectrum",
+        "physics", "seed", "requested", "events", "transmitted", "transmission", "mu_cm1",
+        "rel_error", "mean_energy_keV", "fom", "uncollided", "mu_narrow_cm1", "narrow_rel_error",
+        "buildup"};
+    return columns;
+  }
+
+  std::string Hash(const std::string &text)
+  {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : text)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+  }
+
+  std::string MakeKey(const Record &r)
+  {
+    return Hash(r.material + "|" + FormatDouble(r.density) + "|" + FormatDouble(r.thickness) + "|" +
+                r.spectrum + "|" + r.physics + "|" + std::to_string(r.seed) + "|" +
+                std::to_string(r.requested));
+  }
+
+  std::string DefaultPath()
+  {
+    const char *env = std::getenv("GAMMAATT_STORE");
+    return env ? env : "../results/store.tsv";
+  }
+
+  std::string Sanitize(const std::string &text)
+  {
+    std::string clean = text.empty() ? "-" : text;
+    for (char &c : clean)
+      if (c == '\t' || c == '\n' || c == '\r' || c == ' ')
+        c = '_';
+    return clean;
+  }
+
+  bool Append(const std::string &path, Record &record)
+  {
+    record.material = Sanitize(record.material);
+    record.label = Sanitize(record.label);
+    record.spectrum = Sanitize(record.spectrum);
+    record.physics = Sanitize(record.physics);
+    record.key = MakeKey(record);
+    record.timestamp = static_cast<long long>(std::time(nullptr));
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+      std::filesystem::create_directories(parent, ec);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+      return false;
+
+    // El cerrojo cubre también la decisión de escribir la cabecera. En un
+    // almacén con columnas de una versión anterior se añade la cabecera nueva:
+    // Load() cambia la correspondencia de columnas a partir de ella
+    ::flock(fd, LOCK_EX);
+    struct stat info;
+    std::string text;
+    if (::fstat(fd, &info) == 0 && (info.st_size == 0 || LastHeader(fd, info.st_size) != HeaderLine()))
+      text = HeaderLine();
+    text += RecordLine(record);
+
+    const char *data = text.data();
+    std::size_t left = text.size();
+    bool ok = true;
+    while (left > 0)
+    {
+      ssize_t written = ::write(fd, data, left);
+      if (written < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        ok = false;
+        break;
+      }
+      data += written;
+      left -= static_cast<std::size_t>(written);
+    }
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    return ok;
+  }
+
+  Store::Store(const std::string &storePath) : path(storePath) {}
+
+  bool Store::Load()
+  {
+    records.clear();
+    index.clear();
+
+    std::ifstream in(path);
+    if (!in)
+      return false;
+
+    // Sin cabecera se asume el orden actual; una cabecera nueva a mitad de
+    // fichero (cambio de formato) cambia la correspondencia de columnas
+    std::vector<std::string> columns = Columns();
+    std::string line;
+    while (std::getline(in, line))
+    {
+      if (line.empty())
+        continue;
+      if (line[0] == '#')
+      {
+        columns = Split(line.substr(1));
+        continue;
+      }
+
+      std::vector<std::string> fields = Split(line);
+      if (fields.size() != columns.size())
+        continue; // Línea incompleta (p. ej. disco lleno): se descarta
+
+      Record record;
+      for (std::size_t i = 0; i < fields.size(); ++i)
+        SetField(record, columns[i], fields[i]);
+      if (record.key.empty())
+        continue;
+
+      auto it = index.find(record.key);
+      if (it != index.end())
+        records[it->second] = record;
+      else
+      {
+        index[record.key] = records.size();
+        records.push_back(record);
+      }
+    }
+    return true;
+  }
+
+  const Record *Store::Find(const std::string &key) const
+  {
+    auto it = index.find(key);
+    return it != index.end() ? &records[it->second] : nullptr;
+  }
+}
@@ -7,23 +7,82 @@ Fecha: Octubre 2025
 #include "G4Run.hh"
 #include "G4ios.hh"
 #include "G4RunManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "SweepManager.hh"
+#include "EventWriter.hh"
+#include "PrecisionMonitor.hh"
+#include "PerformanceMonitor.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "SteppingAction.hh"
+#include "ResultsStore.hh"
+#include "EventSeeder.hh"
+#include "RunTotals.hh"
+#include "Sharding.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4AutoLock.hh"
+#include "Randomize.hh"
+#include <filesystem>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 
-#ifdef USE_ROOT
-#include "TFile.h"
-#include "TTree.h"
-#include "TH1F.h"
-#include "TString.h"
-#endif
+namespace
+{
+  // La fuente solo existe en los hilos de trabajo (PrimaryGeneratorAction);
+  // la anotan al empezar el run y el maestro la lee al escribir el almacén
+  G4Mutex spectrumMutex = G4MUTEX_INITIALIZER;
+  G4String spectrumTag;
+  G4String fastTag; // Ajustes de /fast/ que cambian los recuentos (SteppingAction)
+
+  // absorberModel: el run usó el modelo rápido del absorbente (--fastsim)
+  G4String PhysicsTag(G4bool absorberModel)
+  {
+    auto physicsList = dynamic_cast<const G4VModularPhysicsList *>(
+        G4RunManager::GetRunManager()->GetUserPhysicsList());
+    if (!physicsList)
+      return "";
+    G4String tag;
+    for (G4int i = 0; const G4VPhysicsConstructor *constructor = physicsList->GetPhysics(i); ++i)
+      tag += (i ? "+" : "") + constructor->GetPhysicsName();
+    return absorberModel ? tag + "+AbsorberModel" : tag;
+  }
+}
+
+G4bool RunAction::outputsFailed = false;
 
-RunAction::RunAction(DetectorConstruction *det)
-    : G4UserRunAction(), detector(det), totalEvents(0), transmittedEvents(0)
+RunAction::RunAction(DetectorConstruction *det, const SweepManager *sw, EventWriter *writer,
+                     PrecisionMonitor *monitor, const EnergyBinning *binning, const MeshConfig *mesh)
+    : G4UserRunAction(), detector(det), sweep(sw), eventWriter(writer), eventBuffer(nullptr),
+      precision(monitor), batchEvents(0), batchTransmitted(0), batchWeight(0.), batchWeight2(0.), currentRunID(0),
+      totalEvents(0), transmittedEvents(0), primaryEnergySum(0.),
+      transmittedWeight(0.), transmittedWeight2(0.), uncollidedEvents(0), uncollidedWeight(0.),
+      uncollidedWeight2(0.), totalSteps(0.), stepCount(0), runSeed(0),
+      energyTally("energyTally", binning), detectorSpectrum("detectorSpectrum", binning),
+      energyBinning(binning), meshTally("meshTally", mesh), meshConfig(mesh), layerTally("layerTally")
 {
+  if (eventWriter)
+    eventBuffer = new EventBuffer(eventWriter);
+
+  // Contadores fusionables entre hilos (en modo secuencial el merge es trivial)
+  auto accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->Register(totalEvents);
+  accumulableManager->Register(transmittedEvents);
+  accumulableManager->Register(primaryEnergySum);
+  accumulableManager->Register(transmittedWeight);
+  accumulableManager->Register(transmittedWeight2);
+  accumulableManager->Register(uncollidedEvents);
+  accumulableManager->Register(uncollidedWeight);
+  accumulableManager->Register(uncollidedWeight2);
+  accumulableManager->Register(totalSteps);
+  accumulableManager->Register(&energyTally);
+  accumulableManager->Register(&detectorSpectrum);
+  accumulableManager->Register(&meshTally);
+  accumulableManager->Register(&layerTally);
+
 #ifdef USE_ROOT
-  rootFile = nullptr;
-  attenuationTree = nullptr;
-  attenuationHist = nullptr;
   G4cout << "RunAction: ROOT support enabled (datos únicamente)" << G4endl;
 #else
   G4cout << "RunAction: ROOT support not available" << G4endl;
@@ -32,121 +91,306 @@ RunAction::RunAction(DetectorConstruction *det)
 
 RunAction::~RunAction()
 {
-#ifdef USE_ROOT
-  if (rootFile)
-  {
-    rootFile->Close();
-    delete rootFile;
-  }
-
-#endif
+  delete eventBuffer;
 }
 
 void RunAction::BeginOfRunAction(const G4Run *run)
 {
-  totalEvents = run->GetNumberOfEventToBeProcessed();
-  transmittedEvents = 0;
+  energyTally.Configure(); // Bins de /tally/... vigentes para este run
+  detectorSpectrum.Configure();
+  meshTally.Configure(detector->GetAbsorberHalfSize()); // Se adapta al espesor de este run
+  layerTally.Configure(detector->GetLayerBackFaces());
+  G4AccumulableManager::Instance()->Reset();
+  currentRunID = run->GetRunID();
+  batchEvents = 0;
+  batchTransmitted = 0;
+  batchWeight = batchWeight2 = 0.;
+  stepCount = 0;
+  GAMMAATT_PERF_THREAD_BEGIN();
+
+  auto generator = dynamic_cast<const PrimaryGeneratorAction *>(
+      G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  if (generator)
+  {
+    G4AutoLock lock(&spectrumMutex);
+    spectrumTag = generator->GetSpectrumTag();
+  }
+  auto stepping = dynamic_cast<const SteppingAction *>(G4RunManager::GetRunManager()->GetUserSteppingAction());
+  if (stepping)
+  {
+    G4AutoLock lock(&spectrumMutex);
+    fastTag = stepping->GetFastTag();
+  }
+
+  // Los hilos de trabajo solo cuentan; los ficheros los gestiona el maestro
+  if (!IsMaster())
+    return;
+
+  // El maestro empieza antes que los hilos: estos ya ven el monitor a cero
+  if (precision)
+    precision->Reset(detector->GetBiasing() && detector->GetExpTransform() > 0.);
+
+  runTimer.Start();
+  // Antes de que los hilos pidan eventos: cada evento se resiembra a partir de
+  // (semilla, run, número global del evento)
+  runSeed = G4Random::getTheSeed();
+  EventSeeder::BeginRun(runSeed, run->GetRunID(), Sharding::GetFirstEvent());
+  GAMMAATT_PERF_BEGIN(kEventLoop);
+
+  // El escritor de eventos abre su fichero una vez por proceso
+  if (eventWriter)
+    eventWriter->Start();
+
+  G4int requestedEvents = run->GetNumberOfEventToBeProcessed();
 
   std::cout << "=== Comenzando Run " << run->GetRunID() << " ===" << std::endl;
   std::cout << "Material: " << detector->GetMaterial() << std::endl;
   std::cout << "Espesor: " << detector->GetThickness() / CLHEP::cm << " cm" << std::endl;
-  std::cout << "Eventos totales: " << totalEvents << std::endl;
-
-#ifdef USE_ROOT
-  // Crear archivo ROOT simple
-  TString rootFileName = TString::Format("../results/data_run_%s.root", detector->GetMaterial().c_str());
-  rootFile = new TFile(rootFileName.Data(), "RECREATE");
-
-  // Crear Tree simple para datos
-  attenuationTree = new TTree("data", "Attenuation Data");
-
-  // Crear histograma para coeficientes de atenuación
-  attenuationHist = new TH1F("attenuationCoeff", "Coeficiente de Atenuacion;Coeficiente (cm^{-1});Frecuencia", 100, 0, 0.2);
-
-  // Variables básicas
-  runData.runID = run->GetRunID();
-  strncpy(runData.material, detector->GetMaterial().c_str(), 49);
-  runData.material[49] = '\0';
-  runData.thickness = detector->GetThickness() / CLHEP::cm;
-  runData.totalEvents = totalEvents;
-
-  // Solo branches esenciales
-  attenuationTree->Branch("runID", &runData.runID, "runID/I");
-  attenuationTree->Branch("material", runData.material, "material/C");
-  attenuationTree->Branch("thickness", &runData.thickness, "thickness/F");
-  attenuationTree->Branch("totalEvents", &runData.totalEvents, "totalEvents/I");
-  attenuationTree->Branch("transmittedEvents", &runData.transmittedEvents, "transmittedEvents/I");
-  attenuationTree->Branch("transmissionRatio", &runData.transmissionRatio, "transmissionRatio/F");
-  attenuationTree->Branch("attenuationCoeff", &runData.attenuationCoeff, "attenuationCoeff/F");
-
-  G4cout << "ROOT: Archivo " << rootFileName << " creado (solo datos)" << G4endl;
-#endif
-
-  // Preparar archivo de resultados
-  std::ofstream resultsFile("../results/results_summary.txt", std::ios::app);
-  resultsFile << "\n=== RUN " << run->GetRunID() << " ===\n";
-  resultsFile << "Material: " << detector->GetMaterial() << "\n";
-  resultsFile << "Espesor: " << detector->GetThickness() / CLHEP::cm << " cm\n";
-  resultsFile << "Eventos: " << totalEvents << "\n";
-  resultsFile.close();
+  std::cout << "Eventos totales: " << requestedEvents << std::endl;
+  if (Sharding::IsActive())
+    std::cout << "Fragmento " << Sharding::GetIndex() << "/" << Sharding::GetCount() << ": eventos "
+              << Sharding::GetFirstEvent() << "-" << Sharding::GetFirstEvent() + requestedEvents - 1 << " de "
+              << Sharding::GetTotalEvents() << std::endl;
+  if (precision && precision->IsActive())
+    std::cout << "(máximo: el run se detiene al alcanzar la precisión pedida)" << std::endl;
+  if (detector->GetFastSimulation())
+    std::cout << "Modelo rápido del absorbente: "
+              << (detector->UsesFastSimModel() && !meshTally.IsActive() ? "activo" : "inactivo (transporte completo)")
+              << std::endl;
 }
 
 void RunAction::EndOfRunAction(const G4Run *run)
 {
-  G4double transmissionRatio = (G4double)transmittedEvents / totalEvents;
-  G4double attenuationCoeff = (transmittedEvents > 0) ? -std::log(transmissionRatio) / (detector->GetThickness() / CLHEP::cm) : 999.0;
+  // Suma los contadores de cada hilo de trabajo sobre los del maestro
+  totalSteps += static_cast<G4double>(stepCount);
+  G4AccumulableManager::Instance()->Merge();
+  GAMMAATT_PERF_THREAD_END();
+
+  // Entregar el bloque parcial de eventos de este hilo
+  if (eventBuffer)
+    eventBuffer->Flush();
+
+  if (!IsMaster())
+    return;
+  GAMMAATT_PERF_END(kEventLoop);
+  // El siguiente run vuelve a leer la semilla maestra, no la del último evento
+  EventSeeder::EndRun();
+
+  // Todos los hilos han terminado: esperar a que sus bloques estén en disco
+  if (eventWriter)
+  {
+    GAMMAATT_PERF_SCOPE(kOutputFlush);
+    eventWriter->Flush();
+  }
+
+  runTimer.Stop();
+
+  // Todos los resultados salen de las sumas exactas del run (las mismas que
+  // fusiona gammaAtt-merge cuando el run se reparte con --shard)
+  RunTotals::Totals totals;
+  CollectTotals(run, totals);
+  RunTotals::Results results = RunTotals::Compute(totals);
+
+  lastRun.events = static_cast<G4int>(totals.events);
+  lastRun.transmitted = static_cast<G4int>(totals.transmitted);
+  lastRun.steps = totals.steps;
+  lastRun.transmissionRatio = results.transmission;
+  lastRun.attenuationCoeff = results.mu;
+  lastRun.relError = results.relError;
+  lastRun.uncollided = static_cast<G4int>(totals.uncollided);
+  lastRun.narrowBeamCoeff = results.muNarrow;
+  lastRun.buildup = results.buildup;
+  lastRun.realTime = totals.realTime;
 
   std::cout << "=== Finalizando Run " << run->GetRunID() << " ===" << std::endl;
-  std::cout << "Eventos transmitidos: " << transmittedEvents << std::endl;
-  std::cout << "Razón de transmisión: " << transmissionRatio << std::endl;
-  std::cout << "Coeficiente de atenuación: " << attenuationCoeff << " cm^-1" << std::endl;
+  std::cout << "Energía media del haz: " << results.meanEnergy << " keV" << std::endl;
+  std::cout << "Eventos transmitidos: " << totals.transmitted << std::endl;
+  std::cout << "Razón de transmisión: " << results.transmission << std::endl;
+  std::cout << "Coeficiente de atenuación: " << results.mu << " cm^-1" << std::endl;
+  std::cout << "Error relativo: " << results.relError << std::endl;
+  std::cout << "Sin colisión: " << totals.uncollided << " (T = " << results.uncollidedRatio << ")" << std::endl;
+  std::cout << "Coeficiente de haz estrecho: " << results.muNarrow << " cm^-1 (error relativo "
+            << results.narrowRelError << ")" << std::endl;
+  std::cout << "Factor de acumulación: " << results.buildup << std::endl;
+  std::cout << "Figura de mérito: " << results.fom << " s^-1 (" << totals.realTime << " s)"
+            << (totals.weighted ? " [transformada exponencial]" : "") << std::endl;
+  if (totals.events < totals.shardEvents)
+    std::cout << "Precisión alcanzada con " << totals.events << " de " << totals.shardEvents << " eventos" << std::endl;
 
-#ifdef USE_ROOT
-  // --- DAtos que recolecta ROOT ---
-  // Estos datos son los que utilizaremos más adelante en multi_analysis.C
-  runData.transmittedEvents = transmittedEvents;
-  runData.transmissionRatio = transmissionRatio;
-  runData.attenuationCoeff = attenuationCoeff;
-
-  // Llenar Tree
-  attenuationTree->Fill();
-
-  // Llenar histograma
-  attenuationHist->Fill(attenuationCoeff);
-
-  // Guardar archivo ROOT
-  rootFile->cd();
-  attenuationTree->Write();
-  attenuationHist->Write();
-  rootFile->Close();
-  rootFile->Close();  // Cerramos el archivo aquí
-  delete rootFile;    // Liberamos la memoria
-  rootFile = nullptr; // Evitamos que el destructor intente borrarlo de nuevo
-
-  G4cout << "ROOT: Datos guardados" << G4endl;
-  G4cout << "ROOT: Archivo: data_run" << run->GetRunID() << ".root" << G4endl;
-  G4cout << "ROOT: Datos guardados en data_run_" << detector->GetMaterial() << ".root" << G4endl;
-#endif
+  GAMMAATT_PERF_BEGIN(kOutputFlush);
+  if (Sharding::IsActive())
+  {
+    // Solo las sumas: los resultados finales los escribe gammaAtt-merge
+    std::string directory = "../results/shards";
+    std::error_code ignored;
+    std::filesystem::create_directories(directory, ignored);
+    std::string path = directory + "/run" + std::to_string(totals.runID) + "_" +
+                       ResultsStore::MakeKey(totals.record) + Sharding::Suffix() + ".gashard";
+    if (RunTotals::Save(path, totals))
+      std::cout << "Fragmento guardado en " << path << std::endl;
+    else
+    {
+      G4cerr << "ERROR: no se pudo escribir el fragmento " << path << G4endl;
+      outputsFailed = true;
+    }
+  }
+  else if (!RunTotals::WriteOutputs(totals, ResultsStore::DefaultPath()))
+    outputsFailed = true;
+  GAMMAATT_PERF_END(kOutputFlush);
 
-  // Guardar resultados finales
-  std::ofstream resultsFile("../results/results_summary.txt", std::ios::app);
-  resultsFile << "Transmitidos: " << transmittedEvents << "\n";
-  resultsFile << "Transmisión: " << transmissionRatio << "\n";
-  resultsFile << "Coef. atenuación: " << attenuationCoeff << " cm^-1\n";
-  resultsFile.close();
-
-  // Archivo CSV para ROOT
-  std::ofstream csvFile("../results/attenuation_data.csv", std::ios::app);
-  csvFile << detector->GetMaterial() << ","
-          << detector->GetThickness() / CLHEP::cm << ","
-          << totalEvents << ","
-          << transmittedEvents << ","
-          << transmissionRatio << ","
-          << attenuationCoeff << "\n";
-  csvFile.close();
+  // Bloque de rendimiento (solo con -DGAMMAATT_INSTRUMENT=ON)
+  GAMMAATT_PERF_REPORT(run->GetRunID(), detector->GetMaterial(), detector->GetThickness() / CLHEP::cm);
 }
 
-void RunAction::AddTransmittedEvent()
+void RunAction::CollectTotals(const G4Run *run, RunTotals::Totals &totals) const
 {
-  transmittedEvents++;
-}
\ No newline at end of file
+  // Configuración: la clave del almacén y todo lo que cambia el significado de las sumas.
+  // Con una pila de capas, el material es la pila y la densidad la media másica
+  const G4Material *material = detector->GetAbsorberVolume()->GetMaterial();
+  ResultsStore::Record &record = totals.record;
+  record.material = detector->IsHeterogeneous() ? detector->GetMaterial() : material->GetName();
+  record.label = detector->GetMaterial();
+  record.density = detector->GetMeanDensity() / (g / cm3);
+  record.thickness = detector->GetThickness() / CLHEP::cm;
+  {
+    G4AutoLock lock(&spectrumMutex);
+    record.spectrum = spectrumTag;
+    record.physics = PhysicsTag(detector->UsesFastSimModel() && !meshTally.IsActive()) + fastTag;
+  }
+  record.seed = runSeed;
+  record.requested = Sharding::IsActive() ? Sharding::GetTotalEvents() : run->GetNumberOfEventToBeProcessed();
+  totals.runID = run->GetRunID();
+  totals.weighted = detector->GetBiasing() && detector->GetExpTransform() > 0.;
+
+  totals.shard = Sharding::GetIndex();
+  totals.shards = Sharding::GetCount();
+  totals.firstEvent = Sharding::GetFirstEvent();
+  totals.shardEvents = run->GetNumberOfEventToBeProcessed();
+
+  // Sumas fusionadas de todos los hilos
+  totals.events = totalEvents.GetValue();
+  totals.transmitted = transmittedEvents.GetValue();
+  totals.uncollided = uncollidedEvents.GetValue();
+  totals.energySum = primaryEnergySum.GetValue() / keV;
+  totals.sumW = transmittedWeight.GetValue();
+  totals.sumW2 = transmittedWeight2.GetValue();
+  totals.sumWu = uncollidedWeight.GetValue();
+  totals.sumWu2 = uncollidedWeight2.GetValue();
+  totals.steps = totalSteps.GetValue();
+  totals.realTime = runTimer.GetRealElapsed();
+
+  // Transmisión por energía primaria
+  if (energyBinning)
+  {
+    std::ostringstream edges;
+    edges.precision(17);
+    for (G4double edge : energyBinning->GetEdges())
+      edges << edge / keV << " ";
+    totals.energyBinning = energyBinning->GetEdges().empty() ? "lines" : edges.str();
+    totals.energyFile = energyBinning->GetOutputFile();
+    totals.spectrumFile = energyBinning->GetSpectrumFile();
+  }
+  for (const auto &bin : energyTally.GetBins())
+    totals.energyBins.push_back({bin.low / keV, bin.high / keV, bin.events, bin.sumW, bin.sumW2});
+
+  // Espectro de entrada en el detector
+  if (detectorSpectrum.IsActive())
+  {
+    totals.spectrumBins = static_cast<int>(detectorSpectrum.GetUncollided().size());
+    totals.spectrumWidth = detectorSpectrum.GetBinWidth() / keV;
+    totals.spectrumUncollided = detectorSpectrum.GetUncollided();
+    totals.spectrumScattered = detectorSpectrum.GetScattered();
+  }
+
+  // Transmisión tras cada capa
+  totals.layerFile = "../results/layer_transmission.csv";
+  if (layerTally.IsActive())
+  {
+    std::vector<G4double> faces = detector->GetLayerBackFaces();
+    G4double front = -detector->GetThickness() / 2.0;
+    for (G4int i = 0; i < layerTally.GetNumberOfLayers(); ++i)
+      totals.layers.push_back({detector->GetLayerMaterial(i), (faces[i] - front) / CLHEP::cm,
+                               layerTally.GetSumW()[i], layerTally.GetSumW2()[i]});
+  }
+
+  // Malla de dosis y fluencia: densidad de cada plano z (cambia de una capa a otra)
+  if (meshConfig && meshTally.IsActive())
+  {
+    totals.meshBase = meshConfig->GetOutputBase();
+    totals.meshDims[0] = meshTally.GetNx();
+    totals.meshDims[1] = meshTally.GetNy();
+    totals.meshDims[2] = meshTally.GetNz();
+    G4ThreeVector half = meshTally.GetHalfSize() / CLHEP::cm;
+    totals.meshHalf[0] = half.x();
+    totals.meshHalf[1] = half.y();
+    totals.meshHalf[2] = half.z();
+    for (G4int iz = 0; iz < meshTally.GetNz(); ++iz)
+      totals.planeDensity.push_back(detector->GetDensityAt(meshTally.GetPlaneZ(iz)) / (g / cm3));
+    totals.meshEdep.reserve(meshTally.GetEdep().size());
+    for (G4double e : meshTally.GetEdep())
+      totals.meshEdep.push_back(e / MeV);
+    totals.meshFluence.reserve(meshTally.GetFluence().size());
+    for (G4double l : meshTally.GetFluence())
+      totals.meshFluence.push_back(l / CLHEP::cm);
+  }
+
+  // Fichero ROOT: durante un barrido todos los puntos van al mismo; fuera de
+  // él, uno por clave del almacén
+  G4bool sweepRun = sweep && sweep->IsRunning();
+  totals.rootFile = sweepRun ? "../results/" + sweep->GetOutputName() + ".root" : RunTotals::RunRootFile(record);
+  totals.rootUpdate = sweepRun;
+}
+
+void RunAction::AddEvent(G4double primaryEnergy)
+{
+  totalEvents += 1;
+  primaryEnergySum += primaryEnergy;
+  energyTally.AddEvent(primaryEnergy);
+}
+
+void RunAction::AddTransmittedEvent(G4double primaryEnergy, G4double weight, G4double uncollidedW)
+{
+  energyTally.AddTransmitted(primaryEnergy, weight);
+  transmittedEvents += 1;
+  transmittedWeight += weight;
+  transmittedWeight2 += weight * weight;
+  if (uncollidedW > 0.)
+  {
+    uncollidedEvents += 1;
+    uncollidedWeight += uncollidedW;
+    uncollidedWeight2 += uncollidedW * uncollidedW;
+  }
+  ++batchTransmitted;
+  batchWeight += weight;
+  batchWeight2 += weight * weight;
+}
+
+void RunAction::CheckPrecision()
+{
+  if (!precision || !precision->IsActive())
+    return;
+
+  // Solo se toca el estado compartido una vez por lote
+  if (++batchEvents < precision->GetCheckInterval())
+    return;
+
+  if (precision->Update(batchEvents, batchTransmitted, batchWeight, batchWeight2))
+    G4RunManager::GetRunManager()->AbortRun(true);
+  batchEvents = 0;
+  batchTransmitted = 0;
+  batchWeight = batchWeight2 = 0.;
+}
+
+G4bool RunAction::PrecisionReached() const
+{
+  return precision && precision->IsActive() && precision->IsReached();
+}
+
+void RunAction::RecordEvent(G4int eventID, G4bool detected, G4double edep,
+                            G4double entryEnergy, G4double primaryEnergy)
+{
+  // Número global del evento: el mismo que tendría en un run sin fragmentos
+  if (eventBuffer)
+    eventBuffer->Add(currentRunID, static_cast<G4int>(EventSeeder::GetEventOffset() + eventID), detected, edep,
+                     entryEnergy, primaryEnergy);
+}
@@ -0,0 +1,712 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "RunTotals.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifdef USE_ROOT
+#include "TFile.h"
+#include "TTree.h"
+#include "TLeaf.h"
+#include "TH1F.h"
+#include "TH3F.h"
+#endif
+
+namespace RunTotals
+{
+  namespace
+  {
+    const char *const kMagic = "# gammaAtt-shard 1";
+    const double kJoulePerMeV = 1.602176634e-13;
+
+    std::string Exact(double value)
+    {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+      return buffer;
+    }
+
+    void PutArray(std::ostream &out, const char *name, const std::vector<double> &values)
+    {
+      out << name << " " << values.size();
+      for (double v : values)
+        out << " " << Exact(v);
+      out << "\n";
+    }
+
+    bool GetArray(std::istream &in, std::vector<double> &values)
+    {
+      std::size_t n = 0;
+      if (!(in >> n))
+        return false;
+      values.resize(n);
+      for (double &v : values)
+        if (!(in >> v))
+          return false;
+      return true;
+    }
+
+    // Resto de la línea sin el separador (etiquetas y rutas)
+    std::string GetText(std::istream &in)
+    {
+      std::string text;
+      std::getline(in, text);
+      if (!text.empty() && text[0] == ' ')
+        text.erase(0, 1);
+      return text;
+    }
+
+    void WriteSummary(const Totals &t, const Results &r)
+    {
+      std::ofstream out("../results/results_summary.txt", std::ios::app);
+      out << "\n=== RUN " << t.runID << " ===\n";
+      out << "Material: " << t.record.label << "\n";
+      out << "Espesor: " << t.record.thickness << " cm\n";
+      out << "Eventos: " << t.record.requested << "\n";
+      out << "Semilla maestra: " << t.record.seed << "\n";
+      if (t.shards > 0)
+        out << "Fragmentos: " << t.shards << "\n";
+      out << "Eventos simulados: " << t.events << "\n";
+      out << "Energía media: " << r.meanEnergy << " keV\n";
+      out << "Transmitidos: " << t.transmitted << "\n";
+      out << "Transmisión: " << r.transmission << "\n";
+      out << "Coef. atenuación: " << r.mu << " cm^-1\n";
+      out << "Error relativo: " << r.relError << "\n";
+      out << "Figura de mérito: " << r.fom << " s^-1\n";
+      out << "Sin colisión: " << t.uncollided << "\n";
+      out << "Coef. haz estrecho: " << r.muNarrow << " cm^-1\n";
+      out << "Factor de acumulación: " << r.buildup << "\n";
+    }
+
+    void WriteEnergyTally(const Totals &t)
+    {
+      // Solo tiene interés con más de una energía (espectros o líneas múltiples)
+      if (t.energyBins.size() < 2 || t.energyFile.empty())
+        return;
+
+      bool newFile = !std::ifstream(t.energyFile).good();
+      std::ofstream csvFile(t.energyFile, std::ios::app);
+      if (newFile)
+        csvFile << "runID,material,thickness_cm,E_low_keV,E_high_keV,events,transmitted,"
+                   "transmissionRatio,attenuationCoeff,relError\n";
+
+      std::cout << "--- Transmisión por energía (" << t.energyBins.size() << " bins) ---" << std::endl;
+      for (const auto &bin : t.energyBins)
+      {
+        double ratio = (bin.events > 0.) ? bin.sumW / bin.events : 0.;
+        double coeff = (bin.sumW > 0.) ? -std::log(ratio) / t.record.thickness : 999.0;
+        double var = (bin.events > 1.) ? (bin.sumW2 / bin.events - ratio * ratio) / (bin.events - 1.) : 0.;
+        double relError = (bin.sumW > 0. && ratio < 1.) ? std::sqrt(std::max(var, 0.)) / ratio / -std::log(ratio) : -1.;
+
+        csvFile << t.runID << "," << t.record.label << "," << t.record.thickness << "," << bin.low << ","
+                << bin.high << "," << bin.events << "," << bin.sumW << "," << ratio << "," << coeff << ","
+                << relError << "\n";
+        std::cout << "  " << bin.low << "-" << bin.high << " keV: T = " << ratio << ", mu = " << coeff
+                  << " cm^-1 (" << bin.events << " eventos)" << std::endl;
+      }
+      std::cout << "Tally por energía guardado en " << t.energyFile << std::endl;
+    }
+
+    void WriteDetectorSpectrum(const Totals &t)
+    {
+      if (t.spectrumUncollided.empty() || t.spectrumFile.empty())
+        return;
+
+      bool newFile = !std::ifstream(t.spectrumFile).good();
+      std::ofstream csvFile(t.spectrumFile, std::ios::app);
+      if (newFile)
+        csvFile << "runID,material,thickness_cm,E_low_keV,E_high_keV,uncollided,scattered\n";
+
+      // Solo los bins con algún fotón; el último es el desbordamiento (E_high vacío)
+      const auto &uncollided = t.spectrumUncollided;
+      const auto &scattered = t.spectrumScattered;
+      for (std::size_t i = 0; i < uncollided.size(); ++i)
+      {
+        if (uncollided[i] == 0. && scattered[i] == 0.)
+          continue;
+        csvFile << t.runID << "," << t.record.label << "," << t.record.thickness << "," << i * t.spectrumWidth << ",";
+        if (i + 1 < uncollided.size())
+          csvFile << (i + 1) * t.spectrumWidth;
+        csvFile << "," << uncollided[i] << "," << scattered[i] << "\n";
+      }
+      std::cout << "Espectro del detector guardado en " << t.spectrumFile << std::endl;
+    }
+
+    void WriteLayerTransmission(const Totals &t)
+    {
+      if (t.layers.empty() || t.events <= 0 || t.layerFile.empty())
+        return;
+
+      bool newFile = !std::ifstream(t.layerFile).good();
+      std::ofstream csvFile(t.layerFile, std::ios::app);
+      if (newFile)
+        csvFile << "runID,stack,layer,material,depth_cm,transmission,relError\n";
+
+      // Transmisión acumulada tras cada capa y su error relativo (varianza de los pesos)
+      double n = static_cast<double>(t.events);
+      std::cout << "--- Transmisión por capa (" << t.layers.size() << " capas) ---" << std::endl;
+      for (std::size_t i = 0; i < t.layers.size(); ++i)
+      {
+        const Layer &layer = t.layers[i];
+        double ratio = layer.sumW / n;
+        double var = (t.events > 1) ? (layer.sumW2 / n - ratio * ratio) / (n - 1.) : 0.;
+        double relError = (ratio > 0.) ? std::sqrt(std::max(var, 0.)) / ratio : -1.;
+        csvFile << t.runID << "," << t.record.label << "," << i << "," << layer.material << "," << layer.depth << ","
+                << ratio << "," << relError << "\n";
+        std::cout << "  Capa " << i << " (" << layer.material << ", " << layer.depth << " cm): T = " << ratio
+                  << std::endl;
+      }
+      std::cout << "Transmisión por capa guardada en " << t.layerFile << std::endl;
+    }
+
+    void WriteMesh(const Totals &t)
+    {
+      const int nx = t.meshDims[0], ny = t.meshDims[1], nz = t.meshDims[2];
+      std::size_t n = static_cast<std::size_t>(nx) * ny * nz;
+      if (n == 0 || t.meshBase.empty() || t.events <= 0 || t.meshEdep.size() != n ||
+          static_cast<int>(t.planeDensity.size()) != nz)
+        return;
+
+      // Dosis en Gy y fluencia en cm^-2, ambas por evento primario
+      double voxel[3] = {2. * t.meshHalf[0] / nx, 2. * t.meshHalf[1] / ny, 2. * t.meshHalf[2] / nz};
+      double voxelVolume = voxel[0] * voxel[1] * voxel[2];
+      double events = static_cast<double>(t.events);
+      double fluenceScale = 1. / (voxelVolume * events);
+
+      std::size_t planeSize = static_cast<std::size_t>(nx) * ny;
+      std::vector<float> dose(n), flu(n);
+      double density = 0.; // Media de los planos, para la cabecera
+      for (int iz = 0; iz < nz; ++iz)
+      {
+        double voxelMass = t.planeDensity[iz] * voxelVolume * 1e-3; // kg
+        double doseScale = (voxelMass > 0.) ? kJoulePerMeV / (voxelMass * events) : 0.;
+        for (std::size_t i = iz * planeSize; i < (iz + 1) * planeSize; ++i)
+        {
+          dose[i] = static_cast<float>(t.meshEdep[i] * doseScale);
+          flu[i] = static_cast<float>(t.meshFluence[i] * fluenceScale);
+        }
+        density += t.planeDensity[iz] / nz;
+      }
+      auto index = [&](int ix, int iy, int iz) { return (static_cast<std::size_t>(iz) * ny + iy) * nx + ix; };
+
+      std::string stem = t.meshBase + "_run" + std::to_string(t.runID);
+
+      // Cabecera fija de 96 bytes seguida de los dos arrays float32 (x varía más rápido)
+      std::ofstream out(stem + ".gamesh", std::ios::binary | std::ios::trunc);
+      char magic[8] = {'G', 'A', 'M', 'E', 'S', 'H', '1', '\0'};
+      std::int32_t dims[3] = {nx, ny, nz};
+      std::int64_t nEvents = t.events;
+      char name[32] = {};
+      std::strncpy(name, t.record.material.c_str(), sizeof(name) - 1);
+      std::int32_t padding = 0;
+      out.write(magic, sizeof(magic));
+      out.write(reinterpret_cast<const char *>(dims), sizeof(dims));
+      out.write(reinterpret_cast<const char *>(&padding), sizeof(padding));
+      out.write(reinterpret_cast<const char *>(t.meshHalf), sizeof(t.meshHalf));
+      out.write(reinterpret_cast<const char *>(&density), sizeof(density));
+      out.write(reinterpret_cast<const char *>(&nEvents), sizeof(nEvents));
+      out.write(name, sizeof(name));
+      out.write(reinterpret_cast<const char *>(dose.data()), n * sizeof(float));
+      out.write(reinterpret_cast<const char *>(flu.data()), n * sizeof(float));
+      out.close();
+
+      // Perfil en profundidad: dosis media de cada capa y fluencia en el eje del haz
+      std::ofstream csv(stem + "_depth.csv", std::ios::trunc);
+      csv << "z_cm,dose_Gy_per_primary,axis_fluence_per_cm2_per_primary\n";
+      int cx = nx / 2, cy = ny / 2;
+      for (int iz = 0; iz < nz; ++iz)
+      {
+        double layer = 0.;
+        for (int iy = 0; iy < ny; ++iy)
+          for (int ix = 0; ix < nx; ++ix)
+            layer += dose[index(ix, iy, iz)];
+        csv << -t.meshHalf[2] + (iz + 0.5) * voxel[2] << "," << layer / (nx * ny) << ","
+            << flu[index(cx, cy, iz)] << "\n";
+      }
+      csv.close();
+
+#ifdef USE_ROOT
+      TFile rootFile((stem + ".root").c_str(), "RECREATE");
+      const double *h = t.meshHalf;
+      TH3F doseHist("dose", "Dosis por primario;x (cm);y (cm);z (cm)", nx, -h[0], h[0], ny, -h[1], h[1], nz,
+                    -h[2], h[2]);
+      TH3F fluenceHist("fluence", "Fluencia de fotones por primario;x (cm);y (cm);z (cm)", nx, -h[0], h[0], ny,
+                       -h[1], h[1], nz, -h[2], h[2]);
+      doseHist.SetDirectory(nullptr); // Los histogramas son de esta función, no del fichero
+      fluenceHist.SetDirectory(nullptr);
+      for (int iz = 0; iz < nz; ++iz)
+        for (int iy = 0; iy < ny; ++iy)
+          for (int ix = 0; ix < nx; ++ix)
+          {
+            doseHist.SetBinContent(ix + 1, iy + 1, iz + 1, dose[index(ix, iy, iz)]);
+            fluenceHist.SetBinContent(ix + 1, iy + 1, iz + 1, flu[index(ix, iy, iz)]);
+          }
+      rootFile.WriteTObject(&doseHist);
+      rootFile.WriteTObject(&fluenceHist);
+      rootFile.Close();
+#endif
+
+      std::cout << "Malla " << nx << "x" << ny << "x" << nz << " guardada en " << stem << ".gamesh" << std::endl;
+    }
+
+#ifdef USE_ROOT
+    // Una fila por run en el árbol "data" (lo leen las macros de analysis/)
+    void WriteRoot(const Totals &t, const Results &r)
+    {
+      if (t.rootFile.empty())
+        return;
+
+      struct RunData
+      {
+        Int_t runID;
+        Char_t material[50];
+        Float_t thickness;
+        Float_t energy; // keV
+        // Contadores de 64 bits: la fusión de muchos fragmentos pasa de 2^31 eventos
+        Long64_t totalEvents;     // Eventos realmente simulados
+        Long64_t requestedEvents; // Pedidos a BeamOn (máximo en /run/beamToPrecision)
+        Long64_t transmittedEvents;
+        Float_t transmissionRatio;
+        Float_t attenuationCoeff;
+        Float_t relError; // Error relativo de attenuationCoeff
+        Float_t fom;      // Figura de mérito 1/(R^2 t) de la transmisión
+        Long64_t uncollidedEvents; // Eventos con un fotón sin colisión en el detector
+        Float_t narrowBeamCoeff;  // mu de haz estrecho (cm^-1)
+        Float_t buildup;          // T_total / T_sin_colisión
+        Long64_t seed;            // Semilla maestra: con runID fija la semilla de cada evento
+      } runData;
+
+      runData.runID = t.runID;
+      std::strncpy(runData.material, t.record.label.c_str(), 49);
+      runData.material[49] = '\0';
+      runData.thickness = t.record.thickness;
+      runData.energy = r.meanEnergy;
+      runData.totalEvents = t.events;
+      runData.requestedEvents = t.record.requested;
+      runData.transmittedEvents = t.transmitted;
+      runData.transmissionRatio = r.transmission;
+      runData.attenuationCoeff = r.mu;
+      runData.relError = r.relError;
+      runData.fom = r.fom;
+      runData.uncollidedEvents = t.uncollided;
+      runData.narrowBeamCoeff = r.muNarrow;
+      runData.buildup = r.buildup;
+      runData.seed = t.record.seed;
+
+      // Durante un barrido todos los puntos van al mismo fichero
+      std::error_code ignored;
+      std::filesystem::create_directories(std::filesystem::path(t.rootFile).parent_path(), ignored);
+      TFile rootFile(t.rootFile.c_str(), t.rootUpdate ? "UPDATE" : "RECREATE");
+      TTree *tree = static_cast<TTree *>(rootFile.Get("data"));
+      bool appendRun = (tree != nullptr);
+      // Un árbol de una versión anterior tiene los contadores en 32 bits: no
+      // se le pueden añadir filas con las direcciones de 64 bits
+      TLeaf *eventsLeaf = appendRun ? tree->GetLeaf("totalEvents") : nullptr;
+      if (appendRun && (!eventsLeaf || std::strcmp(eventsLeaf->GetTypeName(), "Long64_t") != 0))
+      {
+        std::cerr << "ERROR: " << t.rootFile << " tiene un árbol 'data' con contadores de 32 bits;"
+                  << " usa otro /sweep/output" << std::endl;
+        return;
+      }
+      if (!appendRun)
+        tree = new TTree("data", "Attenuation Data");
+      TH1F *hist = static_cast<TH1F *>(rootFile.Get("attenuationCoeff"));
+      if (!hist)
+        hist = new TH1F("attenuationCoeff", "Coeficiente de Atenuacion;Coeficiente (cm^{-1});Frecuencia", 100, 0, 0.2);
+
+      auto bind = [&](const char *name, void *address, const char *leaflist)
+      {
+        if (appendRun)
+          tree->SetBranchAddress(name, address);
+        else
+          tree->Branch(name, address, leaflist);
+      };
+      bind("runID", &runData.runID, "runID/I");
+      bind("material", runData.material, "material/C");
+      bind("thickness", &runData.thickness, "thickness/F");
+      bind("energy", &runData.energy, "energy/F");
+      bind("totalEvents", &runData.totalEvents, "totalEvents/L");
+      bind("requestedEvents", &runData.requestedEvents, "requestedEvents/L");
+      bind("transmittedEvents", &runData.transmittedEvents, "transmittedEvents/L");
+      bind("transmissionRatio", &runData.transmissionRatio, "transmissionRatio/F");
+      bind("attenuationCoeff", &runData.attenuationCoeff, "attenuationCoeff/F");
+      bind("relError", &runData.relError, "relError/F");
+      bind("fom", &runData.fom, "fom/F");
+      bind("uncollidedEvents", &runData.uncollidedEvents, "uncollidedEvents/L");
+      bind("narrowBeamCoeff", &runData.narrowBeamCoeff, "narrowBeamCoeff/F");
+      bind("buildup", &runData.buildup, "buildup/F");
+      bind("seed", &runData.seed, "seed/L");
+
+      tree->Fill();
+      hist->Fill(r.mu);
+      rootFile.cd();
+      tree->Write("", TObject::kOverwrite);
+      hist->Write("", TObject::kOverwrite);
+      tree->ResetBranchAddresses(); // runData es local
+      rootFile.Close();
+      std::cout << "ROOT: Datos guardados en " << t.rootFile << std::endl;
+    }
+#endif
+  }
+
+  double RelativeError(long long n, long long k)
+  {
+    if (n <= 0 || k <= 0 || k >= n)
+      return -1.;
+
+    // Intervalo de Wilson con z = 1, robusto cuando T es próxima a 0 o a 1
+    const double z2 = 1.;
+    double nd = static_cast<double>(n);
+    double p = static_cast<double>(k) / nd;
+    double denom = 1. + z2 / nd;
+    double centre = (p + z2 / (2. * nd)) / denom;
+    double half = std::sqrt(p * (1. - p) / nd + z2 / (4. * nd * nd)) / denom;
+    double low = centre - half;
+    double high = centre + half;
+
+    // Se propaga a mu = -ln(T)/x; el espesor x se cancela en el cociente
+    double mu = -std::log(p);
+    return 0.5 * (std::log(high) - std::log(low)) / mu;
+  }
+
+  double WeightedRelativeError(long long n, double sumW, double sumW2)
+  {
+    if (n <= 0 || sumW <= 0.)
+      return -1.;
+    double nd = static_cast<double>(n);
+    double transmission = sumW / nd;
+    if (transmission >= 1.)
+      return -1.;
+    double var = (n > 1) ? (sumW2 / nd - transmission * transmission) / (nd - 1.) : 0.0;
+    return std::sqrt(std::max(var, 0.)) / transmission / -std::log(transmission);
+  }
+
+  Results Compute(const Totals &t)
+  {
+    Results r;
+    double n = static_cast<double>(t.events);
+
+    // Transmisión ponderada: sin biasing todos los pesos valen 1 y coincide con k/n
+    r.transmission = (t.events > 0) ? t.sumW / n : 0.0;
+    r.meanEnergy = (t.events > 0) ? t.energySum / n : 0.0;
+    r.mu = (t.sumW > 0.) ? -std::log(r.transmission) / t.record.thickness : 999.0;
+
+    // Varianza de la media de los pesos por evento (0 en los no transmitidos)
+    double varT = (t.events > 1) ? (t.sumW2 / n - r.transmission * r.transmission) / (n - 1.) : 0.0;
+    r.relErrorT = (t.sumW > 0.) ? std::sqrt(std::max(varT, 0.)) / r.transmission : 0.0;
+
+    // Error relativo de mu: Wilson en modo analógico, propagación de la varianza ponderada con biasing
+    r.relError = RelativeError(t.events, t.transmitted);
+    if (t.weighted)
+      r.relError = WeightedRelativeError(t.events, t.sumW, t.sumW2);
+
+    // Haz estrecho: solo los fotones primarios que cruzan el absorbente sin
+    // ninguna interacción; su cociente con la transmisión total es el factor de acumulación
+    r.uncollidedRatio = (t.events > 0) ? t.sumWu / n : 0.0;
+    r.muNarrow = (t.sumWu > 0.) ? -std::log(r.uncollidedRatio) / t.record.thickness : 999.0;
+    r.buildup = (t.sumWu > 0.) ? t.sumW / t.sumWu : 0.0;
+    r.narrowRelError = RelativeError(t.events, t.uncollided);
+    if (t.weighted)
+    {
+      double u = r.uncollidedRatio;
+      double varU = (t.events > 1) ? (t.sumWu2 / n - u * u) / (n - 1.) : 0.0;
+      r.narrowRelError = (t.sumWu > 0. && u < 1.) ? std::sqrt(std::max(varU, 0.)) / u / -std::log(u) : -1.;
+    }
+
+    // Figura de mérito 1/(R^2 t): comparable entre runs analógicos y con biasing
+    r.fom = (r.relErrorT > 0. && t.realTime > 0.) ? 1. / (r.relErrorT * r.relErrorT * t.realTime) : 0.0;
+    return r;
+  }
+
+  bool Save(const std::string &path, const Totals &t)
+  {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+      return false;
+
+    const ResultsStore::Record &c = t.record;
+    out << kMagic << "\n";
+    out << "material " << c.material << "\n";
+    out << "label " << c.label << "\n";
+    out << "density " << Exact(c.density) << "\n";
+    out << "thickness " << Exact(c.thickness) << "\n";
+    out << "spectrum " << c.spectrum << "\n";
+    out << "physics " << c.physics << "\n";
+    out << "seed " << c.seed << "\n";
+    out << "requested " << c.requested << "\n";
+    out << "runID " << t.runID << "\n";
+    out << "weighted " << t.weighted << "\n";
+    out << "energyBinning " << t.energyBinning << "\n";
+    out << "spectrumBins " << t.spectrumBins << " " << Exact(t.spectrumWidth) << "\n";
+    out << "layers " << t.layers.size() << "\n";
+    for (const Layer &layer : t.layers)
+      out << "layer " << Exact(layer.depth) << " " << Exact(layer.sumW) << " " << Exact(layer.sumW2) << " "
+          << layer.material << "\n";
+    out << "mesh " << t.meshDims[0] << " " << t.meshDims[1] << " " << t.meshDims[2] << " " << Exact(t.meshHalf[0])
+        << " " << Exact(t.meshHalf[1]) << " " << Exact(t.meshHalf[2]) << "\n";
+    PutArray(out, "planeDensity", t.planeDensity);
+    out << "shard " << t.shard << " " << t.shards << " " << t.firstEvent << " " << t.shardEvents << "\n";
+
+    out << "energyFile " << t.energyFile << "\n";
+    out << "spectrumFile " << t.spectrumFile << "\n";
+    out << "layerFile " << t.layerFile << "\n";
+    out << "meshBase " << t.meshBase << "\n";
+    out << "rootFile " << t.rootFile << "\n";
+    out << "rootUpdate " << t.rootUpdate << "\n";
+
+    out << "counts " << t.events << " " << t.transmitted << " " << t.uncollided << "\n";
+    out << "sums " << Exact(t.energySum) << " " << Exact(t.sumW) << " " << Exact(t.sumW2) << " " << Exact(t.sumWu)
+        << " " << Exact(t.sumWu2) << " " << Exact(t.steps) << " " << Exact(t.realTime) << "\n";
+    out << "energyBins " << t.energyBins.size() << "\n";
+    for (const EnergyBin &bin : t.energyBins)
+      out << "bin " << Exact(bin.low) << " " << Exact(bin.high) << " " << Exact(bin.events) << " "
+          << Exact(bin.sumW) << " " << Exact(bin.sumW2) << "\n";
+    PutArray(out, "spectrumUncollided", t.spectrumUncollided);
+    PutArray(out, "spectrumScattered", t.spectrumScattered);
+    PutArray(out, "meshEdep", t.meshEdep);
+    PutArray(out, "meshFluence", t.meshFluence);
+    out << "end\n";
+    return static_cast<bool>(out);
+  }
+
+  bool Load(const std::string &path, Totals &t, std::string &error)
+  {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kMagic)
+    {
+      error = path + ": no es un fragmento de gammaAtt";
+      return false;
+    }
+
+    t = Totals();
+    ResultsStore::Record &c = t.record;
+    std::string name;
+    bool ok = true, complete = false;
+    while (ok && !complete && in >> name)
+    {
+      if (name == "material") c.material = GetText(in);
+      else if (name == "label") c.label = GetText(in);
+      else if (name == "density") ok = static_cast<bool>(in >> c.density);
+      else if (name == "thickness") ok = static_cast<bool>(in >> c.thickness);
+      else if (name == "spectrum") c.spectrum = GetText(in);
+      else if (name == "physics") c.physics = GetText(in);
+      else if (name == "seed") ok = static_cast<bool>(in >> c.seed);
+      else if (name == "requested") ok = static_cast<bool>(in >> c.requested);
+      else if (name == "runID") ok = static_cast<bool>(in >> t.runID);
+      else if (name == "weighted") ok = static_cast<bool>(in >> t.weighted);
+      else if (name == "energyBinning") t.energyBinning = GetText(in);
+      else if (name == "spectrumBins") ok = static_cast<bool>(in >> t.spectrumBins >> t.spectrumWidth);
+      else if (name == "layers")
+      {
+        std::size_t n = 0;
+        ok = static_cast<bool>(in >> n);
+        t.layers.reserve(n);
+      }
+      else if (name == "layer")
+      {
+        Layer layer;
+        ok = static_cast<bool>(in >> layer.depth >> layer.sumW >> layer.sumW2);
+        layer.material = GetText(in);
+        t.layers.push_back(layer);
+      }
+      else if (name == "mesh")
+        ok = static_cast<bool>(in >> t.meshDims[0] >> t.meshDims[1] >> t.meshDims[2] >> t.meshHalf[0] >>
+                               t.meshHalf[1] >> t.meshHalf[2]);
+      else if (name == "planeDensity") ok = GetArray(in, t.planeDensity);
+      else if (name == "shard") ok = static_cast<bool>(in >> t.shard >> t.shards >> t.firstEvent >> t.shardEvents);
+      else if (name == "energyFile") t.energyFile = GetText(in);
+      else if (name == "spectrumFile") t.spectrumFile = GetText(in);
+      else if (name == "layerFile") t.layerFile = GetText(in);
+      else if (name == "meshBase") t.meshBase = GetText(in);
+      else if (name == "rootFile") t.rootFile = GetText(in);
+      else if (name == "rootUpdate") ok = static_cast<bool>(in >> t.rootUpdate);
+      else if (name == "counts") ok = static_cast<bool>(in >> t.events >> t.transmitted >> t.uncollided);
+      else if (name == "sums")
+        ok = static_cast<bool>(in >> t.energySum >> t.sumW >> t.sumW2 >> t.sumWu >> t.sumWu2 >> t.steps >> t.realTime);
+      else if (name == "energyBins")
+      {
+        std::size_t n = 0;
+        ok = static_cast<bool>(in >> n);
+        t.energyBins.reserve(n);
+      }
+      else if (name == "bin")
+      {
+        EnergyBin bin;
+        ok = static_cast<bool>(in >> bin.low >> bin.high >> bin.events >> bin.sumW >> bin.sumW2);
+        t.energyBins.push_back(bin);
+      }
+      else if (name == "spectrumUncollided") ok = GetArray(in, t.spectrumUncollided);
+      else if (name == "spectrumScattered") ok = GetArray(in, t.spectrumScattered);
+      else if (name == "meshEdep") ok = GetArray(in, t.meshEdep);
+      else if (name == "meshFluence") ok = GetArray(in, t.meshFluence);
+      else if (name == "end") complete = true;
+      else
+      {
+        error = path + ": entrada desconocida '" + name + "'";
+        return false;
+      }
+    }
+
+    // Sin "end" el fragmento se cortó al escribirlo (nodo caído, disco lleno)
+    if (!ok || !complete)
+    {
+      error = path + (ok ? ": fichero incompleto" : ": valor no válido en '" + name + "'");
+      return false;
+    }
+    return true;
+  }
+
+  std::string Mismatch(const Totals &a, const Totals &b)
+  {
+    const ResultsStore::Record &x = a.record, &y = b.record;
+    if (x.material != y.material || x.label != y.label)
+      return "material";
+    if (x.density != y.density)
+      return "density";
+    if (x.thickness != y.thickness)
+      return "thickness";
+    if (x.spectrum != y.spectrum)
+      return "spectrum";
+    if (x.physics != y.physics)
+      return "physics";
+    if (x.seed != y.seed)
+      return "seed";
+    if (x.requested != y.requested)
+      return "requested";
+    if (a.runID != b.runID)
+      return "runID";
+    if (a.weighted != b.weighted)
+      return "weighted";
+    if (a.energyBinning != b.energyBinning)
+      return "energyBinning";
+    if (a.spectrumBins != b.spectrumBins || a.spectrumWidth != b.spectrumWidth)
+      return "spectrumBins";
+    if (a.layers.size() != b.layers.size())
+      return "layers";
+    for (std::size_t i = 0; i < a.layers.size(); ++i)
+      if (a.layers[i].material != b.layers[i].material || a.layers[i].depth != b.layers[i].depth)
+        return "layers";
+    for (int i = 0; i < 3; ++i)
+      if (a.meshDims[i] != b.meshDims[i] || a.meshHalf[i] != b.meshHalf[i])
+        return "mesh";
+    if (a.planeDensity != b.planeDensity)
+      return "planeDensity";
+    if (a.shards != b.shards)
+      return "shards";
+    return "";
+  }
+
+  bool Add(Totals &into, const Totals &shard, std::string &error)
+  {
+    error = Mismatch(into, shard);
+    if (error.empty() && (shard.spectrumUncollided.size() != into.spectrumUncollided.size() ||
+                          shard.spectrumScattered.size() != into.spectrumScattered.size() ||
+                          shard.meshEdep.size() != into.meshEdep.size() ||
+                          shard.meshFluence.size() != into.meshFluence.size()))
+      error = "arrays";
+    if (!error.empty())
+      return false;
+
+    into.shardEvents += shard.shardEvents;
+    into.firstEvent = std::min(into.firstEvent, shard.firstEvent);
+    into.events += shard.events;
+    into.transmitted += shard.transmitted;
+    into.uncollided += shard.uncollided;
+    into.energySum += shard.energySum;
+    into.sumW += shard.sumW;
+    into.sumW2 += shard.sumW2;
+    into.sumWu += shard.sumWu;
+    into.sumWu2 += shard.sumWu2;
+    into.steps += shard.steps;
+    into.realTime += shard.realTime;
+
+    // Bins por energía: en modo líneas cada fragmento puede tener energías distintas
+    std::map<std::pair<double, double>, EnergyBin> bins;
+    auto addBins = [&bins](const std::vector<EnergyBin> &source)
+    {
+      for (const EnergyBin &bin : source)
+      {
+        EnergyBin &target = bins[{bin.low, bin.high}];
+        target.low = bin.low;
+        target.high = bin.high;
+        target.events += bin.events;
+        target.sumW += bin.sumW;
+        target.sumW2 += bin.sumW2;
+      }
+    };
+    addBins(into.energyBins);
+    addBins(shard.energyBins);
+    into.energyBins.clear();
+    for (const auto &entry : bins)
+      into.energyBins.push_back(entry.second);
+
+    for (std::size_t i = 0; i < into.spectrumUncollided.size(); ++i)
+    {
+      into.spectrumUncollided[i] += shard.spectrumUncollided[i];
+      into.spectrumScattered[i] += shard.spectrumScattered[i];
+    }
+    for (std::size_t i = 0; i < into.layers.size(); ++i)
+    {
+      into.layers[i].sumW += shard.layers[i].sumW;
+      into.layers[i].sumW2 += shard.layers[i].sumW2;
+    }
+    for (std::size_t i = 0; i < into.meshEdep.size(); ++i)
+    {
+      into.meshEdep[i] += shard.meshEdep[i];
+      into.meshFluence[i] += shard.meshFluence[i];
+    }
+    return true;
+  }
+
+  std::string RunRootFile(const ResultsStore::Record &record)
+  {
+    return "../results/runs/" + ResultsStore::MakeKey(record) + ".root";
+  }
+
+  bool WriteOutputs(Totals &t, const std::string &storePath)
+  {
+    Results r = Compute(t);
+    WriteSummary(t, r);
+
+#ifdef USE_ROOT
+    WriteRoot(t, r);
+#endif
+
+    // Almacén único de resultados, indexado por la configuración del run
+    ResultsStore::Record &record = t.record;
+    record.events = t.events;
+    record.transmitted = t.transmitted;
+    record.transmission = r.transmission;
+    record.mu = r.mu;
+    record.relError = r.relError;
+    record.meanEnergy = r.meanEnergy;
+    record.fom = r.fom;
+    record.uncollided = t.uncollided;
+    record.muNarrow = r.muNarrow;
+    record.narrowRelError = r.narrowRelError;
+    record.buildup = r.buildup;
+    bool stored = ResultsStore::Append(storePath, record);
+    if (stored)
+      std::cout << "Resultado guardado en " << storePath << " [" << record.key << "]" << std::endl;
+    else
+      std::cerr << "ERROR: no se pudo escribir en el almacén " << storePath << std::endl;
+
+    WriteEnergyTally(t);
+    WriteDetectorSpectrum(t);
+    WriteLayerTransmission(t);
+    WriteMesh(t);
+    return stored;
+  }
+}
@@ -0,0 +1,47 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "Sharding.hh"
+#include <sstream>
+
+G4int Sharding::index = 0;
+G4int Sharding::count = 0;
+G4long Sharding::firstEvent = 0;
+G4int Sharding::totalEvents = 0;
+
+G4bool Sharding::Configure(const G4String &spec)
+{
+  std::istringstream is(spec);
+  G4int i = -1, n = 0;
+  char slash = 0;
+  if (!(is >> i >> slash >> n) || slash != '/' || !is.eof() || n < 1 || i < 0 || i >= n)
+    return false;
+  index = i;
+  count = n;
+  return true;
+}
+
+G4int Sharding::BeginBeamOn(G4int total)
+{
+  totalEvents = total;
+  if (!IsActive() || total <= 0)
+  {
+    firstEvent = 0;
+    return total;
+  }
+
+  // Reparto en 64 bits: n*i/N desborda un G4int con runs de 1e9 eventos
+  G4long n = total;
+  firstEvent = n * index / count;
+  G4long lastEvent = n * (index + 1) / count;
+  return static_cast<G4int>(lastEvent - firstEvent);
+}
+
+G4String Sharding::Suffix()
+{
+  if (!IsActive())
+    return "";
+  return "_shard" + std::to_string(index) + "of" + std::to_string(count);
+}
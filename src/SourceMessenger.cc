@@ -0,0 +1,99 @@
+#include "SourceMessenger.hh"
+#include "SourceSpectrum.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include <sstream>
+
+SourceMessenger::SourceMessenger(SourceSpectrum *spec)
+    : G4UImessenger(), spectrum(spec)
+{
+    // Crear directorio de comandos
+    sourceDir = new G4UIdirectory("/source/");
+    sourceDir->SetGuidance("Espectro de energía de la fuente (muestreo con tabla alias)");
+
+    presetCmd = new G4UIcmdWithAString("/source/preset", this);
+    presetCmd->SetGuidance("Líneas gamma de un radionúclido");
+    presetCmd->SetParameterName("nuclide", false);
+    presetCmd->SetCandidates("Cs137 Co60 Am241");
+    presetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    addLineCmd = new G4UIcommand("/source/addLine", this);
+    addLineCmd->SetGuidance("Añade una línea discreta: energía, unidad e intensidad relativa");
+    addLineCmd->SetGuidance("Ej: /source/addLine 662 keV 0.85");
+    auto energyParam = new G4UIparameter("energy", 'd', false);
+    energyParam->SetParameterRange("energy > 0.");
+    addLineCmd->SetParameter(energyParam);
+    auto unitParam = new G4UIparameter("unit", 's', true);
+    unitParam->SetDefaultValue("keV");
+    addLineCmd->SetParameter(unitParam);
+    auto intensityParam = new G4UIparameter("intensity", 'd', true);
+    intensityParam->SetDefaultValue(1.);
+    intensityParam->SetParameterRange("intensity > 0.");
+    addLineCmd->SetParameter(intensityParam);
+    addLineCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    linesFileCmd = new G4UIcmdWithAString("/source/linesFile", this);
+    linesFileCmd->SetGuidance("Líneas discretas desde fichero: 'E_keV intensidad' por fila");
+    linesFileCmd->SetParameterName("file", false);
+    linesFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    spectrumFileCmd = new G4UIcmdWithAString("/source/spectrumFile", this);
+    spectrumFileCmd->SetGuidance("Espectro continuo tabulado: 'E_keV fluencia' por fila (p.ej. tubo de rayos X)");
+    spectrumFileCmd->SetGuidance("Entre nodos la fluencia se interpola linealmente");
+    spectrumFileCmd->SetParameterName("file", false);
+    spectrumFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    monoCmd = new G4UIcmdWithoutParameter("/source/mono", this);
+    monoCmd->SetGuidance("Elimina el espectro: la energía vuelve a ser la de /gun/energy");
+    monoCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    listCmd = new G4UIcmdWithoutParameter("/source/list", this);
+    listCmd->SetGuidance("Muestra el espectro actual");
+    listCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+SourceMessenger::~SourceMessenger()
+{
+    delete presetCmd;
+    delete addLineCmd;
+    delete linesFileCmd;
+    delete spectrumFileCmd;
+    delete monoCmd;
+    delete listCmd;
+    delete sourceDir;
+}
+
+void SourceMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == presetCmd)
+    {
+        spectrum->SetPreset(newValue);
+    }
+    else if (command == addLineCmd)
+    {
+        G4double energy, intensity;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> energy >> unit >> intensity;
+        spectrum->AddLine(energy * G4UIcommand::ValueOf(unit), intensity);
+    }
+    else if (command == linesFileCmd)
+    {
+        spectrum->LoadLines(newValue);
+    }
+    else if (command == spectrumFileCmd)
+    {
+        spectrum->LoadContinuous(newValue);
+    }
+    else if (command == monoCmd)
+    {
+        spectrum->Clear();
+    }
+    else if (command == listCmd)
+    {
+        spectrum->Print();
+    }
+}
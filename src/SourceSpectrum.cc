@@ -0,0 +1,248 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "SourceSpectrum.hh"
+#include "ResultsStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+SourceSpectrum::SourceSpectrum()
+    : type(Type::Mono)
+{
+}
+
+void SourceSpectrum::Clear()
+{
+  type = Type::Mono;
+  energies.clear();
+  values.clear();
+  aliasProb.clear();
+  aliasIndex.clear();
+}
+
+void SourceSpectrum::AddLine(G4double energy, G4double intensity)
+{
+  if (type == Type::Continuous)
+    Clear();
+  type = Type::Lines;
+  energies.push_back(energy);
+  values.push_back(intensity);
+  BuildAliasTable(values);
+}
+
+G4bool SourceSpectrum::SetPreset(const G4String &name)
+{
+  // Líneas gamma principales (intensidad por desintegración, DDEP)
+  Clear();
+  if (name == "Cs137")
+  {
+    AddLine(661.657 * keV, 0.8510);
+  }
+  else if (name == "Co60")
+  {
+    AddLine(1173.228 * keV, 0.9985);
+    AddLine(1332.492 * keV, 0.9998);
+  }
+  else if (name == "Am241")
+  {
+    AddLine(26.3446 * keV, 0.0231);
+    AddLine(59.5409 * keV, 0.3592);
+  }
+  else
+  {
+    G4cerr << "Fuente " << name << " no reconocida (Cs137, Co60, Am241)" << G4endl;
+    return false;
+  }
+  return true;
+}
+
+G4bool SourceSpectrum::ReadTable(const G4String &path, std::vector<G4double> &e,
+                                 std::vector<G4double> &v) const
+{
+  std::ifstream file(path);
+  if (!file)
+  {
+    G4cerr << "ERROR: no se puede abrir el espectro " << path << G4endl;
+    return false;
+  }
+
+  // Dos columnas: energía en keV y peso; se ignoran líneas vacías y comentarios
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream is(line);
+    G4double energy, value;
+    if (!(is >> energy >> value))
+      continue;
+    if (value < 0.)
+    {
+      G4cerr << "ERROR: peso negativo en " << path << ": " << line << G4endl;
+      return false;
+    }
+    e.push_back(energy * keV);
+    v.push_back(value);
+  }
+
+  if (e.empty())
+  {
+    G4cerr << "ERROR: " << path << " no contiene datos" << G4endl;
+    return false;
+  }
+  return true;
+}
+
+G4bool SourceSpectrum::LoadLines(const G4String &path)
+{
+  std::vector<G4double> e, v;
+  if (!ReadTable(path, e, v))
+    return false;
+
+  Clear();
+  type = Type::Lines;
+  energies = e;
+  values = v;
+  BuildAliasTable(values);
+  return true;
+}
+
+G4bool SourceSpectrum::LoadContinuous(const G4String &path)
+{
+  std::vector<G4double> e, v;
+  if (!ReadTable(path, e, v))
+    return false;
+  if (e.size() < 2 || !std::is_sorted(e.begin(), e.end()))
+  {
+    G4cerr << "ERROR: el espectro continuo necesita al menos dos energías crecientes" << G4endl;
+    return false;
+  }
+
+  Clear();
+  type = Type::Continuous;
+  energies = e;
+  values = v;
+
+  // Peso de cada tramo = área del trapecio bajo la fluencia interpolada
+  std::vector<G4double> areas(e.size() - 1);
+  for (std::size_t i = 0; i + 1 < e.size(); ++i)
+    areas[i] = 0.5 * (v[i] + v[i + 1]) * (e[i + 1] - e[i]);
+  BuildAliasTable(areas);
+  return true;
+}
+
+void SourceSpectrum::BuildAliasTable(const std::vector<G4double> &weights)
+{
+  // Método de Vose: O(n) al construir, O(1) al muestrear
+  std::size_t n = weights.size();
+  aliasProb.assign(n, 1.);
+  aliasIndex.assign(n, 0);
+  for (std::size_t i = 0; i < n; ++i)
+    aliasIndex[i] = i;
+
+  G4double total = std::accumulate(weights.begin(), weights.end(), 0.);
+  if (n == 0 || total <= 0.)
+    return;
+
+  std::vector<G4double> scaled(n);
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    scaled[i] = weights[i] * n / total;
+    (scaled[i] < 1. ? small : large).push_back(i);
+  }
+
+  while (!small.empty() && !large.empty())
+  {
+    std::size_t s = small.back();
+    small.pop_back();
+    std::size_t l = large.back();
+    aliasProb[s] = scaled[s];
+    aliasIndex[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if (scaled[l] < 1.)
+    {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Lo que queda es 1 salvo por redondeo
+  for (auto i : small)
+    aliasProb[i] = 1.;
+  for (auto i : large)
+    aliasProb[i] = 1.;
+}
+
+G4double SourceSpectrum::Sample(G4double u1, G4double u2) const
+{
+  // Un único número para columna y moneda: la parte fraccionaria es uniforme
+  std::size_t n = aliasProb.size();
+  G4double x = u1 * n;
+  std::size_t column = std::min(static_cast<std::size_t>(x), n - 1);
+  std::size_t i = (x - column < aliasProb[column]) ? column : aliasIndex[column];
+
+  if (type == Type::Lines)
+    return energies[i];
+
+  // Tramo lineal [E_i, E_i+1]: inversa exacta de la CDF del trapecio
+  G4double w0 = values[i], w1 = values[i + 1];
+  G4double t = u2;
+  if (std::abs(w1 - w0) > 1e-12 * (w0 + w1))
+    t = (-w0 + std::sqrt(w0 * w0 + (w1 * w1 - w0 * w0) * u2)) / (w1 - w0);
+  return energies[i] + t * (energies[i + 1] - energies[i]);
+}
+
+void SourceSpectrum::Print() const
+{
+  if (type == Type::Mono)
+  {
+    G4cout << "Fuente: monoenergética (/gun/energy)" << G4endl;
+    return;
+  }
+
+  if (type == Type::Lines)
+  {
+    G4double total = std::accumulate(values.begin(), values.end(), 0.);
+    G4cout << "Fuente: " << energies.size() << " líneas" << G4endl;
+    for (std::size_t i = 0; i < energies.size(); ++i)
+      G4cout << "  " << energies[i] / keV << " keV  " << values[i] / total * 100. << " %" << G4endl;
+  }
+  else
+  {
+    G4cout << "Fuente: espectro continuo de " << energies.size() << " puntos, "
+           << energies.front() / keV << " - " << energies.back() / keV << " keV" << G4endl;
+  }
+}
+
+G4String SourceSpectrum::Describe() const
+{
+  if (type == Type::Mono)
+    return "";
+
+  // Pocas líneas (presets): legibles; tablas largas: número de puntos y hash
+  std::ostringstream os;
+  G4double total = std::accumulate(values.begin(), values.end(), 0.);
+  if (type == Type::Lines && energies.size() <= 4)
+  {
+    os << "lines:";
+    for (std::size_t i = 0; i < energies.size(); ++i)
+      os << (i ? "," : "") << energies[i] / keV << "keV@" << values[i] / total;
+    return os.str();
+  }
+
+  std::ostringstream table;
+  table.precision(10);
+  for (std::size_t i = 0; i < energies.size(); ++i)
+    table << energies[i] / keV << " " << values[i] / total << "\n";
+  os << (type == Type::Lines ? "lines:" : "continuous:") << energies.size() << ":"
+     << ResultsStore::Hash(table.str());
+  return os.str();
+}
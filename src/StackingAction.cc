@@ -0,0 +1,33 @@
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
+#include "DetectorConstruction.hh"
+#include "G4Track.hh"
+#include "G4Electron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+StackingAction::StackingAction(const DetectorConstruction *det, const SteppingAction *stepping)
+    : G4UserStackingAction(), detector(det), steppingAction(stepping)
+{
+}
+
+StackingAction::~StackingAction() {}
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track *track)
+{
+  G4double rangeCut = steppingAction->GetElectronRangeCut();
+  if (!steppingAction->IsFastMode() || rangeCut <= 0.)
+    return fUrgent;
+
+  if (track->GetDefinition() != G4Electron::Electron())
+    return fUrgent;
+
+  // Los secundarios ya traen el touchable del punto donde se crearon
+  auto volume = track->GetVolume();
+  if (!volume || !detector->IsAbsorberVolume(volume->GetLogicalVolume()))
+    return fUrgent;
+
+  G4double range = emCalculator.GetRangeFromRestricteDEDX(track->GetKineticEnergy(), G4Electron::Electron(),
+                                                          track->GetMaterial());
+  return (range < rangeCut) ? fKill : fUrgent;
+}
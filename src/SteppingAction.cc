@@ -0,0 +1,137 @@
+#include "SteppingAction.hh"
+#include "FastTrackingMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "RunAction.hh"
+#include "MeshTally.hh"
+#include "LayerTally.hh"
+#include "G4Gamma.hh"
+#include "PerformanceMonitor.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include <cmath>
+#include <sstream>
+
+SteppingAction::SteppingAction(const DetectorConstruction *det, RunAction *runAct)
+    : G4UserSteppingAction(), detector(det), runAction(runAct),
+      meshTally(runAct ? runAct->GetMeshTally() : nullptr),
+      layerTally(runAct ? runAct->GetLayerTally() : nullptr), fastMode(false), killEscaping(false),
+      electronRangeCut(0.)
+{
+  messenger = new FastTrackingMessenger(this);
+}
+
+SteppingAction::~SteppingAction()
+{
+  delete messenger;
+}
+
+void SteppingAction::UserSteppingAction(const G4Step *step)
+{
+  if (runAction)
+    runAction->CountStep();
+
+  auto preVolume = step->GetPreStepPoint()->GetTouchableHandle()->GetVolume();
+  if (!preVolume)
+    return;
+  auto preLogical = preVolume->GetLogicalVolume();
+  G4bool inAbsorber = detector->IsAbsorberVolume(preLogical);
+
+  // Malla del absorbente: un índice calculado, sin volúmenes por vóxel
+  if (inAbsorber && meshTally && meshTally->IsActive())
+    meshTally->Score(step);
+
+  // Fotón que sale de una capa por su cara posterior
+  if (layerTally && layerTally->IsActive() && preLogical == detector->GetLayerVolume())
+    ScoreLayerExit(step);
+
+#ifdef GAMMAATT_INSTRUMENT
+  if (inAbsorber)
+    GAMMAATT_PERF_STEP(kAbsorber);
+  else if (preLogical == detector->GetDetectorVolume())
+    GAMMAATT_PERF_STEP(kDetector);
+  else
+    GAMMAATT_PERF_STEP(kWorld);
+  if (step->GetTrack()->GetCurrentStepNumber() == 1)
+    GAMMAATT_PERF_COUNT(tracks, 1);
+  GAMMAATT_PERF_COUNT(secondaries, step->GetNumberOfSecondariesInCurrentStep());
+#endif
+
+  if (!fastMode)
+    return;
+
+  // El SD se invoca antes que esta acción: el hit de este paso ya está
+  // registrado, así que el destino del evento está decidido
+  if (preLogical == detector->GetDetectorVolume())
+  {
+    G4RunManager::GetRunManager()->AbortEvent();
+    return;
+  }
+
+  if (killEscaping && !inAbsorber && IsEscaping(step))
+    step->GetTrack()->SetTrackStatus(fStopAndKill);
+}
+
+G4String SteppingAction::GetFastTag() const
+{
+  if (!fastMode)
+    return "";
+  std::ostringstream os;
+  os << "+FastTransmission";
+  if (killEscaping)
+    os << "+KillEscaping";
+  if (electronRangeCut > 0.)
+    os << "+ElectronRangeCut" << electronRangeCut / mm << "mm";
+  return os.str();
+}
+
+void SteppingAction::ScoreLayerExit(const G4Step *step) const
+{
+  auto postPoint = step->GetPostStepPoint();
+  if (postPoint->GetStepStatus() != fGeomBoundary || step->GetTrack()->GetDefinition() != G4Gamma::Definition())
+    return;
+
+  // Réplica o copia parametrizada: el número de copia es el índice de la capa
+  G4int layer = step->GetPreStepPoint()->GetTouchableHandle()->GetReplicaNumber();
+  if (postPoint->GetPosition().z() >= layerTally->GetBackFace(layer) - layerTally->GetTolerance())
+    layerTally->Cross(layer, step->GetPreStepPoint()->GetWeight());
+}
+
+G4bool SteppingAction::IsEscaping(const G4Step *step) const
+{
+  auto postPoint = step->GetPostStepPoint();
+  if (!postPoint->GetTouchableHandle()->GetVolume())
+    return false; // Ya sale del mundo por sí sola
+
+  const G4ThreeVector &pos = postPoint->GetPosition();
+  const G4ThreeVector &dir = postPoint->GetMomentumDirection();
+
+  G4double absorberBack = detector->GetThickness() / 2.0;
+  G4double absorberFront = -absorberBack;
+  G4double detectorZ = detector->GetDetectorPosition().z();
+  G4double detectorFront = detectorZ - DetectorConstruction::detectorHalfZ;
+  G4double detectorBack = detectorZ + DetectorConstruction::detectorHalfZ;
+
+  // Detrás del detector y alejándose
+  if (pos.z() >= detectorBack && dir.z() >= 0.)
+    return true;
+
+  // Delante del absorbente y volviendo hacia la fuente (retrodispersión)
+  if (pos.z() <= absorberFront && dir.z() <= 0.)
+    return true;
+
+  // Entre absorbente y detector, avanzando pero fuera de la sombra del detector
+  if (pos.z() >= absorberBack && pos.z() < detectorFront && dir.z() > 0.)
+  {
+    G4double path = (detectorFront - pos.z()) / dir.z();
+    G4double x = pos.x() + dir.x() * path;
+    G4double y = pos.y() + dir.y() * path;
+    return std::abs(x) > DetectorConstruction::detectorHalfXY ||
+           std::abs(y) > DetectorConstruction::detectorHalfXY;
+  }
+
+  return false;
+}
@@ -0,0 +1,86 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "SweepManager.hh"
+#include "SweepMessenger.hh"
+#include "PrecisionMonitor.hh"
+#include "ResultsStore.hh"
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Timer.hh"
+#include "G4ios.hh"
+#include <cstdio>
+
+SweepManager::SweepManager(PrecisionMonitor *precision)
+    : eventsPerPoint(100000), relativePrecision(0.), outputName("sweep"), running(false),
+      precisionMonitor(precision)
+{
+  messenger = new SweepMessenger(this);
+}
+
+SweepManager::~SweepManager()
+{
+  delete messenger;
+}
+
+void SweepManager::Run()
+{
+  if (materials.empty() || thicknesses.empty() || energies.empty())
+  {
+    G4cerr << "Barrido incompleto: define /sweep/materials, /sweep/thicknesses y /sweep/energies" << G4endl;
+    return;
+  }
+
+  auto runManager = G4RunManager::GetRunManager();
+  auto UImanager = G4UImanager::GetUIpointer();
+  G4int nPoints = materials.size() * thicknesses.size() * energies.size();
+
+  G4cout << "=== Barrido: " << materials.size() << " materiales x " << thicknesses.size()
+         << " espesores x " << energies.size() << " energías = " << nPoints << " puntos ("
+         << eventsPerPoint << " eventos/punto) ===" << G4endl;
+  G4bool adaptive = (relativePrecision > 0. && precisionMonitor);
+  if (adaptive)
+    G4cout << "Cada punto se detiene al alcanzar " << relativePrecision * 100.
+           << " % de error relativo en mu" << G4endl;
+
+  // Todos los puntos se acumulan en un único fichero ROOT nuevo
+  std::remove(("../results/" + outputName + ".root").c_str());
+
+  G4Timer timer;
+  timer.Start();
+  running = true;
+
+  G4int point = 0;
+  for (const auto &material : materials)
+  {
+    // La geometría solo cambia en los bucles externos; la energía es lo más barato
+    UImanager->ApplyCommand("/detector/setMaterial " + material);
+    for (const auto &thick : thicknesses)
+    {
+      UImanager->ApplyCommand("/detector/setThickness " + G4UIcommand::ConvertToString(thick / cm) + " cm");
+      for (const auto &energy : energies)
+      {
+        UImanager->ApplyCommand("/gun/energy " + G4UIcommand::ConvertToString(energy / keV) + " keV");
+
+        ++point;
+        G4cout << "--- Punto " << point << "/" << nPoints << ": " << material << ", "
+               << thick / cm << " cm, " << energy / keV << " keV ---" << G4endl;
+        if (adaptive)
+          precisionMonitor->BeamToPrecision(relativePrecision, eventsPerPoint);
+        else
+          runManager->BeamOn(eventsPerPoint);
+      }
+    }
+  }
+
+  running = false;
+  timer.Stop();
+
+  G4cout << "=== Barrido completado en " << timer.GetRealElapsed() << " s ("
+         << timer.GetRealElapsed() / nPoints << " s/punto) ===" << G4endl;
+  G4cout << "Resultados: ../results/" << outputName << ".root y " << ResultsStore::DefaultPath() << G4endl;
+}
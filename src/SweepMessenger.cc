@@ -0,0 +1,138 @@
+#include "SweepMessenger.hh"
+#include "SweepManager.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4SystemOfUnits.hh"
+#include <sstream>
+#include <cstdlib>
+
+SweepMessenger::SweepMessenger(SweepManager *sweep)
+    : G4UImessenger(), sweepManager(sweep)
+{
+    // Crear directorio de comandos
+    sweepDir = new G4UIdirectory("/sweep/");
+    sweepDir->SetGuidance("Barrido material x espesor x energía en un solo proceso");
+
+    materialsCmd = new G4UIcmdWithAString("/sweep/materials", this);
+    materialsCmd->SetGuidance("Lista de materiales separados por espacios");
+    materialsCmd->SetGuidance("Ej: /sweep/materials water muscle bone");
+    materialsCmd->SetParameterName("materials", false);
+    materialsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    thicknessesCmd = new G4UIcmdWithAString("/sweep/thicknesses", this);
+    thicknessesCmd->SetGuidance("Lista de espesores con unidad opcional al final (por defecto cm)");
+    thicknessesCmd->SetGuidance("Ej: /sweep/thicknesses 0.5 1 2 3 5 7.5 10 15 cm");
+    thicknessesCmd->SetParameterName("thicknesses", false);
+    thicknessesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    energiesCmd = new G4UIcmdWithAString("/sweep/energies", this);
+    energiesCmd->SetGuidance("Lista de energías del fotón con unidad opcional al final (por defecto keV)");
+    energiesCmd->SetGuidance("Ej: /sweep/energies 59.5 662 1173 1332 keV");
+    energiesCmd->SetParameterName("energies", false);
+    energiesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    eventsCmd = new G4UIcmdWithAnInteger("/sweep/events", this);
+    eventsCmd->SetGuidance("Eventos por punto del barrido");
+    eventsCmd->SetParameterName("events", false);
+    eventsCmd->SetRange("events > 0");
+    eventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    precisionCmd = new G4UIcmdWithADouble("/sweep/precision", this);
+    precisionCmd->SetGuidance("Error relativo objetivo de mu por punto (0 = número fijo de eventos)");
+    precisionCmd->SetGuidance("Con un valor > 0, /sweep/events pasa a ser el máximo por punto");
+    precisionCmd->SetParameterName("relError", false);
+    precisionCmd->SetRange("relError >= 0. && relError < 1.");
+    precisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    outputCmd = new G4UIcmdWithAString("/sweep/output", this);
+    outputCmd->SetGuidance("Nombre del fichero ROOT común (../results/<nombre>.root)");
+    outputCmd->SetParameterName("name", false);
+    outputCmd->SetDefaultValue("sweep");
+    outputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    runCmd = new G4UIcmdWithoutParameter("/sweep/run", this);
+    runCmd->SetGuidance("Ejecuta todos los puntos de la malla");
+    runCmd->AvailableForStates(G4State_Idle);
+}
+
+SweepMessenger::~SweepMessenger()
+{
+    delete materialsCmd;
+    delete thicknessesCmd;
+    delete energiesCmd;
+    delete eventsCmd;
+    delete precisionCmd;
+    delete outputCmd;
+    delete runCmd;
+    delete sweepDir;
+}
+
+std::vector<G4double> SweepMessenger::ParseValuesWithUnit(const G4String &list, const char *defaultUnit) const
+{
+    std::vector<G4double> values;
+    std::vector<G4String> tokens;
+    std::istringstream is(list);
+    G4String token;
+    while (is >> token)
+        tokens.push_back(token);
+
+    // Si el último elemento no es un número se interpreta como la unidad
+    G4double unit = G4UIcommand::ValueOf(defaultUnit);
+    G4bool lastIsNumber = false;
+    if (!tokens.empty())
+    {
+        char *end = nullptr;
+        std::strtod(tokens.back().c_str(), &end);
+        lastIsNumber = (*end == '\0');
+    }
+    if (!tokens.empty() && !lastIsNumber)
+    {
+        unit = G4UIcommand::ValueOf(tokens.back());
+        tokens.pop_back();
+    }
+
+    for (const auto &t : tokens)
+        values.push_back(G4UIcommand::ConvertToDouble(t) * unit);
+    return values;
+}
+
+void SweepMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+    if (command == materialsCmd)
+    {
+        std::vector<G4String> materials;
+        std::istringstream is(newValue);
+        G4String material;
+        while (is >> material)
+            materials.push_back(material);
+        sweepManager->SetMaterials(materials);
+    }
+    else if (command == thicknessesCmd)
+    {
+        sweepManager->SetThicknesses(ParseValuesWithUnit(newValue, "cm"));
+    }
+    else if (command == energiesCmd)
+    {
+        sweepManager->SetEnergies(ParseValuesWithUnit(newValue, "keV"));
+    }
+    else if (command == eventsCmd)
+    {
+        sweepManager->SetEventsPerPoint(eventsCmd->GetNewIntValue(newValue));
+    }
+    else if (command == precisionCmd)
+    {
+        sweepManager->SetRelativePrecision(precisionCmd->GetNewDoubleValue(newValue));
+    }
+    else if (command == outputCmd)
+    {
+        sweepManager->SetOutputName(newValue);
+    }
+    else if (command == runCmd)
+    {
+        sweepManager->Run();
+    }
+}
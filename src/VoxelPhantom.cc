@@ -0,0 +1,145 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+*/
+#include "VoxelPhantom.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+VoxelPhantom::VoxelPhantom()
+    : nx(0), ny(0), nz(0), type(kHounsfield), mapping(nullptr), mappingSize(0), data(nullptr),
+      huTable(65536, 0), indexMaterials{"G4_AIR", "water", "muscle", "bone", "lead", "concrete"}
+{
+  ResetHURanges();
+}
+
+VoxelPhantom::~VoxelPhantom()
+{
+  Close();
+}
+
+G4bool VoxelPhantom::Open(const G4String &file, G4int x, G4int y, G4int z, const G4ThreeVector &size,
+                          DataType dataType, std::size_t headerBytes)
+{
+  std::size_t bytesPerVoxel = (dataType == kHounsfield) ? sizeof(std::int16_t) : sizeof(std::uint8_t);
+  std::size_t needed = headerBytes + static_cast<std::size_t>(x) * y * z * bytesPerVoxel;
+
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    G4cerr << "Maniquí: no se puede abrir " << file << ": " << std::strerror(errno) << G4endl;
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < needed)
+  {
+    G4cerr << "Maniquí: " << file << " tiene " << info.st_size << " bytes; se esperaban al menos " << needed
+           << " (" << x << "x" << y << "x" << z << ")" << G4endl;
+    close(fd);
+    return false;
+  }
+
+  // Solo lectura y privado: las páginas se cargan bajo demanda y se pueden
+  // descartar sin escribirlas; la proyección sobrevive al cierre del descriptor
+  void *address = mmap(nullptr, needed, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    G4cerr << "Maniquí: mmap de " << file << " falló: " << std::strerror(errno) << G4endl;
+    return false;
+  }
+  // Las trayectorias avanzan en z (un plano completo entre vóxeles consecutivos):
+  // la lectura anticipada cargaría páginas que nadie va a tocar
+  madvise(address, needed, MADV_RANDOM);
+
+  Close(); // El fichero anterior solo se suelta si el nuevo se ha podido proyectar
+  path = file;
+  nx = x;
+  ny = y;
+  nz = z;
+  voxelSize = size;
+  type = dataType;
+  mapping = address;
+  mappingSize = needed;
+  data = static_cast<const std::uint8_t *>(address) + headerBytes;
+  G4cout << "Maniquí " << file << ": " << nx << "x" << ny << "x" << nz << " vóxeles de " << voxelSize.x() << "x"
+         << voxelSize.y() << "x" << voxelSize.z() << " mm (" << needed / (1024. * 1024.) << " MB proyectados)" << G4endl;
+  return true;
+}
+
+void VoxelPhantom::Close()
+{
+  if (mapping)
+    munmap(mapping, mappingSize);
+  mapping = nullptr;
+  mappingSize = 0;
+  data = nullptr;
+}
+
+G4int VoxelPhantom::SlotOf(const G4String &material)
+{
+  auto it = std::find(huMaterials.begin(), huMaterials.end(), material);
+  if (it != huMaterials.end())
+    return static_cast<G4int>(it - huMaterials.begin());
+  huMaterials.push_back(material);
+  return static_cast<G4int>(huMaterials.size()) - 1;
+}
+
+void VoxelPhantom::AddHURange(G4int low, G4int high, const G4String &material)
+{
+  low = std::max(low, static_cast<G4int>(std::numeric_limits<std::int16_t>::min()));
+  high = std::min(high, static_cast<G4int>(std::numeric_limits<std::int16_t>::max()) + 1);
+  if (low >= high)
+    return;
+  if (huMaterials.size() >= 255 && std::find(huMaterials.begin(), huMaterials.end(), material) == huMaterials.end())
+  {
+    G4cerr << "Maniquí: demasiados materiales distintos; se ignora " << material << G4endl;
+    return;
+  }
+
+  std::uint8_t slot = static_cast<std::uint8_t>(SlotOf(material));
+  for (G4int hu = low; hu < high; ++hu)
+    huTable[static_cast<std::uint16_t>(static_cast<std::int16_t>(hu))] = slot;
+}
+
+/* Rangos por defecto sobre los materiales del absorbente: aire fuera del
+   cuerpo y en pulmón, agua para grasa y tejido blando, músculo, hueso y
+   plomo para los implantes metálicos (saturan la escala del CT) */
+void VoxelPhantom::ResetHURanges()
+{
+  huMaterials.clear();
+  AddHURange(-32768, -400, "G4_AIR");
+  AddHURange(-400, 20, "water");
+  AddHURange(20, 200, "muscle");
+  AddHURange(200, 3000, "bone");
+  AddHURange(3000, 32768, "lead");
+}
+
+void VoxelPhantom::SetIndexMaterials(const std::vector<G4String> &names)
+{
+  if (!names.empty())
+    indexMaterials = names;
+}
+
+PhantomParameterisation::PhantomParameterisation(const VoxelPhantom *ph, const std::vector<G4Material *> &materials)
+    : G4PhantomParameterisation(), phantom(ph), slotMaterials(materials)
+{
+  G4ThreeVector voxel = phantom->GetVoxelSize();
+  SetVoxelDimensions(voxel.x() / 2., voxel.y() / 2., voxel.z() / 2.);
+  SetNoVoxels(phantom->GetNx(), phantom->GetNy(), phantom->GetNz());
+  SetMaterials(slotMaterials);
+  SetSkipEqualMaterials(true); // G4RegularNavigation cruza de una vez los vóxeles iguales
+}
+
+G4Material *PhantomParameterisation::ComputeMaterial(const G4int copyNo, G4VPhysicalVolume *, const G4VTouchable *)
+{
+  return slotMaterials[phantom->MaterialSlot(static_cast<std::size_t>(copyNo))];
+}
@@ -1,73 +1,168 @@
 // ------ Simulación de atenuación gamma ------
-// Función principal 
+// Función principal
+//
+// Uso: gammaAtt [macro.mac] [-t N] [--mt] [--bias] [--fastsim] [--physics lista] [--shard i/N]
+//      gammaAtt_batch macro.mac [-t N] [--mt] [--bias] [--fastsim] [--physics lista] [--shard i/N]
+//      (gammaAtt_batch: sin UI ni visualización)
+//   -t N        ejecuta el bucle de eventos con N hilos (0 = secuencial)
+//   --mt        usa G4MTRunManager en lugar de G4TaskRunManager
+//   --bias      activa el biasing genérico de fotones en el absorbente (/bias/...)
+//   --fastsim   modelo rápido del absorbente: muestrea el destino de cada fotón
+//               en lugar de transportarlo (/fastsim/enable false lo desactiva)
+//   --physics   física EM (/phys/select): standard, opt1, opt3, opt4, livermore,
+//               penelope, lowEP o photon
+//   --shard i/N simula solo el fragmento i (0..N-1) de cada run y guarda sus
+//               sumas en results/shards/ para gammaAtt-merge
 
 #include "G4RunManager.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#include "G4TaskRunManager.hh"
+#endif
 #include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#ifdef GAMMAATT_WITH_VIS
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
+#endif
 
 // --- Clases utilizadas ---
 #include "DetectorConstruction.hh"
 #include "PhysicsList.hh"
-#include "PrimaryGeneratorAction.hh"
+#include "ActionInitialization.hh"
 #include "RunAction.hh"
-#include "EventAction.hh"
+#include "Sharding.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 int main(int argc,char** argv) {
-  
+
+  // Argumentos: macro opcional y número de hilos
+  G4String macroFile = "";
+  G4int nThreads = 0;
+  G4bool useMTRunManager = false;
+  G4bool useBiasing = false;
+  G4bool useFastSim = false;
+  G4String emPhysics = "standard";
+  for (G4int i = 1; i < argc; ++i) {
+    if ((std::strcmp(argv[i], "-t") == 0 || std::strcmp(argv[i], "--threads") == 0) && i + 1 < argc) {
+      nThreads = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--mt") == 0) {
+      useMTRunManager = true;
+    } else if (std::strcmp(argv[i], "--bias") == 0) {
+      useBiasing = true;
+    } else if (std::strcmp(argv[i], "--fastsim") == 0) {
+      useFastSim = true;
+    } else if (std::strcmp(argv[i], "--physics") == 0 && i + 1 < argc) {
+      emPhysics = argv[++i];
+      const auto& names = PhysicsList::GetEMNames();
+      if (std::find(names.begin(), names.end(), emPhysics) == names.end()) {
+        G4cerr << "--physics: lista desconocida " << emPhysics << G4endl;
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+      if (!Sharding::Configure(argv[++i])) {
+        G4cerr << "--shard espera i/N con 0 <= i < N (p. ej. --shard 3/8): " << argv[i] << G4endl;
+        return 1;
+      }
+    } else {
+      macroFile = argv[i];
+    }
+  }
+
   // Gestión de la ejecución
+  G4bool interactive = macroFile.empty();
+#ifdef GAMMAATT_WITH_VIS
   G4UIExecutive* ui = nullptr;
-  if (argc == 1) {
+  if (interactive) {
     ui = new G4UIExecutive(argc, argv);
   }
+#else
+  if (interactive) {
+    G4cerr << "gammaAtt_batch no tiene sesión interactiva: indica una macro" << G4endl;
+    return 1;
+  }
+#endif
 
-  // --- Gestión del núcleo de Geant4 --- 
-  G4RunManager* runManager = new G4RunManager();
+  // --- Gestión del núcleo de Geant4 ---
+  G4RunManager* runManager = nullptr;
+#ifdef G4MULTITHREADED
+  if (nThreads > 0) {
+    if (useMTRunManager) {
+      auto mtRunManager = new ShardedRunManager<G4MTRunManager>();
+      mtRunManager->SetNumberOfThreads(nThreads);
+      runManager = mtRunManager;
+    } else {
+      auto taskRunManager = new ShardedRunManager<G4TaskRunManager>();
+      taskRunManager->SetNumberOfThreads(nThreads);
+      runManager = taskRunManager;
+    }
+    G4cout << "Modo multihilo: " << nThreads << " hilos" << G4endl;
+  }
+#else
+  if (nThreads > 0) {
+    G4cerr << "Geant4 compilado sin soporte multihilo: se ignora -t " << nThreads << G4endl;
+  }
+#endif
+  if (!runManager) {
+    runManager = new ShardedRunManager<G4RunManager>();
+  }
 
   // Definición del detector
   DetectorConstruction* detector = new DetectorConstruction();
+  detector->SetStoreHits(interactive); // Hits individuales solo para la sesión visual
+  detector->SetBiasing(useBiasing);
+  detector->SetFastSimulation(useFastSim);
   runManager->SetUserInitialization(detector);
 
   // Definición de la lista de física
   PhysicsList* physics = new PhysicsList();
+  physics->SelectEM(emPhysics);
+  if (useBiasing) {
+    physics->EnableBiasing();
+  }
+  if (useFastSim) {
+    physics->EnableFastSimulation();
+  }
   runManager->SetUserInitialization(physics);
 
-  // Definición de la acción primaria
-  PrimaryGeneratorAction* primaryGen = new PrimaryGeneratorAction();
-  runManager->SetUserAction(primaryGen);
-
-  // Definición de las acciones de usuario
-  RunAction* runAction = new RunAction(detector);
-  runManager->SetUserAction(runAction);
-  
-  EventAction* eventAction = new EventAction(runAction);
-  runManager->SetUserAction(eventAction);
+  // Definición de las acciones de usuario (generador, run y evento por hilo)
+  runManager->SetUserInitialization(new ActionInitialization(detector));
 
   // Inicialización del núcleo de Geant4
   runManager->Initialize();
 
-  // Inicialización de la visualización
-  G4VisManager* visManager = new G4VisExecutive();
-  visManager->Initialize();
-
   // Obtener el gestor de interfaz de usuario
-  G4UImanager* UImanager = G4UImanager::GetUIpointer();  
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  G4int macroStatus = fCommandSucceeded;
 
+#ifdef GAMMAATT_WITH_VIS
   if (ui) {
+    // La visualización solo se crea cuando hay una sesión que la muestre
+    G4VisManager* visManager = new G4VisExecutive();
+    visManager->Initialize();
+
     UImanager->ApplyCommand("/control/execute ../mac/init.mac");
     ui->SessionStart();
     delete ui;
-  } else {
+    delete visManager;
+  } else
+#endif
+  {
     // Modo batch:
-    G4String command = "/control/execute ";;
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
-  
+    G4String command = "/control/execute ";
+    macroStatus = UImanager->ApplyCommand(command + macroFile);
+    if (macroStatus != fCommandSucceeded) {
+      G4cerr << "ERROR: la macro " << macroFile << " se interrumpió (código " << macroStatus << ")" << G4endl;
+    }
   }
 
   // Liberar memoria
-  delete visManager;
   delete runManager;
 
-  return 0;
-}
\ No newline at end of file
+  // Código distinto de 0 si la macro falló o algún resultado no se guardó
+  // (gammaAtt-sweep solo da un punto por hecho con 0)
+  return (macroStatus != fCommandSucceeded || RunAction::OutputsFailed()) ? 1 : 0;
+}
@@ -0,0 +1,679 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Motor de análisis de los barridos (sustituye a las macros por material).
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Uso: gammaAtt-analyze [dir_resultados] [--store fichero]... [--out dir]
+                      [--bootstrap B] [--seed S] [-j N] [--quiet]
+
+Lee <dir_resultados>/store.tsv (por defecto ../results, o GAMMAATT_STORE) y
+los almacenes extra indicados con --store, agrupa los runs por (material,
+espectro, lista de física) y para cada grupo:
+  - junta los runs con el mismo espesor (semillas distintas),
+  - ajusta ln T = a - mu x por mínimos cuadrados ponderados, con el error
+    binomial sigma(ln T) = sqrt((1-T)/(n T)) o, con biasing, el error
+    relativo de mu que guardó el run,
+  - estima el intervalo de confianza del 95 % de mu con bootstrap
+    paramétrico (B réplicas, semilla fija por grupo: reproducible).
+Los grupos se reparten entre -j hilos.
+
+Escribe en <out> (por defecto el propio dir_resultados):
+  analysis/groups.csv                       un ajuste por grupo (total y haz estrecho)
+  multi_thickness/thickness[_mat]_analysis_data.csv, fit[_mat]_results.txt
+                                            grupos a 662 keV, formato de los
+                                            scripts plot_multi_thickness*.py
+  multi_material/material_comparison.csv    un material por fila, 662 keV
+  multi_energy/energy_mc[_mat].csv          mu/rho Monte Carlo frente a energía
+*/
+#include "ResultsStore.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  // Materiales con nombre corto conocido por los scripts de Python
+  struct KnownMaterial
+  {
+    const char *g4Name;
+    const char *label;
+    const char *shortName; // sufijo de los ficheros (ninguno para el agua)
+    const char *description;
+  };
+
+  const KnownMaterial kKnown[] = {
+      {"G4_WATER", "water", "water", "Agua (H2O)"},
+      {"G4_MUSCLE_SKELETAL_ICRP", "muscle", "muscle", "Músculo esquelético"},
+      {"G4_BONE_COMPACT_ICRU", "bone", "bone", "Hueso compacto"},
+  };
+
+  // Un espesor del grupo (runs con el mismo espesor ya combinados)
+  struct Point
+  {
+    double x = 0.;        // cm
+    long long n = 0;      // eventos
+    long long k = 0;      // transmitidos
+    double t = 0.;        // transmisión
+    double sigmaT = 0.;   // error de T
+    bool weighted = false; // runs con biasing: T no es k/n
+    int runs = 0;
+
+    // Haz estrecho (solo fotones sin colisión); falta en runs anteriores a la clasificación
+    bool narrow = true;
+    double tu = 0.;
+    double sigmaTu = 0.;
+  };
+
+  struct Fit
+  {
+    bool ok = false;
+    double mu = 0., muErr = 0.;
+    double intercept = 0.;
+    double chi2 = 0.;
+    int ndf = 0;
+    double r2 = 0.;
+  };
+
+  struct Group
+  {
+    std::string material;
+    std::string label;
+    std::string spectrum;
+    std::string physics;
+    double density = 0.;
+    double energy = 0.; // keV, energía media de los runs
+    std::vector<const ResultsStore::Record *> records;
+    std::vector<Point> points;
+
+    Fit fit;
+    double ciLow = 0., ciHigh = 0.;
+    int replicas = 0;
+    Fit narrowFit; // Ajuste con la transmisión sin colisión
+  };
+
+  const KnownMaterial *FindKnown(const Group &g)
+  {
+    for (const auto &known : kKnown)
+      if (g.material == known.g4Name || g.label == known.label || g.label == known.g4Name)
+        return &known;
+    return nullptr;
+  }
+
+  std::string ShortName(const Group &g)
+  {
+    if (const KnownMaterial *known = FindKnown(g))
+      return known->shortName;
+    std::string name = g.label.empty() ? g.material : g.label;
+    if (name.compare(0, 3, "G4_") == 0)
+      name = name.substr(3);
+    for (auto &c : name)
+      c = std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(c)) : '_';
+    return name;
+  }
+
+  bool IsWeighted(const ResultsStore::Record &r)
+  {
+    if (r.events <= 0)
+      return false;
+    double analog = static_cast<double>(r.transmitted) / r.events;
+    return std::abs(r.transmission - analog) > 1e-9 * std::max(1., analog);
+  }
+
+  // Error de ln T de un punto: binomial en analógico, el del run con biasing
+  double SigmaLn(const Point &p)
+  {
+    if (p.t <= 0. || p.t >= 1.)
+      return 0.;
+    return p.sigmaT / p.t;
+  }
+
+  void BuildPoints(Group &g)
+  {
+    std::map<long long, std::vector<const ResultsStore::Record *>> byThickness;
+    for (const auto *r : g.records)
+      byThickness[std::llround(r->thickness * 1e6)].push_back(r);
+
+    for (const auto &entry : byThickness)
+    {
+      Point p;
+      p.x = entry.second.front()->thickness;
+      p.runs = static_cast<int>(entry.second.size());
+      double sumW = 0., sumWT = 0.;
+      double sumWu = 0., sumWTu = 0.;
+      long long ku = 0;
+      for (const auto *r : entry.second)
+      {
+        p.n += r->events;
+        p.k += r->transmitted;
+        if (r->uncollided < 0)
+          p.narrow = false;
+        else if (IsWeighted(*r))
+        {
+          // Con biasing la transmisión sin colisión sale de mu de haz estrecho
+          double tu = std::exp(-r->muNarrow * r->thickness);
+          double sigma = r->narrowRelError > 0. ? r->narrowRelError * r->muNarrow * r->thickness * tu : 0.;
+          double w = sigma > 0. ? 1. / (sigma * sigma) : 0.;
+          sumWu += w;
+          sumWTu += w * tu;
+        }
+        else
+          ku += r->uncollided;
+        if (IsWeighted(*r))
+        {
+          p.weighted = true;
+          // relError es el error relativo de mu, es decir sigma(ln T)/|ln T|
+          double sigma = (r->relError > 0. && r->transmission > 0.)
+                             ? r->relError * std::abs(std::log(r->transmission)) * r->transmission
+                             : 0.;
+          double w = sigma > 0. ? 1. / (sigma * sigma) : 0.;
+          sumW += w;
+          sumWT += w * r->transmission;
+        }
+      }
+      if (p.weighted)
+      {
+        // Media de varianza mínima de los runs con biasing
+        p.t = sumW > 0. ? sumWT / sumW : 0.;
+        p.sigmaT = sumW > 0. ? 1. / std::sqrt(sumW) : 0.;
+      }
+      else if (p.n > 0)
+      {
+        p.t = static_cast<double>(p.k) / p.n;
+        p.sigmaT = std::sqrt(p.t * (1. - p.t) / p.n);
+      }
+      if (p.narrow && p.weighted)
+      {
+        p.tu = sumWu > 0. ? sumWTu / sumWu : 0.;
+        p.sigmaTu = sumWu > 0. ? 1. / std::sqrt(sumWu) : 0.;
+      }
+      else if (p.narrow && p.n > 0)
+      {
+        p.tu = static_cast<double>(ku) / p.n;
+        p.sigmaTu = std::sqrt(p.tu * (1. - p.tu) / p.n);
+      }
+      g.points.push_back(p);
+    }
+  }
+
+  // Mínimos cuadrados ponderados de y = a - mu x. Con un único espesor se
+  // fuerza a = 0 (T(0) = 1), que es lo que da -ln T / x.
+  Fit WeightedFit(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &sigma)
+  {
+    Fit fit;
+    double s = 0., sx = 0., sy = 0., sxx = 0., sxy = 0.;
+    int used = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      if (!(sigma[i] > 0.) || !std::isfinite(y[i]))
+        continue;
+      double w = 1. / (sigma[i] * sigma[i]);
+      s += w;
+      sx += w * x[i];
+      sy += w * y[i];
+      sxx += w * x[i] * x[i];
+      sxy += w * x[i] * y[i];
+      ++used;
+    }
+    if (used == 0)
+      return fit;
+
+    double slope, slopeVar;
+    if (used == 1)
+    {
+      slope = sxy / sxx;
+      slopeVar = 1. / sxx;
+      fit.intercept = 0.;
+    }
+    else
+    {
+      double delta = s * sxx - sx * sx;
+      if (delta <= 0.)
+        return fit;
+      slope = (s * sxy - sx * sy) / delta;
+      slopeVar = s / delta;
+      fit.intercept = (sxx * sy - sx * sxy) / delta;
+    }
+    fit.mu = -slope;
+    fit.muErr = std::sqrt(slopeVar);
+    fit.ndf = used - (used == 1 ? 1 : 2);
+
+    double ymean = sy / s, ssTot = 0., ssRes = 0.;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      if (!(sigma[i] > 0.) || !std::isfinite(y[i]))
+        continue;
+      double w = 1. / (sigma[i] * sigma[i]);
+      double r = y[i] - (fit.intercept + slope * x[i]);
+      fit.chi2 += w * r * r;
+      ssRes += w * r * r;
+      ssTot += w * (y[i] - ymean) * (y[i] - ymean);
+    }
+    fit.r2 = ssTot > 0. ? 1. - ssRes / ssTot : 1.;
+    fit.ok = true;
+    return fit;
+  }
+
+  void Analyze(Group &g, int replicas, unsigned long long seed)
+  {
+    BuildPoints(g);
+
+    std::vector<double> x, y, sigma;
+    for (const auto &p : g.points)
+    {
+      x.push_back(p.x);
+      y.push_back(p.t > 0. ? std::log(p.t) : NAN);
+      sigma.push_back(SigmaLn(p));
+    }
+    g.fit = WeightedFit(x, y, sigma);
+
+    // Haz estrecho con los puntos que tienen la clasificación sin colisión
+    std::vector<double> xu, yu, sigmaU;
+    for (const auto &p : g.points)
+    {
+      if (!p.narrow || p.tu <= 0. || p.tu >= 1.)
+        continue;
+      xu.push_back(p.x);
+      yu.push_back(std::log(p.tu));
+      sigmaU.push_back(p.sigmaTu / p.tu);
+    }
+    g.narrowFit = WeightedFit(xu, yu, sigmaU);
+
+    if (!g.fit.ok || replicas <= 0)
+      return;
+
+    // Bootstrap paramétrico: cada punto se vuelve a muestrear de su propia
+    // distribución (binomial en analógico, normal en ln T con biasing). La
+    // semilla depende solo del grupo, así que el resultado no depende del
+    // reparto entre hilos.
+    std::mt19937_64 rng(seed ^ std::strtoull(ResultsStore::Hash(g.material + g.spectrum + g.physics).c_str(), nullptr, 16));
+    std::normal_distribution<double> gauss(0., 1.);
+    std::vector<double> mus, ys(x.size()), sigmas(x.size());
+    mus.reserve(replicas);
+    for (int b = 0; b < replicas; ++b)
+    {
+      for (std::size_t i = 0; i < g.points.size(); ++i)
+      {
+        const Point &p = g.points[i];
+        if (p.weighted || p.n <= 0)
+        {
+          ys[i] = y[i] + sigma[i] * gauss(rng);
+          sigmas[i] = sigma[i];
+          continue;
+        }
+        std::binomial_distribution<long long> binomial(p.n, p.t);
+        long long k = binomial(rng);
+        double t = static_cast<double>(k) / p.n;
+        ys[i] = t > 0. ? std::log(t) : NAN;
+        sigmas[i] = (t > 0. && t < 1.) ? std::sqrt((1. - t) / (p.n * t)) : 0.;
+      }
+      Fit fit = WeightedFit(x, ys, sigmas);
+      if (fit.ok)
+        mus.push_back(fit.mu);
+    }
+    if (mus.size() < 2)
+      return;
+    std::sort(mus.begin(), mus.end());
+    auto quantile = [&mus](double q)
+    {
+      double pos = q * (mus.size() - 1);
+      std::size_t lo = static_cast<std::size_t>(pos);
+      std::size_t hi = std::min(lo + 1, mus.size() - 1);
+      return mus[lo] + (pos - lo) * (mus[hi] - mus[lo]);
+    };
+    g.ciLow = quantile(0.025);
+    g.ciHigh = quantile(0.975);
+    g.replicas = static_cast<int>(mus.size());
+  }
+
+  bool MakeDirs(const std::string &path)
+  {
+    std::string partial;
+    for (std::size_t i = 0; i <= path.size(); ++i)
+    {
+      if (i == path.size() || path[i] == '/')
+      {
+        if (!partial.empty() && mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST)
+          return false;
+      }
+      if (i < path.size())
+        partial += path[i];
+    }
+    return true;
+  }
+
+  bool Is662(const Group &g)
+  {
+    return g.spectrum.compare(0, 5, "mono:") == 0 && std::abs(g.energy - 662.) < 0.005 * 662.;
+  }
+
+  long long TotalEvents(const Group &g)
+  {
+    long long n = 0;
+    for (const auto &p : g.points)
+      n += p.n;
+    return n;
+  }
+
+  // Para cada material, el grupo a 662 keV con más espesores (y más eventos)
+  std::map<std::string, const Group *> Pick662(const std::vector<Group> &groups)
+  {
+    std::map<std::string, const Group *> best;
+    for (const auto &g : groups)
+    {
+      if (!g.fit.ok || !Is662(g))
+        continue;
+      const Group *&current = best[ShortName(g)];
+      if (!current || g.points.size() > current->points.size() ||
+          (g.points.size() == current->points.size() && TotalEvents(g) > TotalEvents(*current)))
+        current = &g;
+    }
+    return best;
+  }
+
+  void WriteGroups(const std::string &out, const std::vector<Group> &groups)
+  {
+    std::string path = out + "/analysis/groups.csv";
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+      return;
+    std::fprintf(file, "Material,Label,Density_gcm3,Spectrum,Physics,Energy_keV,Points,Runs,Events,"
+                       "Mu_cm1,Mu_err_cm1,CI95_low,CI95_high,MuRho_cm2g,Intercept,Chi2,Ndf,R2,"
+                       "Mu_narrow_cm1,Mu_narrow_err_cm1\n");
+    for (const auto &g : groups)
+    {
+      int runs = 0;
+      for (const auto &p : g.points)
+        runs += p.runs;
+      std::fprintf(file, "%s,%s,%.4f,%s,\"%s\",%.3f,%zu,%d,%lld,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.4f,%d,%.6f,",
+                   g.material.c_str(), g.label.c_str(), g.density, g.spectrum.c_str(), g.physics.c_str(),
+                   g.energy, g.points.size(), runs, TotalEvents(g), g.fit.mu, g.fit.muErr, g.ciLow, g.ciHigh,
+                   g.density > 0. ? g.fit.mu / g.density : 0., g.fit.intercept, g.fit.chi2, g.fit.ndf, g.fit.r2);
+      if (g.narrowFit.ok)
+        std::fprintf(file, "%.6f,%.6f\n", g.narrowFit.mu, g.narrowFit.muErr);
+      else
+        std::fprintf(file, ",\n");
+    }
+    std::fclose(file);
+  }
+
+  void WriteThickness(const std::string &out, const std::map<std::string, const Group *> &picked)
+  {
+    for (const auto &entry : picked)
+    {
+      const Group &g = *entry.second;
+      if (g.points.size() < 2)
+        continue;
+      std::string suffix = entry.first == "water" ? "" : "_" + entry.first;
+
+      std::string dataPath = out + "/multi_thickness/thickness" + suffix + "_analysis_data.csv";
+      FILE *csv = std::fopen(dataPath.c_str(), "w");
+      if (!csv)
+        continue;
+      // Error es sigma(T): los scripts lo usan tal cual y dividido por T para ln T
+      // Uncollided_Transmission y Buildup quedan vacíos en runs sin clasificación
+      std::fprintf(csv, "Thickness_cm,Transmission,Ln_Transmission,Error,Uncollided_Transmission,Buildup\n");
+      for (const auto &p : g.points)
+      {
+        std::fprintf(csv, "%.1f,%.6f,%.6f,%.6f,", p.x, p.t, p.t > 0. ? std::log(p.t) : 0., p.sigmaT);
+        if (p.narrow && p.tu > 0.)
+          std::fprintf(csv, "%.6f,%.4f\n", p.tu, p.t / p.tu);
+        else
+          std::fprintf(csv, ",\n");
+      }
+      std::fclose(csv);
+
+      std::string fitPath = out + "/multi_thickness/fit" + suffix + "_results.txt";
+      FILE *txt = std::fopen(fitPath.c_str(), "w");
+      if (!txt)
+        continue;
+      const KnownMaterial *known = FindKnown(g);
+      std::fprintf(txt, "Multi-Thickness Analysis Results\n");
+      std::fprintf(txt, "==============================\n");
+      std::fprintf(txt, "Material: %s (%s)\n", known ? known->description : g.material.c_str(), g.material.c_str());
+      std::fprintf(txt, "Energy: %.0f keV (%s)\n", g.energy, g.spectrum.c_str());
+      std::fprintf(txt, "Thickness range: %.1f - %.1f cm (%zu points)\n", g.points.front().x, g.points.back().x,
+                   g.points.size());
+      std::fprintf(txt, "\nBeer-Lambert Fit Results (weighted, binomial errors):\n");
+      std::fprintf(txt, "μ = %.4f +/- %.4f cm⁻¹\n", g.fit.mu, g.fit.muErr);
+      if (g.replicas > 0)
+        std::fprintf(txt, "95%% CI (bootstrap, %d replicas): [%.4f, %.4f] cm⁻¹\n", g.replicas, g.ciLow, g.ciHigh);
+      std::fprintf(txt, "Ln(I0) = %.4f\n", g.fit.intercept);
+      std::fprintf(txt, "χ²/ndf = %.3f\n", g.fit.ndf > 0 ? g.fit.chi2 / g.fit.ndf : 0.);
+      std::fprintf(txt, "R² = %.4f\n", g.fit.r2);
+      if (g.narrowFit.ok)
+        std::fprintf(txt, "Narrow-beam (uncollided) mu: %.4f +/- %.4f cm⁻¹\n", g.narrowFit.mu, g.narrowFit.muErr);
+      if (g.density > 0.)
+        std::fprintf(txt, "μ/ρ = %.5f cm²/g\n", g.fit.mu / g.density);
+      std::fprintf(txt, "\nHalf-value layer: %.2f cm\n", std::log(2.) / g.fit.mu);
+      std::fprintf(txt, "Tenth-value layer: %.2f cm\n", std::log(10.) / g.fit.mu);
+      std::fclose(txt);
+    }
+  }
+
+  void WriteMaterials(const std::string &out, const std::map<std::string, const Group *> &picked)
+  {
+    if (picked.empty())
+      return;
+    std::string path = out + "/multi_material/material_comparison.csv";
+    FILE *csv = std::fopen(path.c_str(), "w");
+    if (!csv)
+      return;
+    std::fprintf(csv, "Material,Description,Density_gcm3,Transmission,Mu_cm1,MuRho_cm2g,Transmitted,Total,"
+                      "Thickness_cm,Mu_err_cm1,CI95_low,CI95_high\n");
+    for (const auto &entry : picked)
+    {
+      const Group &g = *entry.second;
+      // Transmisión del espesor más próximo a los 5 cm del análisis original
+      const Point *ref = &g.points.front();
+      for (const auto &p : g.points)
+        if (std::abs(p.x - 5.) < std::abs(ref->x - 5.))
+          ref = &p;
+      const KnownMaterial *known = FindKnown(g);
+      std::fprintf(csv, "%s,%s,%.2f,%.6f,%.6f,%.6f,%lld,%lld,%.1f,%.6f,%.6f,%.6f\n", entry.first.c_str(),
+                   known ? known->description : g.material.c_str(), g.density, ref->t, g.fit.mu,
+                   g.density > 0. ? g.fit.mu / g.density : 0., ref->k, ref->n, ref->x, g.fit.muErr, g.ciLow,
+                   g.ciHigh);
+    }
+    std::fclose(csv);
+  }
+
+  void WriteEnergy(const std::string &out, const std::vector<Group> &groups)
+  {
+    std::map<std::string, std::vector<const Group *>> byMaterial;
+    for (const auto &g : groups)
+      if (g.fit.ok && g.spectrum.compare(0, 5, "mono:") == 0)
+        byMaterial[ShortName(g)].push_back(&g);
+
+    for (auto &entry : byMaterial)
+    {
+      if (entry.second.size() < 2)
+        continue;
+      std::sort(entry.second.begin(), entry.second.end(),
+                [](const Group *a, const Group *b) { return a->energy < b->energy; });
+      std::string suffix = entry.first == "water" ? "" : "_" + entry.first;
+      std::string path = out + "/multi_energy/energy_mc" + suffix + ".csv";
+      FILE *csv = std::fopen(path.c_str(), "w");
+      if (!csv)
+        continue;
+      std::fprintf(csv, "Energy_keV,MuRho_cm2g,MuRho_err_cm2g,CI95_low_cm2g,CI95_high_cm2g,Mu_cm1,Points,Physics\n");
+      for (const Group *g : entry.second)
+      {
+        double rho = g->density > 0. ? g->density : 1.;
+        std::fprintf(csv, "%.3f,%.6f,%.6f,%.6f,%.6f,%.6f,%zu,\"%s\"\n", g->energy, g->fit.mu / rho,
+                     g->fit.muErr / rho, g->ciLow / rho, g->ciHigh / rho, g->fit.mu, g->points.size(),
+                     g->physics.c_str());
+      }
+      std::fclose(csv);
+    }
+  }
+
+  void Usage(const char *program)
+  {
+    std::cerr << "Uso: " << program << " [dir_resultados] [--store fichero]... [--out dir]"
+              << " [--bootstrap B] [--seed S] [-j N] [--quiet]" << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string resultsDir;
+  std::string outDir;
+  std::vector<std::string> storePaths;
+  int replicas = 1000;
+  unsigned long long seed = 12345;
+  int nThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  bool quiet = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--store" && hasValue)
+      storePaths.push_back(argv[++i]);
+    else if (arg == "--out" && hasValue)
+      outDir = argv[++i];
+    else if (arg == "--bootstrap" && hasValue)
+      replicas = std::atoi(argv[++i]);
+    else if (arg == "--seed" && hasValue)
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    else if ((arg == "-j" || arg == "--jobs") && hasValue)
+      nThreads = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--quiet")
+      quiet = true;
+    else if (!arg.empty() && arg[0] != '-' && resultsDir.empty())
+      resultsDir = arg;
+    else
+    {
+      Usage(argv[0]);
+      return 2;
+    }
+  }
+
+  // Sin directorio explícito se usa el almacén por defecto y su directorio
+  if (resultsDir.empty())
+  {
+    std::string path = ResultsStore::DefaultPath();
+    std::size_t slash = path.rfind('/');
+    resultsDir = slash == std::string::npos ? "." : path.substr(0, slash);
+    storePaths.insert(storePaths.begin(), path);
+  }
+  else
+    storePaths.insert(storePaths.begin(), resultsDir + "/store.tsv");
+  if (outDir.empty())
+    outDir = resultsDir;
+
+  auto start = std::chrono::steady_clock::now();
+
+  // Los almacenes se leen una sola vez; las claves repetidas entre ellos se descartan
+  std::vector<ResultsStore::Store> stores;
+  for (const auto &path : storePaths)
+  {
+    stores.emplace_back(path);
+    if (!stores.back().Load())
+    {
+      std::cerr << "No se pudo leer el almacén " << path << std::endl;
+      stores.pop_back();
+    }
+  }
+
+  std::map<std::string, std::size_t> groupIndex;
+  std::map<std::string, bool> seen;
+  std::vector<Group> groups;
+  for (const auto &store : stores)
+  {
+    for (const auto &record : store.GetRecords())
+    {
+      if (record.events <= 0 || !seen.emplace(record.key, true).second)
+        continue;
+      std::string id = record.material + "\t" + record.spectrum + "\t" + record.physics;
+      auto it = groupIndex.find(id);
+      if (it == groupIndex.end())
+      {
+        it = groupIndex.emplace(id, groups.size()).first;
+        Group g;
+        g.material = record.material;
+        g.label = record.label;
+        g.spectrum = record.spectrum;
+        g.physics = record.physics;
+        g.density = record.density;
+        groups.push_back(g);
+      }
+      groups[it->second].records.push_back(&record);
+    }
+  }
+  if (groups.empty())
+  {
+    std::cerr << "No hay runs que analizar" << std::endl;
+    return 1;
+  }
+  for (auto &g : groups)
+  {
+    double sum = 0.;
+    for (const auto *r : g.records)
+      sum += r->meanEnergy;
+    g.energy = sum / g.records.size();
+  }
+
+  // Reparto dinámico de los grupos entre hilos
+  std::atomic<std::size_t> next(0);
+  auto worker = [&]()
+  {
+    for (std::size_t i = next++; i < groups.size(); i = next++)
+      Analyze(groups[i], replicas, seed);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < std::min<int>(nThreads, static_cast<int>(groups.size())); ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &thread : pool)
+    thread.join();
+
+  for (const char *sub : {"/analysis", "/multi_thickness", "/multi_material", "/multi_energy"})
+  {
+    if (!MakeDirs(outDir + sub))
+    {
+      std::cerr << "No se pudo crear " << outDir << sub << std::endl;
+      return 1;
+    }
+  }
+  auto picked = Pick662(groups);
+  WriteGroups(outDir, groups);
+  WriteThickness(outDir, picked);
+  WriteMaterials(outDir, picked);
+  WriteEnergy(outDir, groups);
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (!quiet)
+  {
+    std::printf("%-24s %-16s %6s %10s %10s %21s %8s\n", "Material", "Espectro", "Ptos", "mu(cm-1)", "error",
+                "IC 95% bootstrap", "chi2/ndf");
+    for (const auto &g : groups)
+    {
+      if (!g.fit.ok)
+      {
+        std::printf("%-24s %-16s %6zu %10s\n", g.material.c_str(), g.spectrum.c_str(), g.points.size(),
+                    "sin ajuste");
+        continue;
+      }
+      std::printf("%-24s %-16s %6zu %10.5f %10.5f   [%8.5f, %8.5f] %8.3f\n", g.material.c_str(),
+                  g.spectrum.c_str(), g.points.size(), g.fit.mu, g.fit.muErr, g.ciLow, g.ciHigh,
+                  g.fit.ndf > 0 ? g.fit.chi2 / g.fit.ndf : 0.);
+    }
+    std::printf("%zu grupos analizados en %.3f s con %d hilos -> %s\n", groups.size(), elapsed,
+                std::min<int>(nThreads, static_cast<int>(groups.size())), outDir.c_str());
+  }
+  return 0;
+}
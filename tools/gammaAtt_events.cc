@@ -0,0 +1,138 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Convierte la salida binaria por evento (.gaev) a CSV o ROOT.
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Uso: gammaAtt-events event_data.gaev [--csv salida.csv] [--root salida.root]
+     Sin opciones escribe CSV por la salida estándar.
+*/
+#include "EventFile.hh"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef USE_ROOT
+#include "TFile.h"
+#include "TTree.h"
+#endif
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Uso: " << argv[0] << " fichero.gaev [--csv salida.csv] [--root salida.root]" << std::endl;
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string csvPath, rootPath;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csvPath = argv[++i];
+        else if (std::strcmp(argv[i], "--root") == 0 && i + 1 < argc)
+            rootPath = argv[++i];
+        else
+        {
+            std::cerr << "Opción desconocida: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    bool toStdout = csvPath.empty() && rootPath.empty();
+
+    EventFile::Reader reader(input);
+    if (!reader.IsOpen())
+    {
+        std::cerr << "ERROR: " << input << " no es un fichero .gaev válido" << std::endl;
+        return 1;
+    }
+
+    // --- Salida CSV ---
+    std::FILE *csv = nullptr;
+    if (toStdout)
+        csv = stdout;
+    else if (!csvPath.empty())
+    {
+        csv = std::fopen(csvPath.c_str(), "w");
+        if (!csv)
+        {
+            std::cerr << "ERROR: no se puede crear " << csvPath << std::endl;
+            return 1;
+        }
+    }
+    if (csv)
+    {
+        const auto &columns = reader.GetColumns();
+        for (std::size_t i = 0; i < columns.size(); ++i)
+            std::fprintf(csv, "%s%s", i ? "," : "", columns[i].name.c_str());
+        std::fprintf(csv, "\n");
+    }
+
+    // --- Salida ROOT ---
+#ifdef USE_ROOT
+    TFile *rootFile = nullptr;
+    TTree *tree = nullptr;
+    Int_t runID, eventID;
+    UChar_t detected;
+    Float_t edep, entryEnergy, primaryEnergy;
+    if (!rootPath.empty())
+    {
+        rootFile = new TFile(rootPath.c_str(), "RECREATE");
+        tree = new TTree("events", "Salida por evento");
+        tree->Branch("runID", &runID, "runID/I");
+        tree->Branch("eventID", &eventID, "eventID/I");
+        tree->Branch("detected", &detected, "detected/b");
+        tree->Branch("edep_keV", &edep, "edep_keV/F");
+        tree->Branch("entryEnergy_keV", &entryEnergy, "entryEnergy_keV/F");
+        tree->Branch("primaryEnergy_keV", &primaryEnergy, "primaryEnergy_keV/F");
+    }
+#else
+    if (!rootPath.empty())
+    {
+        std::cerr << "ERROR: gammaAtt-events compilado sin ROOT" << std::endl;
+        return 1;
+    }
+#endif
+
+    EventFile::Block block;
+    long long nEvents = 0;
+    while (reader.NextBlock(block))
+    {
+        for (std::size_t i = 0; i < block.Size(); ++i)
+        {
+            if (csv)
+                std::fprintf(csv, "%d,%d,%u,%g,%g,%g\n", block.runID[i], block.eventID[i],
+                             static_cast<unsigned>(block.detected[i]), block.edep[i],
+                             block.entryEnergy[i], block.primaryEnergy[i]);
+#ifdef USE_ROOT
+            if (tree)
+            {
+                runID = block.runID[i];
+                eventID = block.eventID[i];
+                detected = block.detected[i];
+                edep = block.edep[i];
+                entryEnergy = block.entryEnergy[i];
+                primaryEnergy = block.primaryEnergy[i];
+                tree->Fill();
+            }
+#endif
+        }
+        nEvents += block.Size();
+    }
+
+    if (csv && csv != stdout)
+        std::fclose(csv);
+#ifdef USE_ROOT
+    if (rootFile)
+    {
+        rootFile->cd();
+        tree->Write();
+        rootFile->Close();
+        delete rootFile;
+    }
+#endif
+
+    std::cerr << nEvents << " eventos leídos de " << input << std::endl;
+    return 0;
+}
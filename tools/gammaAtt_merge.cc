@@ -0,0 +1,129 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Fusiona los fragmentos de un run repartido con --shard i/N.
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Uso: gammaAtt-merge [--store fichero] [--partial] [--check] fragmento.gashard...
+
+Lee los fragmentos uno a uno (en memoria solo las sumas acumuladas y el
+fragmento en curso) y escribe las mismas salidas que el run en un solo
+proceso: almacén, results_summary.txt, CSV por energía, espectro del
+detector y capas, malla y árbol ROOT.
+
+Se niega a fusionar si algún fragmento tiene otra configuración (material,
+espesor, fuente, física, semilla, run, eventos, tallies o número de
+fragmentos), si un fragmento está repetido o si falta alguno (salvo con
+--partial, que da el resultado de los eventos disponibles).
+--check solo comprueba los fragmentos, sin escribir nada.
+*/
+#include "RunTotals.hh"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  void Usage(const char *program)
+  {
+    std::cerr << "Uso: " << program << " [--store fichero] [--partial] [--check] fragmento.gashard..." << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string storePath = ResultsStore::DefaultPath();
+  bool partial = false, checkOnly = false;
+  std::vector<std::string> paths;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--store" && i + 1 < argc)
+      storePath = argv[++i];
+    else if (arg == "--partial")
+      partial = true;
+    else if (arg == "--check")
+      checkOnly = true;
+    else if (!arg.empty() && arg[0] == '-')
+    {
+      Usage(argv[0]);
+      return 2;
+    }
+    else
+      paths.push_back(arg);
+  }
+  if (paths.empty())
+  {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  RunTotals::Totals merged, shard;
+  std::vector<std::string> seen; // Fichero de cada índice de fragmento
+  std::string error;
+  for (std::size_t i = 0; i < paths.size(); ++i)
+  {
+    if (!RunTotals::Load(paths[i], shard, error))
+    {
+      std::cerr << "Error: " << error << std::endl;
+      return 1;
+    }
+    if (shard.shards < 1 || shard.shard < 0 || shard.shard >= shard.shards)
+    {
+      std::cerr << "Error: " << paths[i] << " no es un fragmento de --shard" << std::endl;
+      return 1;
+    }
+
+    if (i == 0)
+    {
+      merged = shard;
+      seen.assign(shard.shards, "");
+    }
+    else if (!RunTotals::Add(merged, shard, error))
+    {
+      std::cerr << "Error: " << paths[i] << " no es del mismo run que " << paths[0] << " (" << error
+                << " distinto)" << std::endl;
+      return 1;
+    }
+
+    if (!seen[shard.shard].empty())
+    {
+      std::cerr << "Error: el fragmento " << shard.shard << " aparece dos veces (" << seen[shard.shard] << ", "
+                << paths[i] << ")" << std::endl;
+      return 1;
+    }
+    seen[shard.shard] = paths[i];
+  }
+
+  std::vector<int> missing;
+  for (std::size_t i = 0; i < seen.size(); ++i)
+    if (seen[i].empty())
+      missing.push_back(static_cast<int>(i));
+  if (!missing.empty())
+  {
+    std::cerr << (partial ? "Aviso" : "Error") << ": faltan " << missing.size() << " de " << seen.size()
+              << " fragmentos:";
+    for (int index : missing)
+      std::cerr << " " << index;
+    std::cerr << std::endl;
+    if (!partial)
+      return 1;
+    // El resultado parcial no es el run pedido: no comparte su clave en el almacén
+    merged.record.requested = merged.shardEvents;
+    if (!merged.rootUpdate)
+      merged.rootFile = RunTotals::RunRootFile(merged.record);
+  }
+
+  RunTotals::Results results = RunTotals::Compute(merged);
+  std::cout << "=== Run " << merged.runID << " (" << paths.size() << " de " << seen.size() << " fragmentos) ===\n"
+            << "Material: " << merged.record.label << ", " << merged.record.thickness << " cm, "
+            << merged.record.spectrum << "\n"
+            << "Eventos: " << merged.events << " de " << merged.record.requested << "\n"
+            << "Transmisión: " << results.transmission << " (" << merged.transmitted << " transmitidos)\n"
+            << "Coeficiente de atenuación: " << results.mu << " cm^-1 (error relativo " << results.relError << ")\n"
+            << "Tiempo total de los fragmentos: " << merged.realTime << " s" << std::endl;
+  if (checkOnly)
+    return 0;
+
+  return RunTotals::WriteOutputs(merged, storePath) ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Consulta el almacén de resultados (results/store.tsv).
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Uso: gammaAtt-results [--store fichero] list  [filtros] [--csv]
+     gammaAtt-results [--store fichero] count [filtros]
+     gammaAtt-results [--store fichero] get clave
+
+Filtros: --material M   (nombre G4 o el pedido en /detector/setMaterial)
+         --thickness T  (cm)
+         --energy E     (keV, energía media del haz con tolerancia del 0.5 %)
+         --spectrum S   (etiqueta exacta, p. ej. mono:662keV)
+         --min-events N
+'count' devuelve 1 si no hay ningún run que cumpla los filtros, de modo que
+los scripts pueden usarlo para decidir si un punto ya está hecho.
+*/
+#include "ResultsStore.hh"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+  struct Filter
+  {
+    std::string material;
+    std::string spectrum;
+    double thickness = -1.;
+    double energy = -1.;
+    long long minEvents = 0;
+
+    bool Accept(const ResultsStore::Record &r) const
+    {
+      if (!material.empty() && r.material != material && r.label != material)
+        return false;
+      if (!spectrum.empty() && r.spectrum != spectrum)
+        return false;
+      if (thickness >= 0. && std::abs(r.thickness - thickness) > 1e-6 * std::max(1., thickness))
+        return false;
+      if (energy > 0. && std::abs(r.meanEnergy - energy) > 5e-3 * energy)
+        return false;
+      return r.events >= minEvents;
+    }
+  };
+
+  void PrintRecord(const ResultsStore::Record &r, char sep)
+  {
+    std::cout << r.key << sep << r.timestamp << sep << r.material << sep << r.label << sep << r.density
+              << sep << r.thickness << sep << r.spectrum << sep << r.physics << sep << r.seed << sep
+              << r.requested << sep << r.events << sep << r.transmitted << sep << r.transmission << sep
+              << r.mu << sep << r.relError << sep << r.meanEnergy << sep << r.fom << sep << r.uncollided
+              << sep << r.muNarrow << sep << r.narrowRelError << sep << r.buildup << "\n";
+  }
+
+  void PrintHeader(char sep)
+  {
+    const auto &columns = ResultsStore::Columns();
+    for (std::size_t i = 0; i < columns.size(); ++i)
+      std::cout << (i ? std::string(1, sep) : "") << columns[i];
+    std::cout << "\n";
+  }
+
+  void Usage(const char *program)
+  {
+    std::cerr << "Uso: " << program << " [--store fichero] list|count [filtros] [--csv]\n"
+              << "     " << program << " [--store fichero] get clave" << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string storePath = ResultsStore::DefaultPath();
+  std::string command, key;
+  Filter filter;
+  char sep = '\t';
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--store" && hasValue)
+      storePath = argv[++i];
+    else if (arg == "--material" && hasValue)
+      filter.material = argv[++i];
+    else if (arg == "--thickness" && hasValue)
+      filter.thickness = std::atof(argv[++i]);
+    else if (arg == "--energy" && hasValue)
+      filter.energy = std::atof(argv[++i]);
+    else if (arg == "--spectrum" && hasValue)
+      filter.spectrum = argv[++i];
+    else if (arg == "--min-events" && hasValue)
+      filter.minEvents = std::atoll(argv[++i]);
+    else if (arg == "--csv")
+      sep = ',';
+    else if (command.empty() && (arg == "list" || arg == "count" || arg == "get"))
+      command = arg;
+    else if (command == "get" && key.empty())
+      key = arg;
+    else
+    {
+      Usage(argv[0]);
+      return 2;
+    }
+  }
+  if (command.empty() || (command == "get" && key.empty()))
+  {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  ResultsStore::Store store(storePath);
+  if (!store.Load())
+  {
+    // Un almacén que aún no existe equivale a uno vacío
+    if (command == "count")
+      std::cout << 0 << std::endl;
+    else
+      std::cerr << "Almacén vacío o inexistente: " << storePath << std::endl;
+    return 1;
+  }
+
+  if (command == "get")
+  {
+    const ResultsStore::Record *record = store.Find(key);
+    if (!record)
+    {
+      std::cerr << "Clave no encontrada: " << key << std::endl;
+      return 1;
+    }
+    PrintHeader(sep);
+    PrintRecord(*record, sep);
+    return 0;
+  }
+
+  long long matches = 0;
+  if (command == "list")
+    PrintHeader(sep);
+  for (const auto &record : store.GetRecords())
+  {
+    if (!filter.Accept(record))
+      continue;
+    ++matches;
+    if (command == "list")
+      PrintRecord(record, sep);
+  }
+  if (command == "count")
+    std::cout << matches << std::endl;
+  return matches > 0 ? 0 : 1;
+}
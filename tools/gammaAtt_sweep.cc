@@ -0,0 +1,552 @@
+/* ------- GAMMA ATTENUATION SIMULATION -------
+Orquestador de barridos en varios procesos.
+Autor: @isabelnieto900, @PoPPop21
+Fecha: Octubre 2025
+-----------------------------------------------
+Uso: gammaAtt-sweep barrido.mac [-j N] [-t T] [--dir directorio] [--exe gammaAtt_batch] [--dry-run]
+
+El fichero de barrido usa los mismos comandos /sweep/... que el barrido en
+un solo proceso (ver mac/sweep_example.mac): /sweep/materials,
+/sweep/thicknesses, /sweep/energies, /sweep/events y /sweep/precision. El
+resto de líneas (verbosidad, /run/initialize, /fast/..., /source/...) se
+copian tal cual al principio de la macro de cada punto.
+
+Cada punto se ejecuta como un proceso gammaAtt_batch independiente en su
+propio directorio (<dir>/points/<id>), de modo que los ficheros ROOT y de
+texto de dos puntos nunca se pisan; todos escriben en el mismo almacén de
+resultados. Hay N procesos a la vez y cada uno toma el siguiente punto de
+la cola en cuanto acaba el anterior, empezando por los más costosos.
+
+El diario <dir>/journal.tsv registra el inicio y el final de cada punto con
+escrituras atómicas (O_APPEND + fsync). Un punto solo está hecho si su línea
+'done' existe, lo que exige que el proceso terminara con código 0 y que su
+resultado esté en el almacén: al relanzar el mismo comando tras una interrupción se repiten solo los puntos
+sin 'done', y nunca se da por buena una salida a medio escribir.
+*/
+#include "ResultsStore.hh"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  struct SweepSpec
+  {
+    std::vector<std::string> setup; // Líneas que no son /sweep/...
+    std::vector<std::string> materials;
+    std::vector<double> thicknesses; // cm
+    std::vector<double> energies;    // keV
+    long events = 100000;
+    double precision = 0.;
+  };
+
+  struct Point
+  {
+    std::string id;
+    std::string material;
+    double thickness = 0.; // cm
+    double energy = 0.;    // keV
+    double cost = 0.;      // Estimación relativa para ordenar la cola
+  };
+
+  volatile std::sig_atomic_t interrupted = 0;
+
+  void OnSignal(int) { interrupted = 1; }
+
+  double Now()
+  {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+  }
+
+  std::string Trim(const std::string &text)
+  {
+    std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+      return "";
+    std::size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+  }
+
+  // Lista de números con unidad final opcional, convertida a la unidad base
+  bool ParseValues(std::istringstream &is, const std::map<std::string, double> &units,
+                   std::vector<double> &values)
+  {
+    std::string token;
+    std::vector<double> raw;
+    double scale = 1.;
+    while (is >> token)
+    {
+      auto unit = units.find(token);
+      if (unit != units.end())
+      {
+        scale = unit->second;
+        break;
+      }
+      char *end = nullptr;
+      double value = std::strtod(token.c_str(), &end);
+      if (end == token.c_str() || *end != '\0')
+        return false;
+      raw.push_back(value);
+    }
+    for (double value : raw)
+      values.push_back(value * scale);
+    return !values.empty();
+  }
+
+  bool ReadSpec(const std::string &path, SweepSpec &spec)
+  {
+    std::ifstream in(path);
+    if (!in)
+    {
+      std::cerr << "ERROR: no se puede leer " << path << std::endl;
+      return false;
+    }
+
+    const std::map<std::string, double> lengthUnits = {{"mm", 0.1}, {"cm", 1.}, {"m", 100.}};
+    const std::map<std::string, double> energyUnits = {{"eV", 1e-3}, {"keV", 1.}, {"MeV", 1e3}};
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+      std::string trimmed = Trim(line);
+      if (trimmed.compare(0, 7, "/sweep/") != 0)
+      {
+        if (!trimmed.empty() && trimmed[0] != '#')
+          spec.setup.push_back(trimmed);
+        continue;
+      }
+
+      std::istringstream is(trimmed);
+      std::string command;
+      is >> command;
+      bool ok = true;
+      if (command == "/sweep/materials")
+      {
+        std::string material;
+        while (is >> material)
+          spec.materials.push_back(material);
+      }
+      else if (command == "/sweep/thicknesses")
+        ok = ParseValues(is, lengthUnits, spec.thicknesses);
+      else if (command == "/sweep/energies")
+        ok = ParseValues(is, energyUnits, spec.energies);
+      else if (command == "/sweep/events")
+        ok = static_cast<bool>(is >> spec.events);
+      else if (command == "/sweep/precision")
+        ok = static_cast<bool>(is >> spec.precision);
+      // /sweep/output y /sweep/run no tienen sentido aquí: cada punto es un proceso
+
+      if (!ok)
+      {
+        std::cerr << "ERROR: línea no válida en " << path << ": " << trimmed << std::endl;
+        return false;
+      }
+    }
+
+    if (spec.materials.empty() || spec.thicknesses.empty() || spec.energies.empty())
+    {
+      std::cerr << "ERROR: faltan /sweep/materials, /sweep/thicknesses o /sweep/energies" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Coste relativo aproximado: eventos x (espesor másico + 1). Solo ordena la
+  // cola; el reparto real es dinámico, así que un error de estimación solo
+  // retrasa un poco el final
+  double EstimateCost(const std::string &material, double thickness, long events)
+  {
+    static const std::map<std::string, double> densities = {
+        {"water", 1.0}, {"G4_WATER", 1.0}, {"muscle", 1.05}, {"bone", 1.92},
+        {"lead", 11.35}, {"G4_Pb", 11.35}, {"concrete", 2.3}, {"G4_CONCRETE", 2.3}};
+    auto it = densities.find(material);
+    double density = it != densities.end() ? it->second : 1.;
+    return static_cast<double>(events) * (thickness * density + 1.);
+  }
+
+  std::string FormatNumber(double value)
+  {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+  }
+
+  std::vector<Point> BuildPoints(const SweepSpec &spec)
+  {
+    std::vector<Point> points;
+    for (const auto &material : spec.materials)
+      for (double thickness : spec.thicknesses)
+        for (double energy : spec.energies)
+        {
+          Point point;
+          point.material = material;
+          point.thickness = thickness;
+          point.energy = energy;
+          point.id = ResultsStore::Hash(material + "|" + FormatNumber(thickness) + "|" + FormatNumber(energy))
+                         .substr(0, 12);
+          point.cost = EstimateCost(material, thickness, spec.events);
+          points.push_back(point);
+        }
+    return points;
+  }
+
+  std::string SpecHash(const SweepSpec &spec)
+  {
+    std::ostringstream os;
+    for (const auto &line : spec.setup)
+      os << line << "\n";
+    os << spec.events << " " << spec.precision << "\n";
+    return ResultsStore::Hash(os.str());
+  }
+
+  // Macro del punto: configuración común y, después, el punto concreto
+  std::string WriteMacro(const fs::path &dir, const SweepSpec &spec, const Point &point)
+  {
+    // Semillas fijas por punto: el mismo barrido da los mismos resultados
+    unsigned long long hash = std::stoull(point.id, nullptr, 16);
+    long seed1 = static_cast<long>(hash & 0x7fffffff);
+    long seed2 = static_cast<long>((hash >> 31) & 0x7fffffff);
+
+    fs::path macro = dir / "point.mac";
+    std::ofstream out(macro);
+    out << "# gammaAtt-sweep: " << point.material << " " << point.thickness << " cm " << point.energy
+        << " keV\n";
+    for (const auto &line : spec.setup)
+      out << line << "\n";
+    out << "/random/setSeeds " << seed1 << " " << seed2 << "\n";
+    out << "/detector/setMaterial " << point.material << "\n";
+    out << "/detector/setThickness " << point.thickness << " cm\n";
+    out << "/gun/energy " << point.energy << " keV\n";
+    if (spec.precision > 0.)
+      out << "/run/beamToPrecision " << spec.precision << " " << spec.events << "\n";
+    else
+      out << "/run/beamOn " << spec.events << "\n";
+    return macro.string();
+  }
+
+  // El proceso del punto terminó bien: comprueba además que su run está en el
+  // almacén (escrito después de 'since', con el material, espesor, eventos y,
+  // si la fuente es monoenergética, la energía del punto)
+  bool HasRecord(const std::string &store, const SweepSpec &spec, const Point &point, long long since)
+  {
+    ResultsStore::Store results(store);
+    if (!results.Load())
+      return false;
+    const std::string mono = "mono:" + FormatNumber(point.energy) + "keV";
+    for (const auto &record : results.GetRecords())
+    {
+      if (record.timestamp < since || record.label != point.material || record.requested != spec.events)
+        continue;
+      if (std::fabs(record.thickness - point.thickness) > 1e-6 * std::max(1., point.thickness))
+        continue;
+      if (record.spectrum.compare(0, 5, "mono:") == 0 && record.spectrum != mono)
+        continue;
+      return true;
+    }
+    return false;
+  }
+
+  // Diario de solo añadir: cada línea se escribe entera y se sincroniza
+  class Journal
+  {
+  public:
+    explicit Journal(const fs::path &path) : fd(::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644)) {}
+    ~Journal()
+    {
+      if (fd >= 0)
+        ::close(fd);
+    }
+    bool IsOpen() const { return fd >= 0; }
+
+    void Write(const std::string &line)
+    {
+      std::string text = line + "\n";
+      const char *data = text.data();
+      std::size_t left = text.size();
+      while (left > 0)
+      {
+        ssize_t written = ::write(fd, data, left);
+        if (written < 0 && errno == EINTR)
+          continue;
+        if (written < 0)
+          return;
+        data += written;
+        left -= static_cast<std::size_t>(written);
+      }
+      ::fsync(fd);
+    }
+
+  private:
+    int fd;
+  };
+
+  // Lee el diario: hash del barrido y puntos terminados
+  bool ReadJournal(const fs::path &path, std::string &specHash, std::set<std::string> &done)
+  {
+    std::ifstream in(path);
+    if (!in)
+      return false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+      std::istringstream is(line);
+      std::string kind, value;
+      std::getline(is, kind, '\t');
+      std::getline(is, value, '\t');
+      if (kind == "spec")
+        specHash = value;
+      else if (kind == "done")
+        done.insert(value);
+    }
+    return true;
+  }
+
+  pid_t Launch(const std::string &exe, const std::string &macro, const fs::path &pointDir, int threads,
+               const std::string &store, const std::string &cache)
+  {
+    fs::path runDir = pointDir / "run";
+    fs::create_directories(runDir);
+    fs::create_directories(pointDir / "results");
+
+    pid_t pid = ::fork();
+    if (pid != 0)
+      return pid;
+
+    // Hijo: directorio propio, salida al log y almacén/caché compartidos
+    if (::chdir(runDir.c_str()) != 0)
+      ::_exit(126);
+    int log = ::open((pointDir / "log.txt").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log >= 0)
+    {
+      ::dup2(log, STDOUT_FILENO);
+      ::dup2(log, STDERR_FILENO);
+      ::close(log);
+    }
+    ::setenv("GAMMAATT_STORE", store.c_str(), 1);
+    ::setenv("GAMMAATT_PHYSICS_CACHE", cache.c_str(), 1);
+
+    std::string threadArg = std::to_string(threads);
+    std::vector<char *> args = {const_cast<char *>(exe.c_str()), const_cast<char *>(macro.c_str())};
+    if (threads > 0)
+    {
+      args.push_back(const_cast<char *>("-t"));
+      args.push_back(const_cast<char *>(threadArg.c_str()));
+    }
+    args.push_back(nullptr);
+    ::execv(exe.c_str(), args.data());
+    ::_exit(127);
+  }
+
+  void Usage(const char *program)
+  {
+    std::cerr << "Uso: " << program
+              << " barrido.mac [-j N] [-t T] [--dir directorio] [--exe gammaAtt_batch] [--dry-run]" << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string specPath, sweepDir, exe;
+  int jobs = static_cast<int>(std::max(1L, ::sysconf(_SC_NPROCESSORS_ONLN)));
+  int threads = 0;
+  bool dryRun = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "-j" && hasValue)
+      jobs = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "-t" && hasValue)
+      threads = std::max(0, std::atoi(argv[++i]));
+    else if (arg == "--dir" && hasValue)
+      sweepDir = argv[++i];
+    else if (arg == "--exe" && hasValue)
+      exe = argv[++i];
+    else if (arg == "--dry-run")
+      dryRun = true;
+    else if (specPath.empty() && arg[0] != '-')
+      specPath = arg;
+    else
+    {
+      Usage(argv[0]);
+      return 2;
+    }
+  }
+  if (specPath.empty())
+  {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  SweepSpec spec;
+  if (!ReadSpec(specPath, spec))
+    return 2;
+
+  // Por defecto, gammaAtt_batch del mismo directorio que este programa
+  if (exe.empty())
+    exe = (fs::path(argv[0]).parent_path() / "gammaAtt_batch").string();
+  exe = fs::absolute(exe).string();
+  if (sweepDir.empty())
+    sweepDir = "../results/sweeps/" + fs::path(specPath).stem().string();
+  fs::path dir = fs::absolute(sweepDir).lexically_normal();
+  std::string store = fs::absolute(ResultsStore::DefaultPath()).lexically_normal().string();
+  const char *cacheEnv = std::getenv("GAMMAATT_PHYSICS_CACHE");
+  std::string cache = fs::absolute(cacheEnv ? cacheEnv : "../cache/physics").lexically_normal().string();
+
+  std::vector<Point> points = BuildPoints(spec);
+  std::string specHash = SpecHash(spec);
+
+  // --- Reanudación: el diario dice qué puntos ya terminaron ---
+  fs::create_directories(dir / "points");
+  fs::path journalPath = dir / "journal.tsv";
+  std::string journalSpec;
+  std::set<std::string> done;
+  bool resuming = ReadJournal(journalPath, journalSpec, done);
+  if (resuming && !journalSpec.empty() && journalSpec != specHash)
+  {
+    std::cerr << "ERROR: " << dir << " pertenece a otro barrido (la configuración común o los eventos"
+              << " han cambiado). Usa otro --dir." << std::endl;
+    return 2;
+  }
+
+  std::vector<Point> queue;
+  for (const auto &point : points)
+    if (!done.count(point.id))
+      queue.push_back(point);
+  // Los más caros primero: los baratos rellenan los huecos del final
+  std::stable_sort(queue.begin(), queue.end(), [](const Point &a, const Point &b) { return a.cost > b.cost; });
+
+  std::cout << "=== gammaAtt-sweep: " << points.size() << " puntos, " << done.size() << " ya hechos, "
+            << queue.size() << " pendientes, " << jobs << " procesos ===" << std::endl;
+  std::cout << "Directorio: " << dir.string() << "\nAlmacén: " << store << std::endl;
+
+  if (dryRun)
+  {
+    for (const auto &point : queue)
+      std::cout << "  " << point.id << "  " << point.material << " " << point.thickness << " cm "
+                << point.energy << " keV" << std::endl;
+    return 0;
+  }
+  if (queue.empty())
+    return 0;
+
+  Journal journal(journalPath);
+  if (!journal.IsOpen())
+  {
+    std::cerr << "ERROR: no se puede escribir " << journalPath << std::endl;
+    return 2;
+  }
+  if (journalSpec.empty())
+    journal.Write("spec\t" + specHash);
+
+  // Sin SA_RESTART: waitpid() vuelve con EINTR y se avisa a los hijos enseguida
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = OnSignal;
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+
+  struct Running
+  {
+    Point point;
+    double start;
+    long long launched; // s desde epoch, para buscar el run en el almacén
+  };
+  std::map<pid_t, Running> running;
+  std::size_t next = 0, finished = 0, failed = 0;
+  double sweepStart = Now();
+
+  while (next < queue.size() || !running.empty())
+  {
+    // Rellenar los huecos libres con el siguiente punto de la cola
+    while (!interrupted && next < queue.size() && static_cast<int>(running.size()) < jobs)
+    {
+      const Point &point = queue[next++];
+      fs::path pointDir = dir / "points" / point.id;
+      fs::create_directories(pointDir);
+      std::string macro = WriteMacro(pointDir, spec, point);
+      long long launched = static_cast<long long>(std::time(nullptr));
+      journal.Write("start\t" + point.id + "\t" + point.material + "\t" + FormatNumber(point.thickness) +
+                    "\t" + FormatNumber(point.energy));
+      pid_t pid = Launch(exe, macro, pointDir, threads, store, cache);
+      if (pid < 0)
+      {
+        std::cerr << "ERROR: fork falló: " << std::strerror(errno) << std::endl;
+        interrupted = 1;
+        break;
+      }
+      running[pid] = {point, Now(), launched};
+    }
+    if (running.empty())
+      break;
+
+    int status = 0;
+    pid_t pid = ::waitpid(-1, &status, 0);
+    if (pid < 0)
+    {
+      if (errno == EINTR)
+      {
+        // Interrupción: se avisa a los hijos; sus puntos quedan sin 'done'
+        for (const auto &entry : running)
+          ::kill(entry.first, SIGTERM);
+        continue;
+      }
+      break;
+    }
+    auto it = running.find(pid);
+    if (it == running.end())
+      continue;
+
+    const Point &point = it->second.point;
+    double elapsed = Now() - it->second.start;
+    bool exited = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    bool ok = exited && HasRecord(store, spec, point, it->second.launched);
+    ++finished;
+    if (ok)
+      journal.Write("done\t" + point.id + "\t" + FormatNumber(elapsed));
+    else
+    {
+      ++failed;
+      // Código de salida, señal (negativa) o "norecord" si no llegó al almacén
+      std::string code = !WIFEXITED(status) ? std::to_string(-WTERMSIG(status))
+                         : exited           ? std::string("norecord")
+                                            : std::to_string(WEXITSTATUS(status));
+      journal.Write("fail\t" + point.id + "\t" + code);
+    }
+
+    double rate = finished / (Now() - sweepStart);
+    double eta = rate > 0. ? (queue.size() - finished) / rate : 0.;
+    std::printf("[%zu/%zu] %-10s %6.2f cm %8.1f keV: %7.1f s %s%s  (ETA %.0f s)\n", finished, queue.size(),
+                point.material.c_str(), point.thickness, point.energy, elapsed,
+                ok ? "ok" : "FALLO, ver points/", ok ? "" : (point.id + "/log.txt").c_str(), eta);
+    std::fflush(stdout);
+    running.erase(it);
+  }
+
+  std::cout << "=== " << finished - failed << " puntos completados, " << failed << " fallidos en "
+            << Now() - sweepStart << " s ===" << std::endl;
+  if (interrupted)
+    std::cout << "Interrumpido: vuelve a lanzar el mismo comando para continuar" << std::endl;
+  return (failed > 0 || interrupted) ? 1 : 0;
+}